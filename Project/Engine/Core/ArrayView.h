@@ -0,0 +1,26 @@
+// ArrayView.h
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Read-only view of contiguous elements (std::span stand-in, the project is C++17).
+// Doesn't own anything: whoever hands one out keeps the storage alive.
+template <class T>
+class ArrayView {
+public:
+    ArrayView() = default;
+    ArrayView(const T* data, size_t size) : m_Data(data), m_Size(size) {}
+    ArrayView(const std::vector<T>& v) : m_Data(v.data()), m_Size(v.size()) {}
+
+    const T* data() const { return m_Data; }
+    size_t size() const { return m_Size; }
+    bool empty() const { return m_Size == 0; }
+
+    const T* begin() const { return m_Data; }
+    const T* end() const { return m_Data + m_Size; }
+    const T& operator[](size_t i) const { return m_Data[i]; }
+
+private:
+    const T* m_Data = nullptr;
+    size_t m_Size = 0;
+};
@@ -0,0 +1,268 @@
+// AssetArchive.cpp
+#include "AssetArchive.h"
+#include <Engine/Core/MappedFile.h>
+#include <Engine/Core/Hash.h>
+#include <lz4.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+
+namespace {
+    constexpr uint64_t kPayloadAlignment = 64;
+
+    bool NameLess(const std::string& a, const std::string& b) {
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(),
+            [](unsigned char x, unsigned char y) { return std::tolower(x) < std::tolower(y); });
+    }
+
+    bool NameEquals(const char* a, size_t aLen, const std::string& b) {
+        if (aLen != b.size()) return false;
+        for (size_t i = 0; i < aLen; ++i)
+            if (std::tolower((unsigned char)a[i]) != std::tolower((unsigned char)b[i])) return false;
+        return true;
+    }
+}
+
+struct AssetArchive::Mounted {
+    std::string path;
+    MappedFile file;
+    const PackEntry* entries = nullptr;
+    uint32_t count = 0;
+    const char* names = nullptr;
+};
+
+std::string AssetArchive::NormalizePath(const std::string& path) {
+    std::string s = path;
+    std::replace(s.begin(), s.end(), '\\', '/');
+    while (s.rfind("./", 0) == 0) s.erase(0, 2);
+    return s;
+}
+
+bool AssetArchive::mount(const std::string& path) {
+    auto m = std::make_shared<Mounted>();
+    m->path = path;
+    if (!m->file.open(path)) return false;
+
+    const uint8_t* base = m->file.data();
+    const size_t size = m->file.size();
+    PackHeader h;
+    if (size < sizeof(h)) {
+        std::cerr << "[AssetArchive] \"" << path << "\" is too small\n";
+        return false;
+    }
+    std::memcpy(&h, base, sizeof(h));
+    if (std::memcmp(h.magic, kMagic, 4) != 0 || h.version != kVersion) {
+        std::cerr << "[AssetArchive] \"" << path << "\" is not a version " << kVersion << " archive\n";
+        return false;
+    }
+    const uint64_t tocBytes = uint64_t(h.entryCount) * sizeof(PackEntry);
+    if (h.tocOffset % alignof(PackEntry) != 0 || h.tocOffset + tocBytes > size || h.namesOffset + h.namesSize > size) {
+        std::cerr << "[AssetArchive] \"" << path << "\" has a damaged table of contents\n";
+        return false;
+    }
+
+    // The mapping is page aligned and tocOffset 8-byte aligned, so the TOC is used in place
+    m->entries = reinterpret_cast<const PackEntry*>(base + h.tocOffset);
+    m->count = h.entryCount;
+    m->names = reinterpret_cast<const char*>(base + h.namesOffset);
+    for (uint32_t i = 0; i < m->count; ++i) {
+        const PackEntry& e = m->entries[i];
+        if (e.offset + e.storedSize > size || uint64_t(e.nameOffset) + e.nameLength > h.namesSize) {
+            std::cerr << "[AssetArchive] \"" << path << "\" has a damaged entry\n";
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_mounted = std::move(m);
+    std::cout << "[AssetArchive] mounted \"" << path << "\" (" << h.entryCount << " entries)\n";
+    return true;
+}
+
+void AssetArchive::unmount() {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_mounted.reset();
+}
+
+bool AssetArchive::isMounted() const {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_mounted != nullptr;
+}
+
+size_t AssetArchive::entryCount() const {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_mounted ? m_mounted->count : 0;
+}
+
+AssetData AssetArchive::find(const std::string& path) const {
+    std::shared_ptr<const Mounted> m;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m = m_mounted;
+    }
+    if (!m || path.empty()) return {};
+
+    const std::string name = NormalizePath(path);
+    const uint64_t hash = Hash::Path(name);
+    const PackEntry* end = m->entries + m->count;
+    const PackEntry* it = std::lower_bound(m->entries, end, hash,
+        [](const PackEntry& e, uint64_t h) { return e.pathHash < h; });
+
+    for (; it != end && it->pathHash == hash; ++it) {
+        if (!NameEquals(m->names + it->nameOffset, it->nameLength, name)) continue;
+
+        const uint8_t* stored = m->file.data() + it->offset;
+        AssetData out;
+        if (it->compression == static_cast<uint32_t>(Compression::None)) {
+            out.owner = std::shared_ptr<const void>(m, stored);
+            out.data = stored;
+            out.size = static_cast<size_t>(it->size);
+            return out;
+        }
+
+        auto buffer = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(it->size));
+        const int n = LZ4_decompress_safe(reinterpret_cast<const char*>(stored), reinterpret_cast<char*>(buffer->data()),
+            static_cast<int>(it->storedSize), static_cast<int>(it->size));
+        if (n < 0 || static_cast<uint64_t>(n) != it->size) {
+            std::cerr << "[AssetArchive] \"" << name << "\" is corrupt in \"" << m->path << "\"\n";
+            return {};
+        }
+        out.data = buffer->data();
+        out.size = buffer->size();
+        out.owner = std::move(buffer);
+        return out;
+    }
+    return {};
+}
+
+AssetData AssetArchive::Open(const std::string& path) {
+    AssetData out = GetInstance().find(path);
+    if (out) return out;
+
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path)) return {};
+    out.data = file->data();
+    out.size = file->size();
+    out.owner = std::move(file);
+    return out;
+}
+
+bool AssetArchive::Build(const std::string& archivePath,
+    const std::vector<std::pair<std::string, std::string>>& files,
+    bool compress)
+{
+    struct Item {
+        std::string name;
+        std::string source;
+        PackEntry entry{};
+    };
+    std::vector<Item> items;
+    items.reserve(files.size());
+    for (const auto& [name, source] : files)
+        items.push_back({ NormalizePath(name), source });
+
+    // Payload order by name, TOC order by hash: both independent of the input order
+    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) { return NameLess(a.name, b.name); });
+    for (size_t i = 1; i < items.size(); ++i) {
+        if (!NameLess(items[i - 1].name, items[i].name)) {
+            std::cerr << "[AssetArchive] duplicate entry \"" << items[i].name << "\"\n";
+            return false;
+        }
+    }
+
+    const std::string tmpPath = archivePath + ".tmp";
+    std::error_code ec;
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "[AssetArchive] cannot write \"" << tmpPath << "\"\n";
+            return false;
+        }
+
+        uint64_t offset = 0;
+        auto write = [&](const void* data, size_t size) {
+            out.write(static_cast<const char*>(data), std::streamsize(size));
+            offset += size;
+        };
+        auto pad = [&](uint64_t alignment) {
+            static const char zeros[kPayloadAlignment] = {};
+            write(zeros, static_cast<size_t>((alignment - offset % alignment) % alignment));
+        };
+
+        PackHeader h{};
+        write(&h, sizeof(h)); // rewritten at the end
+
+        std::string names;
+        std::vector<char> packed;
+        for (Item& item : items) {
+            std::ifstream in(item.source, std::ios::binary | std::ios::ate);
+            if (!in) {
+                std::cerr << "[AssetArchive] cannot read \"" << item.source << "\"\n";
+                out.close();
+                std::filesystem::remove(tmpPath, ec);
+                return false;
+            }
+            std::vector<char> raw(static_cast<size_t>(in.tellg()));
+            in.seekg(0);
+            in.read(raw.data(), std::streamsize(raw.size()));
+
+            const char* payload = raw.data();
+            size_t payloadSize = raw.size();
+            item.entry.compression = static_cast<uint32_t>(Compression::None);
+            if (compress && !raw.empty() && raw.size() <= LZ4_MAX_INPUT_SIZE) {
+                packed.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(raw.size()))));
+                const int n = LZ4_compress_default(raw.data(), packed.data(), static_cast<int>(raw.size()), static_cast<int>(packed.size()));
+                if (n > 0 && size_t(n) <= raw.size() - raw.size() / 8) {
+                    payload = packed.data();
+                    payloadSize = static_cast<size_t>(n);
+                    item.entry.compression = static_cast<uint32_t>(Compression::LZ4);
+                }
+            }
+
+            pad(kPayloadAlignment);
+            item.entry.pathHash = Hash::Path(item.name);
+            item.entry.offset = offset;
+            item.entry.storedSize = payloadSize;
+            item.entry.size = raw.size();
+            item.entry.nameOffset = static_cast<uint32_t>(names.size());
+            item.entry.nameLength = static_cast<uint32_t>(item.name.size());
+            names += item.name;
+            write(payload, payloadSize);
+        }
+
+        std::vector<PackEntry> toc;
+        toc.reserve(items.size());
+        std::stable_sort(items.begin(), items.end(), [](const Item& a, const Item& b) { return a.entry.pathHash < b.entry.pathHash; });
+        for (const Item& item : items) toc.push_back(item.entry);
+
+        pad(alignof(PackEntry));
+        std::memcpy(h.magic, kMagic, 4);
+        h.version = kVersion;
+        h.entryCount = static_cast<uint32_t>(toc.size());
+        h.tocOffset = offset;
+        write(toc.data(), toc.size() * sizeof(PackEntry));
+        h.namesOffset = offset;
+        h.namesSize = names.size();
+        write(names.data(), names.size());
+
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tmpPath, archivePath, ec);
+    if (ec) {
+        std::cerr << "[AssetArchive] failed to write \"" << archivePath << "\": " << ec.message() << "\n";
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
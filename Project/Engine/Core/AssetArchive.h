@@ -0,0 +1,90 @@
+// AssetArchive.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <Engine/Core/Singleton.h>
+
+// Bytes of one asset. 'data' points into the archive mapping, a decompressed copy or a mapped
+// loose file, and stays valid for as long as 'owner' (or a copy of this struct) is alive.
+struct AssetData {
+    std::shared_ptr<const void> owner;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+// Packed asset archive (".vpak"): every runtime file in one memory-mapped file, so startup pays
+// one open instead of a filesystem lookup per texture/model/shader.
+//   PackHeader | payloads (each 64-byte aligned) | PackEntry[entryCount] | names
+// The table of contents is sorted by Hash::Path of the normalized name, lookups are a binary
+// search over the mapping. Entries are stored raw or LZ4 compressed; raw entries are handed
+// out as views into the mapping without copying.
+class AssetArchive : public Singleton<AssetArchive> {
+public:
+    static constexpr uint32_t kVersion = 1;
+    static constexpr char kMagic[4] = { 'V', 'R', 'P', 'K' };
+
+    enum class Compression : uint32_t { None = 0, LZ4 = 1 };
+
+    struct PackHeader {
+        char     magic[4];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+        uint64_t tocOffset;      // PackEntry[entryCount], 8-byte aligned
+        uint64_t namesOffset;    // normalized names, not null terminated
+        uint64_t namesSize;
+    };
+    static_assert(sizeof(PackHeader) == 40, "PackHeader layout changed; bump AssetArchive::kVersion");
+
+    struct PackEntry {
+        uint64_t pathHash;       // Hash::Path(normalized name)
+        uint64_t offset;
+        uint64_t storedSize;
+        uint64_t size;           // uncompressed
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t compression;    // Compression
+        uint32_t reserved;
+    };
+    static_assert(sizeof(PackEntry) == 48, "PackEntry layout changed; bump AssetArchive::kVersion");
+
+    // Maps 'path' and makes its entries visible to Open(). Replaces a previous archive;
+    // data already handed out stays valid. Returns false (quietly if the file doesn't exist).
+    bool mount(const std::string& path);
+    void unmount();
+    bool isMounted() const;
+    size_t entryCount() const;
+
+    // Archive entry only
+    AssetData find(const std::string& path) const;
+
+    // Archive first, loose file second (development builds run without an archive)
+    static AssetData Open(const std::string& path);
+
+    // "./Resources\\a.png" -> "Resources/a.png"; names are matched case-insensitively
+    static std::string NormalizePath(const std::string& path);
+
+    // Offline side (AssetCooker): writes 'files' as {archive name, file on disk}. Output only
+    // depends on the file contents, so packing the same tree twice gives identical archives.
+    // compress: LZ4 entries that shrink by at least 1/8, store the rest raw.
+    static bool Build(const std::string& archivePath,
+        const std::vector<std::pair<std::string, std::string>>& files,
+        bool compress);
+
+private:
+    friend class Singleton<AssetArchive>;
+    AssetArchive() = default;
+
+    struct Mounted;
+
+    mutable std::mutex m_mtx;
+    std::shared_ptr<const Mounted> m_mounted;   // swapped whole, readers keep their snapshot
+};
@@ -0,0 +1,48 @@
+// AssetLoader.cpp
+#include "AssetLoader.h"
+#include <chrono>
+
+ThreadPool& AssetLoader::pool() {
+    std::lock_guard<std::mutex> lock(m_poolMtx);
+    if (!m_pool) m_pool = std::make_unique<ThreadPool>();
+    return *m_pool;
+}
+
+void AssetLoader::pump(double budgetMs) {
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+
+    for (bool first = true;; first = false) {
+        if (!first && std::chrono::duration<double, std::milli>(clock::now() - start).count() >= budgetMs)
+            break;
+
+        Continuation c;
+        {
+            std::lock_guard<std::mutex> lock(m_readyMtx);
+            if (m_ready.empty()) break;
+            c = std::move(m_ready.front());
+            m_ready.pop_front();
+        }
+
+        try {
+            c.run();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "[AssetLoader] \"" << c.name << "\" finalize failed: " << e.what() << "\n";
+        }
+    }
+}
+
+size_t AssetLoader::pendingCount() {
+    std::lock_guard<std::mutex> lock(m_readyMtx);
+    return m_inFlight.load() + m_ready.size();
+}
+
+void AssetLoader::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_poolMtx);
+        m_pool.reset(); // joins after draining the queue
+    }
+    std::lock_guard<std::mutex> lock(m_readyMtx);
+    m_ready.clear();
+}
@@ -0,0 +1,68 @@
+// AssetLoader.h
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <Engine/Core/Singleton.h>
+#include <Engine/Core/ThreadPool.h>
+
+// Background asset loading. File I/O and decoding run on the pool; the result is handed to a
+// continuation that runs on the main thread inside pump(), which is where GPU uploads and scene
+// edits belong. pump() stops once its per-frame budget is spent, so a burst of finished loads
+// is spread over several frames instead of hitching one.
+class AssetLoader : public Singleton<AssetLoader> {
+public:
+    // 'work' runs on a worker thread, 'onReady' on the main thread with its result.
+    // If 'work' throws, the error is logged and 'onReady' is never called.
+    template <typename T>
+    void enqueue(const std::string& name, std::function<T()> work, std::function<void(T&)> onReady) {
+        ++m_inFlight;
+        pool().submit([this, name, work = std::move(work), onReady = std::move(onReady)]() {
+            try {
+                auto result = std::make_shared<T>(work());
+                std::lock_guard<std::mutex> lock(m_readyMtx);
+                m_ready.emplace_back(Continuation{ name, [result, onReady] { onReady(*result); } });
+                --m_inFlight;
+                return;
+            }
+            catch (const std::exception& e) {
+                std::cerr << "[AssetLoader] \"" << name << "\" failed: " << e.what() << "\n";
+            }
+            --m_inFlight;
+            });
+    }
+
+    // Runs finished continuations until 'budgetMs' is used up. At least one runs per call so
+    // loading always makes progress, even when a single upload is larger than the budget.
+    void pump(double budgetMs);
+
+    // Loads still on a worker or waiting for pump()
+    size_t pendingCount();
+
+    // Waits for the workers and drops the continuations that never ran (call before teardown)
+    void shutdown();
+
+    // The worker pool itself, for callers that block on their own futures (TextureManager::loadMany)
+    ThreadPool& pool();
+
+private:
+    friend class Singleton<AssetLoader>;
+    AssetLoader() = default;
+
+    struct Continuation {
+        std::string name;
+        std::function<void()> run;
+    };
+
+    std::unique_ptr<ThreadPool> m_pool;    // created on first use
+    std::mutex m_poolMtx;
+    std::mutex m_readyMtx;
+    std::deque<Continuation> m_ready;
+    std::atomic<size_t> m_inFlight{ 0 };
+};
@@ -0,0 +1,123 @@
+// Hash.h
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+
+// 64-bit content hashing for asset data (XXH64 algorithm).
+// Works on 32-byte stripes with four independent accumulators, so it runs at memory speed
+// instead of the one-multiply-per-byte of FNV-1a. Not cryptographic.
+namespace Hash {
+
+    namespace detail {
+        constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+        constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+        constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+        constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+        constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+        inline uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+        inline uint64_t Read64(const uint8_t* p) { uint64_t v; std::memcpy(&v, p, sizeof(v)); return v; }
+        inline uint32_t Read32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, sizeof(v)); return v; }
+
+        inline uint64_t Round(uint64_t acc, uint64_t input) {
+            acc += input * kPrime2;
+            acc = Rotl(acc, 31);
+            return acc * kPrime1;
+        }
+
+        inline uint64_t MergeRound(uint64_t acc, uint64_t val) {
+            acc ^= Round(0, val);
+            return acc * kPrime1 + kPrime4;
+        }
+    }
+
+    inline uint64_t XXH64(const void* data, size_t len, uint64_t seed = 0) {
+        using namespace detail;
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        const uint8_t* const end = p + len;
+        uint64_t h;
+
+        if (len >= 32) {
+            const uint8_t* const limit = end - 32;
+            uint64_t v1 = seed + kPrime1 + kPrime2;
+            uint64_t v2 = seed + kPrime2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - kPrime1;
+            do {
+                v1 = Round(v1, Read64(p));      p += 8;
+                v2 = Round(v2, Read64(p));      p += 8;
+                v3 = Round(v3, Read64(p));      p += 8;
+                v4 = Round(v4, Read64(p));      p += 8;
+            } while (p <= limit);
+
+            h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+            h = MergeRound(h, v1);
+            h = MergeRound(h, v2);
+            h = MergeRound(h, v3);
+            h = MergeRound(h, v4);
+        }
+        else {
+            h = seed + kPrime5;
+        }
+
+        h += static_cast<uint64_t>(len);
+
+        while (p + 8 <= end) {
+            h ^= Round(0, Read64(p));
+            h = Rotl(h, 27) * kPrime1 + kPrime4;
+            p += 8;
+        }
+        if (p + 4 <= end) {
+            h ^= static_cast<uint64_t>(Read32(p)) * kPrime1;
+            h = Rotl(h, 23) * kPrime2 + kPrime3;
+            p += 4;
+        }
+        while (p < end) {
+            h ^= (*p) * kPrime5;
+            h = Rotl(h, 11) * kPrime1;
+            ++p;
+        }
+
+        // avalanche
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        h *= kPrime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    // Hash of 'b' chained onto 'a' (order dependent)
+    inline uint64_t Combine(uint64_t a, uint64_t b) {
+        return XXH64(&b, sizeof(b), a);
+    }
+
+    // Mesh content hash: raw vertex bytes, then the indices. V must be tightly packed.
+    template <typename V>
+    inline uint64_t Geometry(const V* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount) {
+        uint64_t h = XXH64(vertices, vertexCount * sizeof(V));
+        if (indexCount) h = XXH64(indices, indexCount * sizeof(uint32_t), h);
+        return h;
+    }
+
+    template <typename V>
+    inline uint64_t Geometry(const std::vector<V>& vertices, const std::vector<uint32_t>& indices) {
+        return Geometry(vertices.data(), vertices.size(), indices.data(), indices.size());
+    }
+
+    // Case-insensitive path hash, so "Cat.obj" and "cat.obj" map to the same asset
+    inline uint64_t Path(const std::string& path) {
+        std::string s = path;
+        std::transform(s.begin(), s.end(), s.begin(),
+            [](unsigned char c) { return (unsigned char)std::tolower(c); });
+        return XXH64(s.data(), s.size());
+    }
+
+} // namespace Hash
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+// Read-only memory mapping of a whole file (Win32 file mapping / POSIX mmap).
+// The OS pages data in on first touch, so opening is cheap and nothing is parsed or copied.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Returns false if the file doesn't exist, is empty or can't be mapped
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return m_Data != nullptr; }
+    const uint8_t* data() const { return m_Data; }
+    size_t size() const { return m_Size; }
+
+private:
+    const uint8_t* m_Data = nullptr;
+    size_t m_Size = 0;
+#ifdef _WIN32
+    void* m_File = nullptr;     // HANDLE
+    void* m_Mapping = nullptr;  // HANDLE
+#else
+    int m_Fd = -1;
+#endif
+};
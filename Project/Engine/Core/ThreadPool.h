@@ -0,0 +1,92 @@
+// ThreadPool.h
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of worker threads pulling from one FIFO queue.
+// Tasks must not touch scene state, and of Vulkan only calls that are thread-safe without
+// external locks: pipeline creation against the shared VkPipelineCache (Pipeline's async and
+// variant compiles) is fine; queues, command pools, descriptor sets and anything the frame
+// records are not. Hand those results back to the main thread instead (see AssetLoader).
+class ThreadPool {
+public:
+    // 0 = hardware_concurrency - 1 (the main thread keeps a core), at least one worker
+    explicit ThreadPool(unsigned threads = 0) {
+        if (threads == 0) {
+            const unsigned hw = std::thread::hardware_concurrency();
+            threads = hw > 1 ? hw - 1 : 1;
+        }
+        m_workers.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i)
+            m_workers.emplace_back([this] { workerLoop(); });
+    }
+
+    // Finishes the queued tasks, then joins
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for (std::thread& t : m_workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        // std::function needs a copyable target, packaged_task is move-only
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        std::future<R> fut = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_tasks.emplace_back([task] { (*task)(); });
+        }
+        m_cv.notify_one();
+        return fut;
+    }
+
+    unsigned size() const { return static_cast<unsigned>(m_workers.size()); }
+
+    // True on a worker of any pool: code that would fan out onto its own threads should stay
+    // serial there, the pool already keeps every core busy (see ParseOBJParallel)
+    static bool OnWorkerThread() { return WorkerFlag(); }
+
+private:
+    static bool& WorkerFlag() {
+        thread_local bool onWorker = false;
+        return onWorker;
+    }
+
+    void workerLoop() {
+        WorkerFlag() = true;
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mtx);
+                m_cv.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+                if (m_tasks.empty()) return; // stopping and drained
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+};
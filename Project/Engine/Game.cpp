@@ -2,9 +2,17 @@
 #include <Engine/Graphics/vulkanVars.h>
 #include "Platform/Windows/PlatformWindow_Windows.h"
 #include <Engine/Graphics/MaterialManager.h>
+#include <Engine/Graphics/Texture.h>
+#include <Engine/Graphics/SamplerCache.h>
+#include <Engine/Graphics/PipelineCache.h>
+#include <Engine/Graphics/PipelineLayoutCache.h>
+#include <Engine/Graphics/FrameUniforms.h>
 #include <vector>
 #include <random>
 #include "Engine/Core/Settings.h"
+#include <Engine/ObjUtils/ObjUtils.h>
+#include <Engine/Core/AssetLoader.h>
+#include <Engine/Core/AssetArchive.h>
 
 Game::Game()
     : m_WindowManager(WindowManager::GetInstance()),
@@ -27,11 +35,25 @@ void Game::init() {
 
     // Optional defaults (only fill if missing)
     Settings::GetInstance().MergeDefaults({
-        {"renderer", {{"showNormals", false}, {"chunkDebug", true}, {"renderDistance", 200.0}, {"chunkRange", 100.0}}},
+        {"renderer", {{"showNormals", false}, {"chunkDebug", true}, {"renderDistance", 200.0}, {"chunkRange", 100.0}, {"meshletCulling", true}, {"textureMips", true}, {"anisotropy", 16.0}}},
         {"camera",   {{"fov", 90.0}, {"near", 0.1}, {"far", 1000.0}}},
-        {"general",  {{"capFps", false}, {"fpsCap", 60}}}
+        {"general",  {{"capFps", false}, {"fpsCap", 60}}},
+        {"memory",   {{"objParseCache", false}, {"textureBudgetMB", 2048.0}, {"textureIdleFrames", 300}, {"followDeviceBudget", true}}},
+        {"streaming", {{"enabled", true}, {"residentSize", 128}, {"budgetMB", 1024.0}, {"uploadMBPerFrame", 32.0}, {"fullResDistance", 16.0}}},
+        {"assets",   {{"meshCacheDir", "cache/meshes"}, {"pipelineCache", "cache/pipelines.bin"}, {"cookedDir", "Cooked"}, {"archive", "assets.vpak"}, {"asyncLoading", true}, {"loadBudgetMs", 2.0}, {"packSmallTextures", true}, {"packMaxSize", 256}}}
         });
 
+    ObjUtils::SetParseCacheEnabled(Settings::GetInstance().Get<bool>("memory.objParseCache", false));
+    ObjUtils::SetMeshCacheDir(Settings::GetInstance().Get<std::string>("assets.meshCacheDir", "cache/meshes"));
+    ObjUtils::SetCookedAssetDir(Settings::GetInstance().Get<std::string>("assets.cookedDir", "Cooked"));
+    // Missing archive is fine: development builds read the loose files
+    AssetArchive::GetInstance().mount(Settings::GetInstance().Get<std::string>("assets.archive", "assets.vpak"));
+    // Texture upload options; only textures created afterwards pick up changes
+    Texture::SetMipmapGeneration(Settings::GetInstance().Get<bool>("renderer.textureMips", true));
+    Texture::SetMaxAnisotropy(Settings::GetInstance().Get<float>("renderer.anisotropy", 16.f));
+    Texture::SetStreaming(Settings::GetInstance().Get<bool>("streaming.enabled", true),
+        static_cast<uint32_t>(std::max(Settings::GetInstance().Get<int>("streaming.residentSize", 128), 1)));
+
 
     m_WindowManager.initWindow();
 
@@ -140,16 +162,24 @@ void Game::initScene() {
     }
 
     // --- 2) Materials ----------------------------------------------------------
-    std::shared_ptr<Material> stoneMat = std::make_shared<Material>(
+    // Async: the scene and the spawner's choices start on placeholder textures and pick up the
+    // real maps as the loader finishes them, instead of decoding everything before the first frame
+    const bool asyncMaterials = Settings::GetInstance().Get<bool>("assets.asyncLoading", true);
+    auto makeMaterial = [asyncMaterials](const std::string& albedo, const std::string& normal = "",
+        const std::string& metalness = "", const std::string& roughness = "", const std::string& height = "") {
+        return asyncMaterials ? Material::CreateAsync(albedo, normal, metalness, roughness, height)
+                              : std::make_shared<Material>(albedo, normal, metalness, roughness, height);
+        };
+    std::shared_ptr<Material> stoneMat = makeMaterial(
         "Resources/Textures/Rocks/rocks_albedo.jpg",
         "Resources/Textures/Rocks/rocks_normal.jpg",
         "",
         "Resources/Textures/Rocks/rocks_roughness.jpg",
         "Resources/Textures/Rocks/rocks_displacement.jpg");
-    std::shared_ptr<Material> bronzeMat = std::make_shared<Material>("Resources/Textures/errorTexture.jpg");
-    std::shared_ptr<Material> testMat = std::make_shared<Material>("Resources/Textures/testTexture.jpg");
-    std::shared_ptr<Material> catMat = std::make_shared<Material>("Resources/Textures/Cat/Cat_diffuse.jpg", "", "", "");
-    std::shared_ptr<Material> kdhMat = std::make_shared<Material>("Resources/Textures/kdh.jpg");
+    std::shared_ptr<Material> bronzeMat = makeMaterial("Resources/Textures/errorTexture.jpg");
+    std::shared_ptr<Material> testMat = makeMaterial("Resources/Textures/testTexture.jpg");
+    std::shared_ptr<Material> catMat = makeMaterial("Resources/Textures/Cat/Cat_diffuse.jpg");
+    std::shared_ptr<Material> kdhMat = makeMaterial("Resources/Textures/kdh.jpg");
     std::shared_ptr<Material> errorMat = std::make_shared<Material>();
 
     std::vector<std::shared_ptr<Material>> uiMats = { stoneMat, bronzeMat, testMat, catMat, kdhMat };
@@ -298,6 +328,7 @@ void Game::run() {
 
         //m_Physics.stepPhysics(false, deltaTime);
         m_Renderer->RenderFrame(m_RenderItems, *m_Camera);
+        vulkan_vars.frameIndex++;
 
         InputManager::GetInstance().HandleCameraInputs(m_Camera, deltaTime);
         m_Camera->update();
@@ -330,6 +361,14 @@ void Game::run() {
         }
     }
 
+    // Workers may still be parsing; their results must not outlive the device
+    AssetLoader::GetInstance().shutdown();
     vkDeviceWaitIdle(vulkan_vars.device);
+    TextureManager::GetInstance().releaseRetired(vulkan_vars.frameIndex, true);
+    SamplerCache::GetInstance().destroy();
+    FrameUniforms::GetInstance().destroy();
+    PipelineLayoutCache::GetInstance().destroy();
+    PipelineCache::GetInstance().save();
+    PipelineCache::GetInstance().destroy();
 }
 
@@ -114,7 +114,7 @@ void DataBuffer::copyBuffer(VkBuffer srcBuffer, const VkCommandPool& commandPool
     vkFreeCommandBuffers(device, commandPool, 1, &cmd);
 }
 
-void DataBuffer::upload(VkDeviceSize size, void* data)
+void DataBuffer::upload(VkDeviceSize size, const void* data)
 {
     if (!isHostVisible() || !m_Mapped) {
         throw std::runtime_error("DataBuffer::upload on non-mappable memory; use staging+copyBuffer");
@@ -133,7 +133,7 @@ void DataBuffer::upload(VkDeviceSize size, void* data)
     m_UniformBufferMapped = m_Mapped;
 }
 
-void DataBuffer::uploadRaw(VkDeviceSize size, void* data, VkDeviceSize dstOffset)
+void DataBuffer::uploadRaw(VkDeviceSize size, const void* data, VkDeviceSize dstOffset)
 {
     if (!isHostVisible() || !m_Mapped) {
         throw std::runtime_error("DataBuffer::uploadRaw on non-mappable memory; use staging+copyBuffer");
@@ -157,8 +157,8 @@ void DataBuffer::uploadRaw(VkDeviceSize size, void* data, VkDeviceSize dstOffset
 
 // Back-compat shims: these used to vkMapMemory every time.
 // Now they just copy into the persistent mapping.
-void DataBuffer::map(VkDeviceSize size, void* data) { upload(size, data); }
-void DataBuffer::remap(VkDeviceSize size, void* data) { upload(size, data); }
+void DataBuffer::map(VkDeviceSize size, const void* data) { upload(size, data); }
+void DataBuffer::remap(VkDeviceSize size, const void* data) { upload(size, data); }
 
 void DataBuffer::destroy(const VkDevice& /*device*/)
 {
@@ -178,8 +178,8 @@ void DataBuffer::bindAsVertexBuffer(VkCommandBuffer commandBuffer) {
     VkDeviceSize offs[] = { 0 };
     vkCmdBindVertexBuffers(commandBuffer, 0, 1, bufs, offs);
 }
-void DataBuffer::bindAsIndexBuffer(VkCommandBuffer commandBuffer) {
-    vkCmdBindIndexBuffer(commandBuffer, m_VkBuffer, 0, VK_INDEX_TYPE_UINT32);
+void DataBuffer::bindAsIndexBuffer(VkCommandBuffer commandBuffer, VkIndexType indexType) {
+    vkCmdBindIndexBuffer(commandBuffer, m_VkBuffer, 0, indexType);
 }
 
 VkBuffer DataBuffer::getVkBuffer() { return m_VkBuffer; }
@@ -17,15 +17,15 @@ public:
     ~DataBuffer() = default;
 
     // Back-compat names, now zero-cost wrappers over persistent mapping
-    void upload(VkDeviceSize size, void* data);
-    void uploadRaw(VkDeviceSize size, void* data, VkDeviceSize dstOffset);
-    void map(VkDeviceSize size, void* data);      // wrapper over upload()
-    void remap(VkDeviceSize size, void* data);    // wrapper over upload()
+    void upload(VkDeviceSize size, const void* data);
+    void uploadRaw(VkDeviceSize size, const void* data, VkDeviceSize dstOffset);
+    void map(VkDeviceSize size, const void* data);      // wrapper over upload()
+    void remap(VkDeviceSize size, const void* data);    // wrapper over upload()
 
     void destroy(const VkDevice& device);
 
     void bindAsVertexBuffer(VkCommandBuffer commandBuffer);
-    void bindAsIndexBuffer(VkCommandBuffer commandBuffer);
+    void bindAsIndexBuffer(VkCommandBuffer commandBuffer, VkIndexType indexType = VK_INDEX_TYPE_UINT32);
 
     VkBuffer getVkBuffer();
     void* getUniformBuffer();                     // returns persistent mapped ptr
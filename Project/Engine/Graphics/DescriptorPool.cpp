@@ -2,19 +2,25 @@
 #include <iostream>
 #include <Engine/Graphics/vulkanVars.h>
 #include <array>
+#include <algorithm>
 
 
-DescriptorPool::DescriptorPool(const VkDevice& device, VkDeviceSize size, size_t count)
-	:m_Device{device}, m_Size{size},m_Count{count}
+DescriptorPool::DescriptorPool(const VkDevice& device, VkDeviceSize size, size_t count, VkDescriptorSetLayout layout, const SetLayoutDesc& desc)
+	:m_Device{device}, m_Size{size},m_Count{count}, m_Bindings{desc.bindings}, m_DescriptorSetLayout{layout}
 {
-	std::array<VkDescriptorPoolSize, 2> poolSizes{};
-	poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	poolSizes[0].descriptorCount = static_cast<uint32_t>(count);
-	poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	poolSizes[1].descriptorCount = static_cast<uint32_t>(count * MAX_TEXTURES);
+	// One pool size per descriptor type the layout uses
+	std::vector<VkDescriptorPoolSize> poolSizes;
+	for (const VkDescriptorSetLayoutBinding& b : m_Bindings) {
+		auto it = std::find_if(poolSizes.begin(), poolSizes.end(), [&](const VkDescriptorPoolSize& ps) { return ps.type == b.descriptorType; });
+		if (it == poolSizes.end()) it = poolSizes.insert(poolSizes.end(), { b.descriptorType, 0 });
+		it->descriptorCount += static_cast<uint32_t>(count * b.descriptorCount);
+	}
+	// Shaders without descriptors get no pool and no sets
+	if (poolSizes.empty()) return;
 
 	VkDescriptorPoolCreateInfo poolInfo{};
 	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	if (desc.updateAfterBind()) poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
 	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
 	poolInfo.pPoolSizes = poolSizes.data();
 	poolInfo.maxSets = static_cast<uint32_t>(count);
@@ -24,39 +30,18 @@ DescriptorPool::DescriptorPool(const VkDevice& device, VkDeviceSize size, size_t
 	}
 }
 
-void DescriptorPool::Initialize(const VkDevice& device)
+const VkDescriptorSetLayoutBinding* DescriptorPool::findBinding(uint32_t binding, VkDescriptorType type) const
 {
-	VkDescriptorSetLayoutBinding uboLayoutBinding{};
-	uboLayoutBinding.binding = 0;
-	uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	uboLayoutBinding.descriptorCount = 1;
-	uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-	uboLayoutBinding.pImmutableSamplers = nullptr;
-
-	VkDescriptorSetLayoutBinding samplerLayoutBinding{};
-	samplerLayoutBinding.binding = 1;
-	samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	samplerLayoutBinding.descriptorCount = MAX_TEXTURES;
-	samplerLayoutBinding.stageFlags =  VK_SHADER_STAGE_FRAGMENT_BIT;
-	samplerLayoutBinding.pImmutableSamplers = nullptr;
-
-	std::array<VkDescriptorSetLayoutBinding, 2> bindings = { uboLayoutBinding, samplerLayoutBinding };
-
-	VkDescriptorSetLayoutCreateInfo layoutInfo{};
-	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-	layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-	layoutInfo.pBindings = bindings.data();
-
-	if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_DescriptorSetLayout) != VK_SUCCESS) {
-		throw std::runtime_error("failed to create descriptor set layout!");
-	}
+	for (const VkDescriptorSetLayoutBinding& b : m_Bindings)
+		if (b.binding == binding) return b.descriptorType == type ? &b : nullptr;
+	return nullptr;
 }
 
 void DescriptorPool::Destroy(const VkDevice& device)
 {
 	vkDestroyDescriptorPool(device, m_DescriptorPool, nullptr);
-
-	vkDestroyDescriptorSetLayout(device, m_DescriptorSetLayout, nullptr);
+	m_DescriptorPool = VK_NULL_HANDLE;
+	m_DescriptorSets.clear();
 }
 
 DescriptorPool::~DescriptorPool()
@@ -64,8 +49,14 @@ DescriptorPool::~DescriptorPool()
 
 }
 
-void DescriptorPool::createDescriptorSets(const std::vector<VkBuffer>& buffers, const std::vector<std::vector<VkDescriptorImageInfo>>& images)
+void DescriptorPool::createDescriptorSets(VkBuffer uniformBuffer, const std::vector<std::vector<VkDescriptorImageInfo>>& images, VkSampler sampler)
 {
+	if (m_DescriptorPool == VK_NULL_HANDLE) return;
+
+	const VkDescriptorSetLayoutBinding* ubo = findBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC);
+	const VkDescriptorSetLayoutBinding* table = findBinding(1, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE);
+	const VkDescriptorSetLayoutBinding* samplerBinding = findBinding(2, VK_DESCRIPTOR_TYPE_SAMPLER);
+
 	std::vector<VkDescriptorSetLayout> layouts(m_Count, m_DescriptorSetLayout);
 	VkDescriptorSetAllocateInfo allocInfo{};
 	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
@@ -81,40 +72,106 @@ void DescriptorPool::createDescriptorSets(const std::vector<VkBuffer>& buffers,
 	for (size_t i = 0; i < m_Count; ++i)
 	{
 		VkDescriptorBufferInfo bufferInfo{};
-		bufferInfo.buffer = buffers[i];
+		bufferInfo.buffer = uniformBuffer;
 		bufferInfo.offset = 0;
 		bufferInfo.range = m_Size;
 
-		std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
-
-		// UBO
-		descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptorWrites[0].dstSet = m_DescriptorSets[i];
-		descriptorWrites[0].dstBinding = 0;
-		descriptorWrites[0].dstArrayElement = 0;
-		descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		descriptorWrites[0].descriptorCount = 1;
-		descriptorWrites[0].pBufferInfo = &bufferInfo;
-
-		// Sampler (Texture)
-		descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptorWrites[1].dstSet = m_DescriptorSets[i];
-		descriptorWrites[1].dstBinding = 1;
-		descriptorWrites[1].dstArrayElement = 0;
-		descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		descriptorWrites[1].descriptorCount = MAX_TEXTURES;
-		descriptorWrites[1].pImageInfo = images[i].data();
-
-		vkUpdateDescriptorSets(m_Device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+		VkDescriptorImageInfo samplerInfo{};
+		samplerInfo.sampler = sampler;
+
+		std::array<VkWriteDescriptorSet, 3> descriptorWrites{};
+		uint32_t writeCount = 0;
+
+		// Uniform block
+		if (ubo) {
+			VkWriteDescriptorSet& write = descriptorWrites[writeCount++];
+			write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			write.dstSet = m_DescriptorSets[i];
+			write.dstBinding = 0;
+			write.dstArrayElement = 0;
+			write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+			write.descriptorCount = 1;
+			write.pBufferInfo = &bufferInfo;
+		}
+
+		// Sampler
+		if (samplerBinding) {
+			VkWriteDescriptorSet& write = descriptorWrites[writeCount++];
+			write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			write.dstSet = m_DescriptorSets[i];
+			write.dstBinding = 2;
+			write.dstArrayElement = 0;
+			write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+			write.descriptorCount = 1;
+			write.pImageInfo = &samplerInfo;
+		}
+
+		// Texture images
+		const uint32_t imageCount = table ? static_cast<uint32_t>(std::min<size_t>(images[i].size(), table->descriptorCount)) : 0;
+		if (imageCount > 0) {
+			VkWriteDescriptorSet& write = descriptorWrites[writeCount++];
+			write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			write.dstSet = m_DescriptorSets[i];
+			write.dstBinding = 1;
+			write.dstArrayElement = 0;
+			write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+			write.descriptorCount = imageCount;
+			write.pImageInfo = images[i].data();
+		}
+
+		if (writeCount > 0)
+			vkUpdateDescriptorSets(m_Device, writeCount, descriptorWrites.data(), 0, nullptr);
+	}
+}
+
+void DescriptorPool::writeSampler(size_t index, VkSampler sampler)
+{
+	if (index >= m_DescriptorSets.size() || !findBinding(2, VK_DESCRIPTOR_TYPE_SAMPLER)) return;
+
+	VkDescriptorImageInfo samplerInfo{};
+	samplerInfo.sampler = sampler;
+	VkWriteDescriptorSet write{};
+	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstSet = m_DescriptorSets[index];
+	write.dstBinding = 2;
+	write.dstArrayElement = 0;
+	write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+	write.descriptorCount = 1;
+	write.pImageInfo = &samplerInfo;
+	vkUpdateDescriptorSets(m_Device, 1, &write, 0, nullptr);
+}
+
+void DescriptorPool::writeTextures(size_t index, const std::vector<TextureSlot>& slots)
+{
+	if (index >= m_DescriptorSets.size()) return;
+
+	std::vector<VkWriteDescriptorSet> writes;
+	writes.reserve(slots.size());
+	for (const TextureSlot& s : slots) {
+		const VkDescriptorSetLayoutBinding* binding = findBinding(s.binding, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE);
+		if (!binding || s.slot >= binding->descriptorCount) continue;
+		VkWriteDescriptorSet write{};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = m_DescriptorSets[index];
+		write.dstBinding = s.binding;
+		write.dstArrayElement = s.slot;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+		write.descriptorCount = 1;
+		write.pImageInfo = &s.info;
+		writes.push_back(write);
 	}
+	if (!writes.empty())
+		vkUpdateDescriptorSets(m_Device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
 }
 
-void DescriptorPool::bindDescriptorSet(VkCommandBuffer buffer, VkPipelineLayout layout, size_t index)
+void DescriptorPool::bindDescriptorSet(VkCommandBuffer buffer, VkPipelineLayout layout, size_t index, uint32_t firstSet,
+	uint32_t dynamicOffsetCount, const uint32_t* dynamicOffsets)
 {
+	if (m_DescriptorPool == VK_NULL_HANDLE) return; // nothing the shaders read
 	if (index >= m_DescriptorSets.size())
 	{
 		std::cout << "out of range\n";
 		return;
 	}
-	vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &m_DescriptorSets[index], 0, nullptr);
+	vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, firstSet, 1, &m_DescriptorSets[index], dynamicOffsetCount, dynamicOffsets);
 }
@@ -3,14 +3,20 @@
 #include <vector>
 #include <memory>
 #include <Engine/Graphics/DataBuffer.h>
+#include <Engine/Graphics/Texture.h>
+#include <Engine/Graphics/vulkanVars.h>
+#include <Engine/Graphics/PipelineLayoutCache.h>
 
 class DescriptorPool
 {
 public:
 	DescriptorPool() {};
-	DescriptorPool(const VkDevice& device, VkDeviceSize size, size_t count);
-	void Initialize(const VkDevice& device);
+	// 'count' sets of 'layout' (PipelineLayoutCache), sized from 'desc', the bindings it was built
+	// from. Only bindings the layout has are written: dynamic uniform block of 'size' bytes at 0,
+	// texture table at 1, the sampler it is read with at 2, texture arrays of packed textures at 3.
+	DescriptorPool(const VkDevice& device, VkDeviceSize size, size_t count, VkDescriptorSetLayout layout, const SetLayoutDesc& desc);
 
+	// Pool only; the layout belongs to PipelineLayoutCache
 	void Destroy(const VkDevice& device);
 
 	const VkDescriptorSetLayout& getDescriptorSetLayout()
@@ -19,15 +25,25 @@ public:
 	}
 
 	~DescriptorPool() ;
-	void createDescriptorSets(const std::vector<VkBuffer>& buffers, const std::vector<std::vector<VkDescriptorImageInfo>>& images);
+	// images[i] fills the table of set i from slot 0 on (image views only); may be shorter than the table.
+	// The uniform block reads 'uniformBuffer' at the offset given when binding.
+	void createDescriptorSets(VkBuffer uniformBuffer, const std::vector<std::vector<VkDescriptorImageInfo>>& images, VkSampler sampler);
+	// Rewrites single table slots of set 'index'
+	void writeTextures(size_t index, const std::vector<TextureSlot>& slots);
+	void writeSampler(size_t index, VkSampler sampler);
 
-	void bindDescriptorSet(VkCommandBuffer buffer, VkPipelineLayout layout, size_t index);
+	void bindDescriptorSet(VkCommandBuffer buffer, VkPipelineLayout layout, size_t index, uint32_t firstSet = 0,
+		uint32_t dynamicOffsetCount = 0, const uint32_t* dynamicOffsets = nullptr);
 
 private:
-	VkDevice m_Device;
-	VkDeviceSize m_Size;
-	VkDescriptorPool m_DescriptorPool;
+	// Layout entry for 'binding' if it has that descriptor type
+	const VkDescriptorSetLayoutBinding* findBinding(uint32_t binding, VkDescriptorType type) const;
+
+	VkDevice m_Device = VK_NULL_HANDLE;
+	VkDeviceSize m_Size = 0;
+	VkDescriptorPool m_DescriptorPool = VK_NULL_HANDLE;
 	std::vector<VkDescriptorSet> m_DescriptorSets;
-	size_t m_Count;
-	VkDescriptorSetLayout m_DescriptorSetLayout;
+	size_t m_Count = 0;
+	std::vector<VkDescriptorSetLayoutBinding> m_Bindings;
+	VkDescriptorSetLayout m_DescriptorSetLayout = VK_NULL_HANDLE;
 };
\ No newline at end of file
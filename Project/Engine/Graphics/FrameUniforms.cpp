@@ -0,0 +1,112 @@
+// FrameUniforms.cpp
+#include "FrameUniforms.h"
+#include <Engine/Graphics/vulkanVars.h>
+#include <Engine/Graphics/PipelineLayoutCache.h>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    VkDeviceSize AlignUp(VkDeviceSize v, VkDeviceSize a) {
+        return (v + a - 1) / a * a;
+    }
+}
+
+void FrameUniforms::init(VkDeviceSize bytesPerFrame)
+{
+    auto& vk = vulkanVars::GetInstance();
+
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(vk.physicalDevice, &props);
+    m_Alignment = std::max<VkDeviceSize>(props.limits.minUniformBufferOffsetAlignment, 16);
+    m_BytesPerFrame = AlignUp(bytesPerFrame, m_Alignment);
+
+    m_Ring = std::make_unique<DataBuffer>(vk.physicalDevice, vk.device,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        m_BytesPerFrame * MAX_FRAMES_IN_FLIGHT);
+
+    // Set 0: the frame constants, at a dynamic offset into the ring
+    SetLayoutDesc desc;
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    desc.bindings.push_back(binding);
+    desc.bindingFlags.push_back(0);
+    m_SetLayout = PipelineLayoutCache::GetInstance().getSetLayout(desc);
+
+    VkDescriptorPoolSize poolSize{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1 };
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    if (vkCreateDescriptorPool(vk.device, &poolInfo, nullptr, &m_Pool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create frame descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_Pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_SetLayout;
+    if (vkAllocateDescriptorSets(vk.device, &allocInfo, &m_Set) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate frame descriptor set!");
+    }
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = m_Ring->getVkBuffer();
+    bufferInfo.offset = 0;
+    bufferInfo.range = sizeof(FrameConstants);
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = m_Set;
+    write.dstBinding = 0;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    write.descriptorCount = 1;
+    write.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets(vk.device, 1, &write, 0, nullptr);
+}
+
+void FrameUniforms::destroy()
+{
+    auto& vk = vulkanVars::GetInstance();
+    if (m_Pool) vkDestroyDescriptorPool(vk.device, m_Pool, nullptr);
+    m_Pool = VK_NULL_HANDLE;
+    m_Set = VK_NULL_HANDLE;
+    if (m_Ring) m_Ring->destroy(vk.device);
+    m_Ring.reset();
+}
+
+void FrameUniforms::beginFrame(uint64_t frame, const FrameConstants& constants)
+{
+    m_Region = (frame % MAX_FRAMES_IN_FLIGHT) * m_BytesPerFrame;
+    m_Cursor = 0;
+    m_Constants = constants;
+    m_ConstantsOffset = push(&m_Constants, sizeof(m_Constants));
+}
+
+uint32_t FrameUniforms::push(const void* data, VkDeviceSize size)
+{
+    if (m_Cursor + size > m_BytesPerFrame) {
+        throw std::runtime_error("frame uniform ring is full!");
+    }
+    const VkDeviceSize offset = m_Region + m_Cursor;
+    m_Ring->uploadRaw(size, data, offset);
+    m_Cursor = AlignUp(m_Cursor + size, m_Alignment);
+    return static_cast<uint32_t>(offset);
+}
+
+void FrameUniforms::bind(VkCommandBuffer cmd, VkPipelineLayout layout) const
+{
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &m_Set, 1, &m_ConstantsOffset);
+}
+
+VkPipelineLayout FrameUniforms::getPipelineLayout(VkDescriptorSetLayout pipelineSet, const VkPushConstantRange& range) const
+{
+    std::vector<VkDescriptorSetLayout> sets{ m_SetLayout };
+    if (pipelineSet != VK_NULL_HANDLE) sets.push_back(pipelineSet);
+    return PipelineLayoutCache::GetInstance().getPipelineLayout(sets, range);
+}
@@ -0,0 +1,65 @@
+// FrameUniforms.h
+#pragma once
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+
+#include <Engine/Core/Singleton.h>
+#include <Engine/Graphics/DataBuffer.h>
+
+// Camera and time for one frame, set 0 of every scene pipeline (shaders/frameConstants.glsl, std140)
+struct FrameConstants {
+    glm::mat4 view;
+    glm::mat4 proj;
+    glm::mat4 viewProj;
+    glm::vec4 cameraPos;   // xyz
+    float time;            // seconds since the renderer started
+    float _pad[3];
+};
+
+// All per-frame uniform data in one persistently mapped ring with a region per frame in flight.
+// A frame's region starts with its FrameConstants; pipelines append their own uniform block
+// behind them and bind it with a dynamic offset (set 1, binding 0, see ShaderBase).
+//
+// Each scene pipeline's layout (getPipelineLayout) carries exactly the push constants its shaders
+// declare. Layouts with different ranges aren't compatible for set 0, so every scene pass binds it
+// with its own layout (bind) after binding its pipeline.
+class FrameUniforms : public Singleton<FrameUniforms> {
+public:
+    // Needs the logical device; before any scene pipeline is created
+    void init(VkDeviceSize bytesPerFrame = 256 * 1024);
+    // Device must be idle
+    void destroy();
+
+    // Resets the region of 'frame' (vulkanVars::currentFrame, after its fence wait) and writes the constants
+    void beginFrame(uint64_t frame, const FrameConstants& constants);
+    const FrameConstants& getConstants() const { return m_Constants; }
+
+    // Copies 'size' bytes behind what this frame already holds; returns their dynamic offset
+    uint32_t push(const void* data, VkDeviceSize size);
+    VkBuffer getBuffer() const { return m_Ring ? m_Ring->getVkBuffer() : VK_NULL_HANDLE; }
+
+    // Set 0 with this frame's constants, through 'layout' (one from getPipelineLayout)
+    void bind(VkCommandBuffer cmd, VkPipelineLayout layout) const;
+
+    VkDescriptorSetLayout getSetLayout() const { return m_SetLayout; }
+    // Set 0 plus the pipeline's own set 1 (may be VK_NULL_HANDLE); range.size == 0: no push constants
+    VkPipelineLayout getPipelineLayout(VkDescriptorSetLayout pipelineSet, const VkPushConstantRange& range) const;
+
+private:
+    friend class Singleton<FrameUniforms>;
+    FrameUniforms() = default;
+
+    std::unique_ptr<DataBuffer> m_Ring;
+    VkDeviceSize m_BytesPerFrame = 0;
+    VkDeviceSize m_Alignment = 256;
+    VkDeviceSize m_Region = 0;       // start of the current frame's region
+    VkDeviceSize m_Cursor = 0;       // next free byte in it
+    uint32_t m_ConstantsOffset = 0;
+    FrameConstants m_Constants{};
+
+    VkDescriptorSetLayout m_SetLayout = VK_NULL_HANDLE;  // owned by PipelineLayoutCache
+    VkDescriptorPool m_Pool = VK_NULL_HANDLE;
+    VkDescriptorSet m_Set = VK_NULL_HANDLE;
+};
@@ -8,7 +8,12 @@ struct InstanceData {
     glm::mat4 model;     // 64
     glm::uvec4 texIds0;  // 16
     uint32_t   heightId; // 4
-    uint32_t   pad[3]{};
+    uint32_t   flags = 0; // 4, kInstanceFlipUV
+    uint32_t   pad[2]{};
+
+    // Per-instance switches that change what a material means, so they can't live in the batch's
+    // shader variant (which only drops work no instance needs)
+    static constexpr uint32_t kInstanceFlipUV = 1u << 0;
 
     static VkVertexInputBindingDescription getBindingDescription(uint32_t binding = 1) {
         VkVertexInputBindingDescription d{};
@@ -20,7 +25,7 @@ struct InstanceData {
 
     static std::vector<VkVertexInputAttributeDescription>
         getAttributeDescriptions(uint32_t binding = 1, uint32_t startLocation = 4) {
-        std::vector<VkVertexInputAttributeDescription> a(6);
+        std::vector<VkVertexInputAttributeDescription> a(7);
 
         const uint32_t base = static_cast<uint32_t>(offsetof(InstanceData, model));
         for (int i = 0; i < 4; ++i) {
@@ -39,6 +44,11 @@ struct InstanceData {
         a[5].location = startLocation + 5;                   // 9
         a[5].format = VK_FORMAT_R32_UINT;
         a[5].offset = static_cast<uint32_t>(offsetof(InstanceData, heightId));
+
+        a[6].binding = binding;
+        a[6].location = startLocation + 6;                   // 10
+        a[6].format = VK_FORMAT_R32_UINT;
+        a[6].offset = static_cast<uint32_t>(offsetof(InstanceData, flags));
         return a;
     }
 };
@@ -9,40 +9,58 @@ Material::Material(const std::string& albedoMapFileName,
     const std::string& roughnessMapFileName,
     const std::string& heightMapFileName)
 {
-    // Use the TextureManager to fetch or create textures.
-    if (!albedoMapFileName.empty()) {
-        m_AlbedoMapTexture = TextureManager::GetInstance().getOrCreateTexture(albedoMapFileName);
-    }
-    else {
-        m_AlbedoMapTexture = TextureManager::GetInstance().getStandardTexture();
-    }
-
-    if (!normalMapFileName.empty()) {
-        m_NormalMapTexture = TextureManager::GetInstance().getOrCreateTexture(normalMapFileName);
-    }
-    else {
-        m_NormalMapTexture = nullptr;
-    }
-
-    if (!metalnessMapFileName.empty()) {
-        m_MetalnessMapTexture = TextureManager::GetInstance().getOrCreateTexture(metalnessMapFileName);
-    }
-    else {
-        m_MetalnessMapTexture = nullptr;
-    }
-
-    if (!roughnessMapFileName.empty()) {
-        m_RoughnessMapTexture = TextureManager::GetInstance().getOrCreateTexture(roughnessMapFileName);
-    }
-    else {
-        m_RoughnessMapTexture = nullptr;
-    }
-    if (!heightMapFileName.empty()) {
-        m_HeightMapTexture = TextureManager::GetInstance().getOrCreateTexture(heightMapFileName);
-    }
-    else {
-        m_HeightMapTexture = nullptr;
-    }
+    // All maps decode in parallel and upload with a single submit
+    using ObjUtils::TextureRole;
+    auto textures = TextureManager::GetInstance().loadMany(
+        { albedoMapFileName, normalMapFileName, metalnessMapFileName, roughnessMapFileName, heightMapFileName },
+        { TextureRole::Color, TextureRole::Normal, TextureRole::Data, TextureRole::Data, TextureRole::Data });
+
+    m_AlbedoMapTexture = textures[0] ? textures[0] : TextureManager::GetInstance().getStandardTexture();
+    m_NormalMapTexture = textures[1];
+    m_MetalnessMapTexture = textures[2];
+    m_RoughnessMapTexture = textures[3];
+    m_HeightMapTexture = textures[4];
+}
+
+std::shared_ptr<Material> Material::CreateAsync(const std::string& albedoMapFileName,
+    const std::string& normalMapFileName,
+    const std::string& metalnessMapFileName,
+    const std::string& roughnessMapFileName,
+    const std::string& heightMapFileName)
+{
+    auto material = std::make_shared<Material>();
+    std::weak_ptr<Material> weak = material;
+
+    auto request = [&](const std::string& file, ObjUtils::TextureRole role, std::shared_ptr<Texture> Material::* slot) {
+        if (file.empty()) return;
+        TextureManager::GetInstance().getOrCreateTextureAsync(file, role,
+            [weak, slot](const std::shared_ptr<Texture>& texture) {
+                if (auto m = weak.lock()) (*m).*slot = texture;
+            });
+        };
+
+    using ObjUtils::TextureRole;
+    request(albedoMapFileName, TextureRole::Color, &Material::m_AlbedoMapTexture);
+    request(normalMapFileName, TextureRole::Normal, &Material::m_NormalMapTexture);
+    request(metalnessMapFileName, TextureRole::Data, &Material::m_MetalnessMapTexture);
+    request(roughnessMapFileName, TextureRole::Data, &Material::m_RoughnessMapTexture);
+    request(heightMapFileName, TextureRole::Data, &Material::m_HeightMapTexture);
+    return material;
+}
+
+std::shared_ptr<Material> Material::FromTextures(std::shared_ptr<Texture> albedo,
+    std::shared_ptr<Texture> normal,
+    std::shared_ptr<Texture> metalness,
+    std::shared_ptr<Texture> roughness,
+    std::shared_ptr<Texture> height)
+{
+    auto material = std::make_shared<Material>();
+    if (albedo) material->m_AlbedoMapTexture = std::move(albedo);
+    material->m_NormalMapTexture = std::move(normal);
+    material->m_MetalnessMapTexture = std::move(metalness);
+    material->m_RoughnessMapTexture = std::move(roughness);
+    material->m_HeightMapTexture = std::move(height);
+    return material;
 }
 
 std::vector<std::shared_ptr<Texture>> Material::getAllTextures() const {
@@ -54,3 +72,11 @@ std::vector<std::shared_ptr<Texture>> Material::getAllTextures() const {
     if (m_HeightMapTexture)    textures.push_back(m_HeightMapTexture);
     return textures;
 }
+
+uint32_t Material::getPbrFeatures() const {
+    uint32_t features = 0;
+    if (m_NormalMapTexture) features |= PBR_NORMAL_MAP;
+    if (m_HeightMapTexture) features |= PBR_HEIGHT_MAP;
+    if (m_MetalnessMapTexture || m_RoughnessMapTexture) features |= PBR_METAL_ROUGH;
+    return features;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <initializer_list>
 #include <memory>
 #include <string>
 #include <Engine/Graphics/Texture.h>
@@ -14,6 +15,21 @@ public:
         const std::string& roughnessMapFileName = "",
         const std::string& heightMapFileName = "");
 
+    // Starts with placeholder textures (standard albedo, no other maps) and swaps the real
+    // ones in as TextureManager finishes loading them in the background
+    static std::shared_ptr<Material> CreateAsync(const std::string& albedoMapFileName = "",
+        const std::string& normalMapFileName = "",
+        const std::string& metalnessMapFileName = "",
+        const std::string& roughnessMapFileName = "",
+        const std::string& heightMapFileName = "");
+
+    // Material from textures that are already loaded (null albedo -> standard texture)
+    static std::shared_ptr<Material> FromTextures(std::shared_ptr<Texture> albedo,
+        std::shared_ptr<Texture> normal = nullptr,
+        std::shared_ptr<Texture> metalness = nullptr,
+        std::shared_ptr<Texture> roughness = nullptr,
+        std::shared_ptr<Texture> height = nullptr);
+
     std::shared_ptr<Texture> getAlbedoMapTexture() const { return m_AlbedoMapTexture; }
     std::shared_ptr<Texture> getNormalMapTexture()  const { return m_NormalMapTexture; }
     std::shared_ptr<Texture> getMetalnessMapTexture()  const { return m_MetalnessMapTexture; }
@@ -27,6 +43,28 @@ public:
     uint32_t getHeightMapID() const { return m_HeightMapTexture ? m_HeightMapTexture->getID() : UINT32_MAX; ; }
 
     std::vector<std::shared_ptr<Texture>> getAllTextures() const;
+    // f(const std::shared_ptr<Texture>&) for every filled slot, without building a vector (per-frame paths)
+    template <class F>
+    void forEachTexture(F&& f) const {
+        for (const std::shared_ptr<Texture>* slot : { &m_AlbedoMapTexture, &m_NormalMapTexture,
+            &m_MetalnessMapTexture, &m_RoughnessMapTexture, &m_HeightMapTexture })
+            if (*slot) f(*slot);
+    }
+
+    // PBR shader variant the material needs: bit i is specialization constant i of pbrCommon.glsl.
+    // Only capabilities (work a variant may skip), never switches that change the result.
+    enum PbrFeature : uint32_t {
+        PBR_NORMAL_MAP  = 1u << 0,
+        PBR_HEIGHT_MAP  = 1u << 1,
+        PBR_METAL_ROUGH = 1u << 2,
+    };
+    static constexpr uint32_t kPbrFeatureCount = 3;
+    uint32_t getPbrFeatures() const;
+
+    // V is flipped when sampling (the default; every current asset expects it). Travels per
+    // instance (InstanceData::kInstanceFlipUV), so materials that differ can share a batch.
+    void setFlipUV(bool flip) { m_FlipUV = flip; }
+    bool getFlipUV() const { return m_FlipUV; }
 
 private:
     std::shared_ptr<Texture> m_AlbedoMapTexture;
@@ -34,5 +72,6 @@ private:
     std::shared_ptr<Texture> m_MetalnessMapTexture;
     std::shared_ptr<Texture> m_RoughnessMapTexture;
     std::shared_ptr<Texture> m_HeightMapTexture;
+    bool m_FlipUV = true;
 
 };
\ No newline at end of file
@@ -1,16 +1,20 @@
 #include "MaterialManager.h"
+#include <Engine/Core/Settings.h>
 
 // Constructor
 MaterialManager::MaterialManager() {
     m_standardMaterial = std::make_shared<Material>("Resources/Textures/errorTexture.jpg");
 }
 
-// Lookup or create material by file path (cached)
+// Lookup or create material by file path (cached); its texture loads in the background unless
+// async loading is off, so a new material never stalls the frame that asks for it
 std::shared_ptr<Material> MaterialManager::getOrCreateMaterial(const std::string& filepath) {
     auto it = m_materialCache.find(filepath);
     if (it != m_materialCache.end())
         return it->second;
-    auto material = std::make_shared<Material>(filepath);
+    auto material = Settings::GetInstance().Get<bool>("assets.asyncLoading", true)
+        ? Material::CreateAsync(filepath)
+        : std::make_shared<Material>(filepath);
     m_materialCache[filepath] = material;
     return material;
 }
@@ -7,11 +7,12 @@
 #include <glm/ext/scalar_constants.hpp>
 #include <iostream>
 #include <Engine/Graphics/MeshData.h>
+#include <algorithm>
 #include "MeshData.h"
 
 
-Mesh::Mesh(const std::vector<Vertex>& Vertexes, const std::vector<uint32_t>& indices, const std::shared_ptr<Material> mat)
-	:m_Vertices(Vertexes), m_Indices(indices)
+Mesh::Mesh(std::vector<Vertex> Vertexes, std::vector<uint32_t> indices, const std::shared_ptr<Material> mat)
+	:m_Vertices(std::move(Vertexes)), m_Indices(std::move(indices))
 {
 	m_VertexConstant = {};
 	m_VertexConstant.model = glm::mat4{ {1,0,0,0},{0,1,0,0},{0,0,1,0},{0,0,0,1} };
@@ -22,6 +23,59 @@ Mesh::Mesh(const std::vector<Vertex>& Vertexes, const std::vector<uint32_t>& ind
 		m_Indices.resize(m_Vertices.size());
 		for (uint32_t i = 0; i < m_Indices.size(); ++i) m_Indices[i] = i;
 	}
+
+	InitFromGeometry();
+}
+
+Mesh::Mesh(MeshBlobPtr blob, const std::shared_ptr<Material> mat)
+	:m_Blob(std::move(blob))
+{
+	m_VertexConstant = {};
+	m_VertexConstant.model = glm::mat4{ {1,0,0,0},{0,1,0,0},{0,0,1,0},{0,0,0,1} };
+	m_Material = mat;
+
+	// Non-indexed geometry needs generated indices, which the shared blob can't hold
+	if (m_Blob && m_Blob->indexData().empty()) {
+		DetachBlob();
+		m_Indices.resize(m_Vertices.size());
+		for (uint32_t i = 0; i < m_Indices.size(); ++i) m_Indices[i] = i;
+	}
+
+	InitFromGeometry();
+}
+
+void Mesh::InitFromGeometry() {
+	const ArrayView<Vertex> vertices = cpuVertices();
+	const ArrayView<uint32_t> indices = cpuIndices();
+
+	m_IndexType = ChooseIndexType(vertices.size());
+
+	if (m_Blob && m_Blob->hasBounds) {
+		m_LocalMin = m_Blob->boundsMin;
+		m_LocalMax = m_Blob->boundsMax;
+	}
+	else if (!vertices.empty()) {
+		m_LocalMin = m_LocalMax = vertices[0].pos;
+		for (const Vertex& v : vertices) {
+			m_LocalMin = glm::min(m_LocalMin, v.pos);
+			m_LocalMax = glm::max(m_LocalMax, v.pos);
+		}
+	}
+
+	if (indices.size() / 3 >= ObjUtils::kMeshletMinTriangles) {
+		m_Meshlets = ObjUtils::BuildMeshlets(vertices, indices);
+		m_MeshletCount = static_cast<uint32_t>(m_Meshlets.size());
+	}
+}
+
+// Copy-on-write: take a private copy of the shared geometry before editing it
+void Mesh::DetachBlob() {
+	if (!m_Blob) return;
+	const ArrayView<Vertex> vertices = m_Blob->vertexData();
+	const ArrayView<uint32_t> indices = m_Blob->indexData();
+	m_Vertices.assign(vertices.begin(), vertices.end());
+	m_Indices.assign(indices.begin(), indices.end());
+	m_Blob.reset();
 }
 
 void Mesh::initialize(VkPhysicalDevice physicalDevice, VkDevice device, const VkCommandPool& commandPool, const VkQueue& graphicsQueue) {
@@ -29,11 +83,43 @@ void Mesh::initialize(VkPhysicalDevice physicalDevice, VkDevice device, const Vk
 	CreateVertexBuffer(physicalDevice, device, commandPool, graphicsQueue);
 
 	CreateIndexBuffer(physicalDevice, device, commandPool, graphicsQueue);
+
+	if (!m_Meshlets.empty()) {
+		CreateMeshletBuffer(physicalDevice, device, commandPool, graphicsQueue);
+	}
+
+	if (!m_KeepCpuData) ReleaseCpuData();
+}
+
+void Mesh::ReleaseCpuData() {
+	// swap instead of clear() so the capacity is actually returned; a shared blob is only
+	// freed once the parse cache and every other mesh have let go of it too
+	m_Blob.reset();
+	std::vector<Vertex>().swap(m_Vertices);
+	std::vector<uint32_t>().swap(m_Indices);
+	std::vector<ObjUtils::Meshlet>().swap(m_Meshlets);
+}
+
+size_t Mesh::cpuBytes() const {
+	return (m_Blob ? m_Blob->bytes() : 0)
+		+ m_Vertices.capacity() * sizeof(Vertex)
+		+ m_Indices.capacity() * sizeof(uint32_t)
+		+ m_Meshlets.capacity() * sizeof(ObjUtils::Meshlet);
+}
+
+size_t Mesh::gpuBytes() const {
+	size_t bytes = 0;
+	if (m_VertexBuffer) bytes += m_VertexBuffer->getSizeInBytes();
+	if (m_IndexBuffer) bytes += m_IndexBuffer->getSizeInBytes();
+	if (m_MeshletBuffer) bytes += m_MeshletBuffer->getSizeInBytes();
+	return bytes;
 }
 
 
 void Mesh::CreateVertexBuffer(VkPhysicalDevice physicalDevice, VkDevice device, const VkCommandPool& commandPool, const VkQueue& graphicsQueue) {
-	VkDeviceSize vertexBufferSize = sizeof(m_Vertices[0]) * m_Vertices.size();
+	// A mapped cache entry is staged straight from the file mapping
+	const ArrayView<Vertex> vertices = cpuVertices();
+	VkDeviceSize vertexBufferSize = sizeof(Vertex) * vertices.size();
 
 	VkBuffer stagingBuffer;
 	VkDeviceMemory stagingBufferMemory;
@@ -43,7 +129,7 @@ void Mesh::CreateVertexBuffer(VkPhysicalDevice physicalDevice, VkDevice device,
 		vertexBufferSize
 	);
 
-	VertexStagingBuffer->map(vertexBufferSize, m_Vertices.data());
+	VertexStagingBuffer->map(vertexBufferSize, vertices.data());
 
 	m_VertexBuffer = std::make_unique<DataBuffer>(physicalDevice, device,
 		VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
@@ -57,7 +143,29 @@ void Mesh::CreateVertexBuffer(VkPhysicalDevice physicalDevice, VkDevice device,
 	VertexStagingBuffer->destroy(device);
 }
 void Mesh::CreateIndexBuffer(VkPhysicalDevice physicalDevice, VkDevice device, const VkCommandPool& commandPool, const VkQueue& graphicsQueue) {
-	VkDeviceSize indexBufferSize = sizeof(m_Indices[0]) * m_Indices.size();
+	const ArrayView<uint32_t> indices = cpuIndices();
+
+	// Vertices may have been appended since construction
+	m_IndexType = ChooseIndexType(cpuVertices().size());
+	m_IndexCount = static_cast<uint32_t>(indices.size());
+
+	std::vector<uint16_t> indices16;
+	const void* indexData = indices.data();
+	VkDeviceSize indexBufferSize = sizeof(uint32_t) * indices.size();
+	if (m_IndexType == VK_INDEX_TYPE_UINT16) {
+		indices16.resize(indices.size());
+		for (size_t i = 0; i < indices.size(); ++i) indices16[i] = static_cast<uint16_t>(indices[i]);
+		indexData = indices16.data();
+		indexBufferSize = sizeof(uint16_t) * indices16.size();
+	}
+
+	// The meshlet cull pass reads the indices as a uint[] storage buffer
+	VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+	VkDeviceSize allocSize = indexBufferSize;
+	if (!m_Meshlets.empty()) {
+		usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+		allocSize = (indexBufferSize + 3) & ~VkDeviceSize(3);
+	}
 
 	auto VertexStagingBuffer = std::make_unique<DataBuffer>(physicalDevice, device,
 		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
@@ -65,21 +173,43 @@ void Mesh::CreateIndexBuffer(VkPhysicalDevice physicalDevice, VkDevice device, c
 		indexBufferSize
 	);
 
-	VertexStagingBuffer->map(indexBufferSize, m_Indices.data());
+	VertexStagingBuffer->map(indexBufferSize, indexData);
 
 	m_IndexBuffer = std::make_unique<DataBuffer>(physicalDevice, device,
-		VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+		usage,
 		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-		sizeof(m_Indices[0]) * m_Indices.size()
+		allocSize
 	);
 
 	m_IndexBuffer->copyBuffer(VertexStagingBuffer->getVkBuffer(), commandPool, device, indexBufferSize,graphicsQueue);
 	VertexStagingBuffer->destroy(device);
 }
 
+void Mesh::CreateMeshletBuffer(VkPhysicalDevice physicalDevice, VkDevice device, const VkCommandPool& commandPool, const VkQueue& graphicsQueue) {
+	VkDeviceSize meshletBufferSize = sizeof(ObjUtils::Meshlet) * m_Meshlets.size();
+
+	auto MeshletStagingBuffer = std::make_unique<DataBuffer>(physicalDevice, device,
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		meshletBufferSize
+	);
+
+	MeshletStagingBuffer->map(meshletBufferSize, m_Meshlets.data());
+
+	m_MeshletBuffer = std::make_unique<DataBuffer>(physicalDevice, device,
+		VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		meshletBufferSize
+	);
+
+	m_MeshletBuffer->copyBuffer(MeshletStagingBuffer->getVkBuffer(), commandPool, device, meshletBufferSize, graphicsQueue);
+	MeshletStagingBuffer->destroy(device);
+}
+
 void Mesh::destroyMesh(const VkDevice& device) {
 	m_VertexBuffer->destroy(device);
 	m_IndexBuffer->destroy(device);
+	if (m_MeshletBuffer) m_MeshletBuffer->destroy(device);
 }
 
 void Mesh::setPosition(glm::vec3 position, glm::vec3 scale, glm::vec3 rotationAngles)
@@ -101,22 +231,25 @@ void Mesh::setPosition(glm::vec3 position, glm::vec3 scale, glm::vec3 rotationAn
 	m_VertexConstant.HeightMapID = m_Material->getHeightMapID();
 }
 
-void Mesh::draw(VkPipelineLayout pipelineLayout, VkCommandBuffer commandBuffer) {
+void Mesh::draw(VkPipelineLayout pipelineLayout, const VkPushConstantRange& pushRange, VkCommandBuffer commandBuffer) {
 
 
 	m_VertexBuffer->bindAsVertexBuffer(commandBuffer);
-	m_IndexBuffer->bindAsIndexBuffer(commandBuffer);
-
-	vkCmdPushConstants(
-		commandBuffer,
-		pipelineLayout,
-		VK_SHADER_STAGE_VERTEX_BIT ,
-		0,                          
-		sizeof(MeshData),         
-		&m_VertexConstant 
-	);
+	m_IndexBuffer->bindAsIndexBuffer(commandBuffer, m_IndexType);
+
+	// As much of MeshData as the pipeline's shaders declare, to the stages that declare it
+	if (pushRange.size > 0) {
+		vkCmdPushConstants(
+			commandBuffer,
+			pipelineLayout,
+			pushRange.stageFlags,
+			0,
+			std::min<uint32_t>(pushRange.size, sizeof(MeshData)),
+			&m_VertexConstant
+		);
+	}
 
-	vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(m_Indices.size()), 1, 0, 0, 0);
+	vkCmdDrawIndexed(commandBuffer, getIndexCount(), 1, 0, 0, 0);
 }
 
 void Mesh::addVertex(glm::vec3 pos, glm::vec3 color, glm::vec3 normal, glm::vec2 uv) {
@@ -126,11 +259,13 @@ void Mesh::addVertex(glm::vec3 pos, glm::vec3 color, glm::vec3 normal, glm::vec2
 	newVertex.normal = normal;
 	newVertex.texCoord = uv;
 
+	DetachBlob();
 	m_Vertices.push_back(newVertex);
 }
 
 void Mesh::addTriangle(uint32_t i1, uint32_t i2, uint32_t i3, uint32_t offset)
 {
+	DetachBlob();
 	m_Indices.push_back(i1 + offset * 3);
 	m_Indices.push_back(i2 + offset * 3);
 	m_Indices.push_back(i3 + offset * 3);
@@ -5,11 +5,16 @@
 #include <glm/glm.hpp>
 #include <Engine/Graphics/DataBuffer.h>
 #include <Engine/Graphics/MeshData.h>
+#include <Engine/Graphics/MeshBlob.h>
 #include <Engine/Graphics/MaterialManager.h>
+#include <Engine/ObjUtils/Meshlets.h>
 #include <memory>
 class Mesh {
 public:
-	Mesh(const std::vector<Vertex>& Vertexes, const std::vector<uint32_t>& indices, const std::shared_ptr<Material> mat = {});
+	// Taken by value: pass rvalues to hand the importer's buffers over without a copy
+	Mesh(std::vector<Vertex> Vertexes, std::vector<uint32_t> indices, const std::shared_ptr<Material> mat = {});
+	// References imported geometry without copying; the blob stays shared until it is edited
+	Mesh(MeshBlobPtr blob, const std::shared_ptr<Material> mat = {});
 	void initialize(VkPhysicalDevice physicalDevice, VkDevice device, const VkCommandPool& commandPool, const VkQueue& graphicsQueue);
 	void destroyMesh(const VkDevice& device);
 
@@ -28,16 +33,40 @@ public:
 	VkDeviceSize getVBOffset() const { return 0; } // if DataBuffer tracks offsets, return it here
 	VkDeviceSize getIBOffset() const { return 0; }
 
-	uint32_t getIndexCount() const { return static_cast<uint32_t>(m_Indices.size()); }
+	uint32_t getIndexCount() const { return isInitialized() ? m_IndexCount : static_cast<uint32_t>(cpuIndices().size()); }
+
+	// UINT16 when every index fits (<= 65535 vertices), halves IB size and index fetch bandwidth
+	VkIndexType getIndexType() const { return m_IndexType; }
+	static VkIndexType ChooseIndexType(size_t vertexCount) {
+		return vertexCount <= 0xFFFFu ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+	}
+
+	// Cluster culling data (only built for large meshes, see ObjUtils::kMeshletMinTriangles)
+	bool hasMeshlets() const { return m_MeshletCount > 0 && m_MeshletBuffer; }
+	uint32_t getMeshletCount() const { return m_MeshletCount; }
+	VkBuffer getMeshletBuffer() const { return m_MeshletBuffer ? m_MeshletBuffer->getVkBuffer() : VK_NULL_HANDLE; }
+
+	// Object-space AABB, computed once at construction
+	const glm::vec3& getLocalMin() const { return m_LocalMin; }
+	const glm::vec3& getLocalMax() const { return m_LocalMax; }
 
 	const std::shared_ptr<Material>& getMaterial() const { return m_Material; }
 
 	bool isInitialized() const { return m_VertexBuffer && m_IndexBuffer; }
 
-	// Optional (handy later):
-	const std::vector<Vertex>& cpuVertices() const { return m_Vertices; }
-	const std::vector<uint32_t>& cpuIndices() const { return m_Indices; }
-	void draw(VkPipelineLayout pipelineLayout, VkCommandBuffer commandBuffer);
+	// CPU residency: after initialize() the CPU copy is released unless the mesh is flagged for
+	// CPU access (picking, physics cooking, ...). Flag it before the first upload.
+	void setKeepCpuData(bool keep) { m_KeepCpuData = keep; }
+	bool keepsCpuData() const { return m_KeepCpuData; }
+	bool hasCpuData() const { return !cpuVertices().empty(); }
+	ArrayView<Vertex> cpuVertices() const { return m_Blob ? m_Blob->vertexData() : ArrayView<Vertex>(m_Vertices); }
+	ArrayView<uint32_t> cpuIndices() const { return m_Blob ? m_Blob->indexData() : ArrayView<uint32_t>(m_Indices); }
+
+	// Memory accounting (bytes); a shared blob is counted in full by every mesh holding it
+	size_t cpuBytes() const;
+	size_t gpuBytes() const;
+	// pushRange: the bound pipeline's push constant range (Pipeline::getPushConstantRange)
+	void draw(VkPipelineLayout pipelineLayout, const VkPushConstantRange& pushRange, VkCommandBuffer commandBuffer);
 
 	const glm::mat4& getModelMatrix() const { return m_VertexConstant.model; }
 
@@ -45,13 +74,26 @@ public:
 private:
 	std::vector<Vertex> m_Vertices;
 	std::vector<uint32_t> m_Indices;
+	MeshBlobPtr m_Blob; // when set, the geometry lives here and m_Vertices/m_Indices stay empty
 	std::unique_ptr<DataBuffer> m_VertexBuffer;
 	std::unique_ptr<DataBuffer> m_IndexBuffer;
+	VkIndexType m_IndexType = VK_INDEX_TYPE_UINT32;
+	uint32_t m_IndexCount = 0;
+	std::vector<ObjUtils::Meshlet> m_Meshlets;
+	uint32_t m_MeshletCount = 0;
+	std::unique_ptr<DataBuffer> m_MeshletBuffer;
+	bool m_KeepCpuData = false;
 
 	MeshData m_VertexConstant;
 
 	glm::vec3 m_Position = {};
+	glm::vec3 m_LocalMin = {};
+	glm::vec3 m_LocalMax = {};
 	std::shared_ptr<Material> m_Material;
 	void CreateVertexBuffer(VkPhysicalDevice physicalDevice, VkDevice device, const VkCommandPool& commandPool, const VkQueue& graphicsQueue);
 	void CreateIndexBuffer(VkPhysicalDevice physicalDevice, VkDevice device, const VkCommandPool& commandPool, const VkQueue& graphicsQueue);
+	void CreateMeshletBuffer(VkPhysicalDevice physicalDevice, VkDevice device, const VkCommandPool& commandPool, const VkQueue& graphicsQueue);
+	void ReleaseCpuData();
+	void InitFromGeometry();
+	void DetachBlob();
 }; 
\ No newline at end of file
@@ -0,0 +1,38 @@
+// Engine/Graphics/MeshBlob.h
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <Engine/Graphics/Vertex.h>
+#include <Engine/Core/ArrayView.h>
+#include <Engine/Core/MappedFile.h>
+
+// Immutable imported geometry. Handed around as shared_ptr<const MeshBlob> so the ParseOBJ
+// cache, MeshManager and Mesh can all reference one copy; nothing writes to it after import.
+struct MeshBlob {
+    std::vector<Vertex>   vertices;
+    std::vector<uint32_t> indices;
+    uint64_t              contentHash = 0; // Hash::Geometry(vertices, indices)
+    // Precomputed position bounds (cooked assets); otherwise Mesh derives them from the vertices
+    bool                  hasBounds = false;
+    glm::vec3             boundsMin{ 0.f };
+    glm::vec3             boundsMax{ 0.f };
+
+    // Read in place: a view that is set points into 'mapping' (a mesh cache file, or the .glb a
+    // primitive was decoded from) and its vector stays empty. Each array is mapped or not on its
+    // own, so read the geometry through vertexData()/indexData(), which cover both cases.
+    std::shared_ptr<const void> mapping;
+    ArrayView<Vertex>     mappedVertices;
+    ArrayView<uint32_t>   mappedIndices;
+
+    ArrayView<Vertex> vertexData() const { return mappedVertices.data() ? mappedVertices : ArrayView<Vertex>(vertices); }
+    ArrayView<uint32_t> indexData() const { return mappedIndices.data() ? mappedIndices : ArrayView<uint32_t>(indices); }
+
+    // Heap bytes plus the mapped views (file backed, the OS pages them in and out)
+    size_t bytes() const {
+        return vertices.capacity() * sizeof(Vertex) + indices.capacity() * sizeof(uint32_t)
+            + mappedVertices.size() * sizeof(Vertex) + mappedIndices.size() * sizeof(uint32_t);
+    }
+};
+
+using MeshBlobPtr = std::shared_ptr<const MeshBlob>;
@@ -1,41 +1,79 @@
 // MeshManager.cpp
 #include "MeshManager.h"
+#include <Engine/Core/Hash.h>
+#include <Engine/ObjUtils/ObjUtils.h>
+#include <algorithm>
+#include <unordered_set>
 
-static constexpr uint64_t FNV1A64_OFFSET = 1469598103934665603ull;
-static constexpr uint64_t FNV1A64_PRIME = 1099511628211ull;
-
-void MeshManager::Fnv1aAppend(uint64_t& h, const void* data, size_t nbytes) {
-    const uint8_t* p = static_cast<const uint8_t*>(data);
-    for (size_t i = 0; i < nbytes; ++i) { h ^= p[i]; h *= FNV1A64_PRIME; }
-}
+// Vertex is tightly packed floats, so the array can be hashed as one block
+static_assert(sizeof(Vertex) == sizeof(float) * 11, "Vertex has padding; HashGeometry would hash garbage");
 
 uint64_t MeshManager::HashGeometry(const std::vector<Vertex>& v,
     const std::vector<uint32_t>& idx) {
-    uint64_t h = FNV1A64_OFFSET;
-    for (const Vertex& vert : v) {
-        Fnv1aAppend(h, &vert.pos, sizeof(vert.pos));
-        Fnv1aAppend(h, &vert.normal, sizeof(vert.normal));
-        Fnv1aAppend(h, &vert.color, sizeof(vert.color));
-        Fnv1aAppend(h, &vert.texCoord, sizeof(vert.texCoord));
-    }
-    if (!idx.empty()) Fnv1aAppend(h, idx.data(), idx.size() * sizeof(uint32_t));
-    return h;
+    return Hash::Geometry(v, idx);
 }
 
 std::shared_ptr<Mesh> MeshManager::GetOrCreate(const std::vector<Vertex>& vertices,
     const std::vector<uint32_t>& indices,
     const std::shared_ptr<Material>& mat)
 {
-    const uint64_t key = HashGeometry(vertices, indices);
+    return GetOrCreate(HashGeometry(vertices, indices), vertices, indices, mat);
+}
+
+std::shared_ptr<Mesh> MeshManager::GetOrCreate(uint64_t contentHash,
+    const std::vector<Vertex>& vertices,
+    const std::vector<uint32_t>& indices,
+    const std::shared_ptr<Material>& mat)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (auto existing = FindContentLocked(contentHash, mat)) return existing;
+    return InsertLocked(contentHash, std::make_shared<Mesh>(vertices, indices, mat));
+}
+
+std::shared_ptr<Mesh> MeshManager::FindContentLocked(uint64_t contentHash, const std::shared_ptr<Material>& mat)
+{
+    auto it = cache_.find(contentHash);
+    if (it == cache_.end()) return nullptr;
+
+    auto existing = it->second.lock();
+    if (existing && mat) existing->setMaterial(mat);  // optional: keep legacy path happy
+    return existing;
+}
+
+std::shared_ptr<Mesh> MeshManager::InsertLocked(uint64_t contentHash, std::shared_ptr<Mesh> mesh)
+{
+    cache_[contentHash] = mesh;
+
+    if (cache_.size() + assets_.size() >= purgeAt_) PurgeExpiredLocked();
+    return mesh;
+}
+
+std::shared_ptr<Mesh> MeshManager::FindAsset(uint64_t assetId) {
     std::lock_guard<std::mutex> lock(mtx_);
+    auto it = assets_.find(assetId);
+    return it != assets_.end() ? it->second.lock() : nullptr;
+}
+
+std::shared_ptr<Mesh> MeshManager::GetOrCreateAsset(uint64_t assetId, MeshBlobPtr blob,
+    const std::shared_ptr<Material>& mat)
+{
+    if (!blob) return nullptr;
 
-    if (auto existing = cache_[key].lock()) {
-        if (mat) existing->setMaterial(mat);  // optional: keep legacy path happy
-        return existing;
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    auto it = assets_.find(assetId);
+    if (it != assets_.end()) {
+        if (auto existing = it->second.lock()) {
+            if (mat) existing->setMaterial(mat);
+            return existing;
+        }
     }
 
-    auto mesh = std::make_shared<Mesh>(vertices, indices, mat);
-    cache_[key] = mesh;
+    // Different assets with identical content still share one mesh
+    const uint64_t contentHash = blob->contentHash;
+    auto mesh = FindContentLocked(contentHash, mat);
+    if (!mesh) mesh = InsertLocked(contentHash, std::make_shared<Mesh>(std::move(blob), mat));
+    assets_[assetId] = mesh;
     return mesh;
 }
 
@@ -50,13 +88,118 @@ std::shared_ptr<Mesh> MeshManager::GetUnitQuad() {
     };
     std::vector<uint32_t> idx = { 0,1,2, 0,2,3 };
 
-    auto quad = std::make_shared<Mesh>(v, idx, nullptr);
+    auto quad = std::make_shared<Mesh>(std::move(v), std::move(idx), nullptr);
     unitQuad_ = quad;
     return quad;
 }
 
+std::shared_ptr<Mesh> MeshManager::GetUnitCube() {
+    if (auto c = unitCube_.lock()) return c;
+
+    std::vector<Vertex> v;
+    std::vector<uint32_t> idx;
+    v.reserve(24);
+    idx.reserve(36);
+    // one quad per face: n = face normal, (t, b) span the face so that t x b = n (CCW from outside)
+    auto face = [&](glm::vec3 n, glm::vec3 t, glm::vec3 b) {
+        const uint32_t base = static_cast<uint32_t>(v.size());
+        const glm::vec3 c = 0.5f * n;
+        v.push_back({ c - 0.5f * t - 0.5f * b, n, {1,1,1}, {0,0} });
+        v.push_back({ c + 0.5f * t - 0.5f * b, n, {1,1,1}, {1,0} });
+        v.push_back({ c + 0.5f * t + 0.5f * b, n, {1,1,1}, {1,1} });
+        v.push_back({ c - 0.5f * t + 0.5f * b, n, {1,1,1}, {0,1} });
+        idx.insert(idx.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+        };
+    face({ 0, 0, 1 }, { 1, 0, 0 }, { 0, 1, 0 });
+    face({ 0, 0,-1 }, {-1, 0, 0 }, { 0, 1, 0 });
+    face({ 1, 0, 0 }, { 0, 0,-1 }, { 0, 1, 0 });
+    face({-1, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 });
+    face({ 0, 1, 0 }, { 1, 0, 0 }, { 0, 0,-1 });
+    face({ 0,-1, 0 }, { 1, 0, 0 }, { 0, 0, 1 });
+
+    auto cube = std::make_shared<Mesh>(std::move(v), std::move(idx), nullptr);
+    unitCube_ = cube;
+    return cube;
+}
+
+std::shared_ptr<Mesh> MeshManager::GetUnitGrid(uint32_t cells) {
+    cells = std::max(cells, 1u);
+    std::lock_guard<std::mutex> lock(mtx_);   // GetMemoryStats walks unitGrids_
+    if (auto g = unitGrids_[cells].lock()) return g;
+
+    // Same extent, normal and UVs as the unit quad, only tessellated
+    const uint32_t side = cells + 1;
+    std::vector<Vertex> v;
+    std::vector<uint32_t> idx;
+    v.reserve(size_t(side) * side);
+    idx.reserve(size_t(cells) * cells * 6);
+    for (uint32_t y = 0; y < side; ++y) {
+        for (uint32_t x = 0; x < side; ++x) {
+            const glm::vec2 uv(float(x) / cells, float(y) / cells);
+            v.push_back({ { uv.x - 0.5f, uv.y - 0.5f, 0.f }, { 0,0,1 }, { 1,1,1 }, uv });
+        }
+    }
+    for (uint32_t y = 0; y < cells; ++y) {
+        for (uint32_t x = 0; x < cells; ++x) {
+            const uint32_t a = y * side + x;
+            idx.insert(idx.end(), { a, a + 1, a + side + 1, a, a + side + 1, a + side });
+        }
+    }
+
+    auto grid = std::make_shared<Mesh>(std::move(v), std::move(idx), nullptr);
+    unitGrids_[cells] = grid;
+    return grid;
+}
+
+void MeshManager::PurgeExpired() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    PurgeExpiredLocked();
+}
+
+void MeshManager::PurgeExpiredLocked() {
+    auto purge = [](std::unordered_map<uint64_t, std::weak_ptr<Mesh>>& map) {
+        for (auto it = map.begin(); it != map.end();) {
+            if (it->second.expired()) it = map.erase(it);
+            else ++it;
+        }
+        };
+    purge(cache_);
+    purge(assets_);
+
+    // amortized: next purge once the live set has doubled
+    purgeAt_ = std::max<size_t>(64, 2 * (cache_.size() + assets_.size()));
+}
+
+MeshManager::MemoryStats MeshManager::GetMemoryStats() {
+    MemoryStats stats{};
+    std::unordered_set<const Mesh*> seen;
+    auto account = [&](const std::shared_ptr<Mesh>& m) {
+        if (!m || !seen.insert(m.get()).second) return;
+        ++stats.meshCount;
+        if (m->hasCpuData()) ++stats.cpuResidentMeshes;
+        stats.meshCpuBytes += m->cpuBytes();
+        stats.meshGpuBytes += m->gpuBytes();
+        };
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (auto& [key, weak] : cache_) account(weak.lock());
+        for (auto& [key, weak] : assets_) account(weak.lock());
+        account(unitQuad_.lock());
+        account(unitCube_.lock());
+        for (auto& [cells, weak] : unitGrids_) account(weak.lock());
+    }
+
+    stats.parseCacheBytes = ObjUtils::ParseCacheBytes();
+    return stats;
+}
+
 void MeshManager::Clear() {
     std::lock_guard<std::mutex> lock(mtx_);
     cache_.clear();
+    assets_.clear();
+    purgeAt_ = 64;
     unitQuad_.reset();
+    unitCube_.reset();
+    unitGrids_.clear();
 }
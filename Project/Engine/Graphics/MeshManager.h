@@ -7,6 +7,7 @@
 #include <cstdint>
 
 #include <Engine/Graphics/Mesh.h>
+#include <Engine/Graphics/MeshBlob.h>
 #include <Engine/Graphics/Material.h>
 #include <Engine/Graphics/Vertex.h>  // your Vertex
 #include <Engine/Core/Singleton.h>  // your Singleton<T>
@@ -14,12 +15,47 @@
 class MeshManager : public Singleton<MeshManager> {
 public:
     // Deduplicate by CPU geometry content (material is NOT part of the key).
+    // Hashes the whole geometry; importers should hash once and use the overloads below.
     std::shared_ptr<Mesh> GetOrCreate(const std::vector<Vertex>& vertices,
         const std::vector<uint32_t>& indices,
         const std::shared_ptr<Material>& mat = {});
 
+    // Same, with a content hash the caller already computed (see HashGeometry)
+    std::shared_ptr<Mesh> GetOrCreate(uint64_t contentHash,
+        const std::vector<Vertex>& vertices,
+        const std::vector<uint32_t>& indices,
+        const std::shared_ptr<Material>& mat = {});
+
+    // Asset registry: assetId identifies the source (path + import flags), so repeated
+    // spawns of the same file never touch or hash the geometry again.
+    std::shared_ptr<Mesh> FindAsset(uint64_t assetId);
+    // The new mesh references 'blob' (keyed by blob->contentHash), so no geometry is copied.
+    std::shared_ptr<Mesh> GetOrCreateAsset(uint64_t assetId, MeshBlobPtr blob,
+        const std::shared_ptr<Material>& mat = {});
+
     // Canonical unit quad (for rectangles/planes)
     std::shared_ptr<Mesh> GetUnitQuad();
+    // Canonical unit cube (stand-in while a model loads asynchronously)
+    std::shared_ptr<Mesh> GetUnitCube();
+    // Unit quad split into cells x cells quads, for planes large enough to be worth meshlet culling
+    std::shared_ptr<Mesh> GetUnitGrid(uint32_t cells);
+
+    // 64-bit content hash (XXH64) over the raw vertex and index data
+    static uint64_t HashGeometry(const std::vector<Vertex>& v,
+        const std::vector<uint32_t>& idx);
+
+    // Drop entries whose meshes have been released
+    void PurgeExpired();
+
+    // Where geometry currently lives (live meshes only, shared meshes counted once)
+    struct MemoryStats {
+        size_t meshCount = 0;
+        size_t cpuResidentMeshes = 0;  // meshes still holding their CPU copy
+        size_t meshCpuBytes = 0;       // may overlap parseCacheBytes (shared blobs)
+        size_t meshGpuBytes = 0;
+        size_t parseCacheBytes = 0;    // ObjUtils::ParseOBJ cache
+    };
+    MemoryStats GetMemoryStats();
 
     void Clear();
 
@@ -27,13 +63,18 @@ private:
     friend class Singleton<MeshManager>;
     MeshManager() = default;
 
-    // --- hashing helpers (FNV-1a 64) ---
-    static uint64_t HashGeometry(const std::vector<Vertex>& v,
-        const std::vector<uint32_t>& idx);
-    static inline void Fnv1aAppend(uint64_t& h, const void* data, size_t nbytes);
+    std::shared_ptr<Mesh> FindContentLocked(uint64_t contentHash, const std::shared_ptr<Material>& mat);
+    std::shared_ptr<Mesh> InsertLocked(uint64_t contentHash, std::shared_ptr<Mesh> mesh);
+    void PurgeExpiredLocked();
 
     std::mutex mtx_;
     // Cache geometry by hash; weak_ptr lets meshes free when unused
     std::unordered_map<uint64_t, std::weak_ptr<Mesh>> cache_;
+    // assetId -> mesh, same lifetime rules as cache_
+    std::unordered_map<uint64_t, std::weak_ptr<Mesh>> assets_;
+    // cache_ + assets_ size at which the next purge runs
+    size_t purgeAt_ = 64;
     std::weak_ptr<Mesh> unitQuad_;
+    std::weak_ptr<Mesh> unitCube_;
+    std::unordered_map<uint32_t, std::weak_ptr<Mesh>> unitGrids_;
 };
@@ -0,0 +1,308 @@
+#include "MeshletCuller.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <Engine/Scene/GameObjects/BaseObject.h>
+#include <Engine/Core/AssetArchive.h>
+#include <Engine/Graphics/PipelineCache.h>
+
+// Jobs of meshes nothing has drawn for this many frames give their buffers back
+static constexpr uint64_t kJobIdleFrames = 300;
+
+static std::vector<char> readSpirv(const std::string& filename) {
+    const AssetData file = AssetArchive::Open(filename);
+    if (!file) {
+        throw std::runtime_error("failed to open file: " + filename);
+    }
+    return std::vector<char>(file.data, file.data + file.size);
+}
+
+// Frustum planes (inside: dot(plane, p) >= 0) for a [0,1] depth range clip space
+static void extractFrustumPlanes(const glm::mat4& m, glm::vec4 planes[6]) {
+    const glm::vec4 r0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    const glm::vec4 r1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    const glm::vec4 r2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    const glm::vec4 r3(m[0][3], m[1][3], m[2][3], m[3][3]);
+    planes[0] = r3 + r0; // left
+    planes[1] = r3 - r0; // right
+    planes[2] = r3 + r1; // bottom
+    planes[3] = r3 - r1; // top
+    planes[4] = r2;      // near
+    planes[5] = r3 - r2; // far
+}
+
+void MeshletCuller::createPipeline(VkDevice device) {
+    VkDescriptorSetLayoutBinding bindings[5]{};
+    for (uint32_t i = 0; i < 5; ++i) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo li{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    li.bindingCount = 5;
+    li.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(device, &li, nullptr, &m_setLayout) != VK_SUCCESS) {
+        throw std::runtime_error("MeshletCuller: failed to create descriptor set layout!");
+    }
+
+    VkPushConstantRange pcr{};
+    pcr.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pcr.offset = 0;
+    pcr.size = sizeof(CullPush);
+
+    VkPipelineLayoutCreateInfo pli{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    pli.setLayoutCount = 1;
+    pli.pSetLayouts = &m_setLayout;
+    pli.pushConstantRangeCount = 1;
+    pli.pPushConstantRanges = &pcr;
+    if (vkCreatePipelineLayout(device, &pli, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("MeshletCuller: failed to create pipeline layout!");
+    }
+
+    const std::vector<char> code = readSpirv("shaders/meshletCull.comp.spv");
+    VkShaderModuleCreateInfo smi{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    smi.codeSize = code.size();
+    smi.pCode = reinterpret_cast<const uint32_t*>(code.data());
+    VkShaderModule module = VK_NULL_HANDLE;
+    if (vkCreateShaderModule(device, &smi, nullptr, &module) != VK_SUCCESS) {
+        throw std::runtime_error("MeshletCuller: failed to create shader module!");
+    }
+
+    VkComputePipelineCreateInfo ci{ VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    ci.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    ci.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    ci.stage.module = module;
+    ci.stage.pName = "main";
+    ci.layout = m_pipelineLayout;
+    VkResult r = vkCreateComputePipelines(device, PipelineCache::GetInstance().get(), 1, &ci, nullptr, &m_pipeline);
+    vkDestroyShaderModule(device, module, nullptr);
+    if (r != VK_SUCCESS) throw std::runtime_error("MeshletCuller: failed to create compute pipeline!");
+}
+
+MeshletCuller::Job& MeshletCuller::getOrCreateJob(const std::shared_ptr<Mesh>& mesh) {
+    auto it = m_jobs.find(mesh.get());
+    if (it != m_jobs.end()) {
+        if (!it->second.mesh.expired()) return it->second;
+        // A new mesh at the address of a released one: its job refers to the old buffers
+        m_retired.emplace_back(vulkanVars::GetInstance().frameIndex, std::move(it->second));
+        m_jobs.erase(it);
+    }
+
+    auto& vk = vulkanVars::GetInstance();
+    Job& job = m_jobs[mesh.get()];
+    job.mesh = mesh;
+
+    VkDescriptorPoolSize ps{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 5 * MAX_FRAMES_IN_FLIGHT };
+    VkDescriptorPoolCreateInfo pi{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    pi.maxSets = MAX_FRAMES_IN_FLIGHT;
+    pi.poolSizeCount = 1;
+    pi.pPoolSizes = &ps;
+    if (vkCreateDescriptorPool(vk.device, &pi, nullptr, &job.pool) != VK_SUCCESS) {
+        throw std::runtime_error("MeshletCuller: failed to create descriptor pool!");
+    }
+
+    // Worst case every meshlet survives; shared by all instances, so one mesh worth of indices
+    const VkDeviceSize indexBytes = sizeof(uint32_t) * std::max<uint32_t>(mesh->getIndexCount(), 1u);
+
+    for (auto& slot : job.frames) {
+        slot.indices = std::make_unique<DataBuffer>(vk.physicalDevice, vk.device,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            indexBytes);
+        slot.drawCmd = std::make_unique<DataBuffer>(vk.physicalDevice, vk.device,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            sizeof(VkDrawIndexedIndirectCommand));
+        slot.instances = std::make_unique<DataBuffer>(vk.physicalDevice, vk.device,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            sizeof(InstanceCull) * 16);
+
+        VkDescriptorSetAllocateInfo ai{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+        ai.descriptorPool = job.pool;
+        ai.descriptorSetCount = 1;
+        ai.pSetLayouts = &m_setLayout;
+        if (vkAllocateDescriptorSets(vk.device, &ai, &slot.set) != VK_SUCCESS) {
+            throw std::runtime_error("MeshletCuller: failed to allocate descriptor set!");
+        }
+
+        VkDescriptorBufferInfo infos[4]{};
+        infos[0] = { mesh->getMeshletBuffer(), 0, VK_WHOLE_SIZE };
+        infos[1] = { mesh->getIndexBuffer(), 0, VK_WHOLE_SIZE };
+        infos[2] = { slot.indices->getVkBuffer(), 0, VK_WHOLE_SIZE };
+        infos[3] = { slot.drawCmd->getVkBuffer(), 0, VK_WHOLE_SIZE };
+
+        VkWriteDescriptorSet writes[4]{};
+        for (uint32_t i = 0; i < 4; ++i) {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = slot.set;
+            writes[i].dstBinding = i;
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].pBufferInfo = &infos[i];
+        }
+        vkUpdateDescriptorSets(vk.device, 4, writes, 0, nullptr);
+        writeInstanceBinding(slot);
+    }
+    return job;
+}
+
+void MeshletCuller::writeInstanceBinding(FrameSlot& slot) {
+    VkDescriptorBufferInfo info{ slot.instances->getVkBuffer(), 0, VK_WHOLE_SIZE };
+    VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    write.dstSet = slot.set;
+    write.dstBinding = 4;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &info;
+    vkUpdateDescriptorSets(vulkanVars::GetInstance().device, 1, &write, 0, nullptr);
+}
+
+void MeshletCuller::retireUnusedJobs(uint64_t frame) {
+    auto& vk = vulkanVars::GetInstance();
+
+    // Retired jobs are free once every frame that could still read them has finished
+    for (size_t i = 0; i < m_retired.size();) {
+        if (frame >= m_retired[i].first + MAX_FRAMES_IN_FLIGHT) {
+            destroyJob(vk.device, m_retired[i].second);
+            m_retired[i] = std::move(m_retired.back());
+            m_retired.pop_back();
+        }
+        else ++i;
+    }
+
+    for (auto it = m_jobs.begin(); it != m_jobs.end();) {
+        if (it->second.mesh.expired() || frame > it->second.lastUsedFrame + kJobIdleFrames) {
+            m_retired.emplace_back(frame, std::move(it->second));
+            it = m_jobs.erase(it);
+        }
+        else ++it;
+    }
+}
+
+void MeshletCuller::destroyJob(VkDevice device, Job& job) {
+    for (auto& slot : job.frames) {
+        if (slot.indices) slot.indices->destroy(device);
+        if (slot.drawCmd) slot.drawCmd->destroy(device);
+        if (slot.instances) slot.instances->destroy(device);
+    }
+    if (job.pool) vkDestroyDescriptorPool(device, job.pool, nullptr);
+    job.pool = VK_NULL_HANDLE;
+}
+
+void MeshletCuller::record(VkCommandBuffer cmd, const std::vector<const BaseObject*>& objects,
+    const glm::mat4& viewProj, const glm::vec3& cameraPos)
+{
+    auto& vk = vulkanVars::GetInstance();
+    const size_t frame = vk.currentFrame % MAX_FRAMES_IN_FLIGHT;
+
+    m_frameArgs.clear();
+    m_recordedFrame = vk.frameIndex;
+    retireUnusedJobs(vk.frameIndex);
+    if (objects.empty()) return;
+
+    if (m_pipeline == VK_NULL_HANDLE) createPipeline(vk.device);
+
+    // 1) group the instances by mesh, culling data in each instance's object space
+    glm::vec4 worldPlanes[6];
+    extractFrustumPlanes(viewProj, worldPlanes);
+
+    struct Group {
+        const std::shared_ptr<Mesh>* mesh = nullptr;
+        std::vector<InstanceCull> instances;
+    };
+    std::unordered_map<const Mesh*, Group> groups;
+    for (const BaseObject* obj : objects) {
+        if (!obj || !obj->rawMesh() || !obj->rawMesh()->hasMeshlets()) continue;
+        Group& g = groups[obj->rawMesh()];
+        g.mesh = &obj->getMesh();
+
+        const glm::mat4 model = obj->getModelMatrix();
+        const glm::mat4 modelT = glm::transpose(model);
+        InstanceCull& ic = g.instances.emplace_back();
+        for (int i = 0; i < 6; ++i) ic.planes[i] = modelT * worldPlanes[i];
+        ic.cameraPos = glm::inverse(model) * glm::vec4(cameraPos, 1.0f);
+    }
+    if (groups.empty()) return;
+
+    // 2) upload the instances and reset the indirect commands: indexCount = 0, all instances
+    std::vector<std::pair<Job*, const Group*>> jobs;
+    jobs.reserve(groups.size());
+    for (const auto& [raw, g] : groups) {
+        Job& job = getOrCreateJob(*g.mesh);
+        job.lastUsedFrame = vk.frameIndex;
+        jobs.emplace_back(&job, &g);
+
+        FrameSlot& slot = job.frames[frame];
+        const VkDeviceSize bytes = sizeof(InstanceCull) * g.instances.size();
+        if (slot.instances->getSizeInBytes() < bytes) {
+            // This slot's last use was MAX_FRAMES_IN_FLIGHT frames ago, so it can go right away
+            slot.instances->destroy(vk.device);
+            slot.instances = std::make_unique<DataBuffer>(vk.physicalDevice, vk.device,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                bytes * 2);
+            writeInstanceBinding(slot);
+        }
+        slot.instances->upload(bytes, g.instances.data());
+
+        const VkDrawIndexedIndirectCommand reset{ 0, static_cast<uint32_t>(g.instances.size()), 0, 0, 0 };
+        vkCmdUpdateBuffer(cmd, slot.drawCmd->getVkBuffer(), 0, sizeof(reset), &reset);
+    }
+
+    VkMemoryBarrier toCompute{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    toCompute.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toCompute.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &toCompute, 0, nullptr, 0, nullptr);
+
+    // 3) one dispatch per mesh, each meshlet tested against all its instances
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+    for (auto& [job, g] : jobs) {
+        const Mesh* mesh = g->mesh->get();
+
+        CullPush pc{};
+        pc.meshletCount = mesh->getMeshletCount();
+        pc.instanceCount = static_cast<uint32_t>(g->instances.size());
+        pc.flags = (mesh->getIndexType() == VK_INDEX_TYPE_UINT16 ? 1u : 0u) | 2u;
+
+        FrameSlot& slot = job->frames[frame];
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &slot.set, 0, nullptr);
+        vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pc), &pc);
+        vkCmdDispatch(cmd, (pc.meshletCount + 63) / 64, 1, 1);
+
+        m_frameArgs[mesh] = DrawArgs{ slot.indices->getVkBuffer(), slot.drawCmd->getVkBuffer(), pc.instanceCount };
+    }
+
+    // 4) results feed the index fetch and the indirect draw
+    VkMemoryBarrier toDraw{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    toDraw.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    toDraw.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+        0, 1, &toDraw, 0, nullptr, 0, nullptr);
+}
+
+const MeshletCuller::DrawArgs* MeshletCuller::getDrawArgs(const Mesh* mesh) const {
+    // Results are only valid for the frame they were recorded in
+    if (m_recordedFrame != vulkanVars::GetInstance().frameIndex) return nullptr;
+    auto it = m_frameArgs.find(mesh);
+    return it != m_frameArgs.end() ? &it->second : nullptr;
+}
+
+void MeshletCuller::destroy(VkDevice device) {
+    for (auto& [mesh, job] : m_jobs) destroyJob(device, job);
+    for (auto& [frame, job] : m_retired) destroyJob(device, job);
+    m_jobs.clear();
+    m_retired.clear();
+    m_frameArgs.clear();
+
+    if (m_pipeline) vkDestroyPipeline(device, m_pipeline, nullptr);
+    if (m_pipelineLayout) vkDestroyPipelineLayout(device, m_pipelineLayout, nullptr);
+    if (m_setLayout) vkDestroyDescriptorSetLayout(device, m_setLayout, nullptr);
+    m_pipeline = VK_NULL_HANDLE;
+    m_pipelineLayout = VK_NULL_HANDLE;
+    m_setLayout = VK_NULL_HANDLE;
+}
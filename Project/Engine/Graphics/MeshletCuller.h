@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <Engine/Graphics/DataBuffer.h>
+#include <Engine/Graphics/vulkanVars.h>
+
+class BaseObject;
+class Mesh;
+
+// GPU cluster culling for meshes that carry meshlets (see ObjUtils/Meshlets.h).
+// Per mesh and frame-in-flight a compute pass tests every meshlet against the frustum and normal
+// cone of each visible instance of that mesh. A meshlet any instance can see is appended once to a
+// compacted index buffer, and MeshScene draws all instances over it with one
+// vkCmdDrawIndexedIndirect (instanceCount = number of instances culled).
+class MeshletCuller {
+public:
+    struct DrawArgs {
+        VkBuffer indexBuffer = VK_NULL_HANDLE;    // compacted, always VK_INDEX_TYPE_UINT32
+        VkBuffer indirectBuffer = VK_NULL_HANDLE; // one VkDrawIndexedIndirectCommand
+        uint32_t instanceCount = 0;               // instances the command draws
+    };
+
+    // Must be recorded outside a render pass, before the pass that draws 'objects'.
+    // Also retires the buffers of meshes that were released or haven't been visible for a while.
+    void record(VkCommandBuffer cmd, const std::vector<const BaseObject*>& objects,
+        const glm::mat4& viewProj, const glm::vec3& cameraPos);
+
+    // Culled draw for 'mesh' if it was recorded this frame, nullptr otherwise (draw the full mesh).
+    const DrawArgs* getDrawArgs(const Mesh* mesh) const;
+
+    void destroy(VkDevice device);
+
+private:
+    // Matches 'InstanceCull' in shaders/meshletCull.comp (std430)
+    struct InstanceCull {
+        glm::vec4 planes[6];   // object space
+        glm::vec4 cameraPos;   // object space, xyz
+    };
+
+    struct FrameSlot {
+        std::unique_ptr<DataBuffer> indices;
+        std::unique_ptr<DataBuffer> drawCmd;
+        std::unique_ptr<DataBuffer> instances;  // InstanceCull per instance, host-visible, grows
+        VkDescriptorSet set = VK_NULL_HANDLE;
+    };
+    struct Job {
+        std::weak_ptr<const Mesh> mesh;          // expired: the mesh is gone, so is the job
+        std::array<FrameSlot, MAX_FRAMES_IN_FLIGHT> frames;
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        uint64_t lastUsedFrame = 0;
+    };
+
+    // Matches the push constant block of shaders/meshletCull.comp
+    struct CullPush {
+        uint32_t meshletCount;
+        uint32_t instanceCount;
+        uint32_t flags;
+        uint32_t pad;
+    };
+
+    void createPipeline(VkDevice device);
+    Job& getOrCreateJob(const std::shared_ptr<Mesh>& mesh);
+    void writeInstanceBinding(FrameSlot& slot);
+    void retireUnusedJobs(uint64_t frame);
+    static void destroyJob(VkDevice device, Job& job);
+
+    std::unordered_map<const Mesh*, Job> m_jobs;
+    std::vector<std::pair<uint64_t, Job>> m_retired;   // frame they were retired in, job
+    std::unordered_map<const Mesh*, DrawArgs> m_frameArgs;
+    uint64_t m_recordedFrame = UINT64_MAX;   // vulkanVars::frameIndex
+
+    VkDescriptorSetLayout m_setLayout = VK_NULL_HANDLE;
+    VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline m_pipeline = VK_NULL_HANDLE;
+};
@@ -1,5 +1,6 @@
 #include "ParticleGroup.h"
 #include <Engine/Graphics/vulkanVars.h>
+#include <algorithm>
 #include <Engine/Physics/PhysxBase.h>
 
 #include <glm/mat4x4.hpp>
@@ -70,7 +71,7 @@ void ParticleGroup::destroyParticleGroup(const VkDevice& device)
 }
 
 
-void ParticleGroup::draw(VkPipelineLayout pipelineLayout, VkCommandBuffer commandBuffer)
+void ParticleGroup::draw(VkPipelineLayout pipelineLayout, const VkPushConstantRange& pushRange, VkCommandBuffer commandBuffer)
 {
 
 	update();
@@ -78,14 +79,17 @@ void ParticleGroup::draw(VkPipelineLayout pipelineLayout, VkCommandBuffer comman
 
 	m_ParticleBuffers[vulkan_vars.currentFrame % MAX_FRAMES_IN_FLIGHT]->bindAsVertexBuffer(commandBuffer);
 
-	vkCmdPushConstants(
-		commandBuffer,
-		pipelineLayout,
-		VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-		0,                       
-		sizeof(m_VertexConstant),
-		&m_VertexConstant           
-	);
+	// The particle shader only reads the model matrix; push what the layout declares
+	if (pushRange.size > 0) {
+		vkCmdPushConstants(
+			commandBuffer,
+			pipelineLayout,
+			pushRange.stageFlags,
+			0,
+			std::min<uint32_t>(pushRange.size, sizeof(m_VertexConstant)),
+			&m_VertexConstant
+		);
+	}
 
 	vkCmdDraw(commandBuffer, m_ParticleCount, 1, 0, 0);
 }
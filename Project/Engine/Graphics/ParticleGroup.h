@@ -23,7 +23,7 @@ public:
 
 	void destroyParticleGroup(const VkDevice& device);
 
-	void draw(VkPipelineLayout pipelineLayout, VkCommandBuffer commandBuffer);
+	void draw(VkPipelineLayout pipelineLayout, const VkPushConstantRange& pushRange, VkCommandBuffer commandBuffer);
 private:
 
 	std::vector<Particle> m_Particles;
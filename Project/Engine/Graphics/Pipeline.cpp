@@ -6,17 +6,16 @@
 #include <chrono>
 #include <Engine/Graphics/vulkanVars.h>
 #include <Engine/Graphics/MeshData.h>
+#include <Engine/Graphics/PipelineCache.h>
+#include <Engine/Graphics/PipelineLayoutCache.h>
+#include <Engine/Graphics/FrameUniforms.h>
+#include <Engine/Core/AssetLoader.h>
 #include <iostream>
 
 
 
 Pipeline::Pipeline()
 {
-	m_Ubo = {};
-	m_Ubo.view = glm::mat4{ {1,0,0,0},{0,1,0,0},{0,0,1,0},{0,0,0,1} };
-	m_Ubo.proj = glm::mat4{ {1,0,0,0},{0,1,0,0},{0,0,1,0},{0,0,0,1} };
-	//m_Ubo.proj[1][1] *= -1;
-
 	m_DepthImage = VK_NULL_HANDLE;
 	m_DepthImageMemory = VK_NULL_HANDLE;
 	m_DepthImageView = VK_NULL_HANDLE;
@@ -32,9 +31,29 @@ Pipeline::~Pipeline()
 
 void Pipeline::Destroy(const VkDevice& vkDevice)
 {
+	// A worker may still be compiling
+	try {
+		waitUntilReady();
+	}
+	catch (const std::exception&) {
+	}
 	vkDestroyPipeline(vkDevice, m_Pipeline3d, nullptr);
+	vkDestroyPipeline(vkDevice, m_FallbackPipeline, nullptr);
+	for (auto& [flags, variant] : m_Variants) {
+		if (variant.build.valid()) {
+			try { variant.pipeline = variant.build.get(); }
+			catch (const std::exception&) {}
+		}
+		vkDestroyPipeline(vkDevice, variant.pipeline, nullptr);
+	}
+	m_Variants.clear();
+	if (m_State) {
+		for (const auto& stage : m_State->stages) vkDestroyShaderModule(vkDevice, stage.module, nullptr);
+		m_State.reset();
+	}
 
-	vkDestroyPipelineLayout(vkDevice, m_PipelineLayout, nullptr);
+	// The layout is shared through PipelineLayoutCache
+	m_PipelineLayout = VK_NULL_HANDLE;
 
 	m_Shader->Destroy(vkDevice);
 
@@ -54,17 +73,12 @@ void Pipeline::Initialize(const std::string& vertexShaderPath,
 	m_UseExternalDescriptors = (m_Config.externalSetLayout != VK_NULL_HANDLE &&
 		m_Config.externalSets != nullptr);
 
-	// Shader setup (unchanged)
-	m_Shader = std::make_unique<ShaderBase>(vertexShaderPath, fragmentShaderPath);
+	// Shader setup; it only creates descriptors of its own when we're NOT using external sets
+	m_Shader = std::make_unique<ShaderBase>(vertexShaderPath, fragmentShaderPath, m_Config.bindlessTextures, m_UseExternalDescriptors);
 	// You can still pass the mesh vertex layout even if we end up not using it (safe):
 	m_Shader->initialize(vulkan_vars.physicalDevice, vulkan_vars.device,
 		vkVertexInputBindingDesc, vkVertexInputAttributeDesc);
 
-	// Only create the default descriptor set layout when were NOT using external sets
-	if (!m_UseExternalDescriptors) {
-		m_Shader->createDescriptorSetLayout(vulkan_vars.device);
-	}
-
 	// Depth resources are only needed when depth is enabled (offscreen 3D)
 	if (m_Config.enableDepthTest || m_Config.enableDepthWrite) {
 		createDepthResources(vulkan_vars.physicalDevice, vulkan_vars.device, vulkan_vars.swapChainExtent);
@@ -89,7 +103,6 @@ void Pipeline::Initialize(const std::string& vertexShaderPath,
 	def.enableDepthTest = true;
 	def.enableDepthWrite = true;
 	def.useVertexInput = true;
-	def.usePushConstants = true;
 	def.fullscreenTriangle = false;
 
 	Initialize(vertexShaderPath, fragmentShaderPath, vkVertexInputBindingDesc,
@@ -118,8 +131,6 @@ void Pipeline::Record(uint32_t imageIndex, VkRenderPass renderPass, const std::v
 
 	drawScene(imageIndex, renderPass, swapChainFramebuffers, swapChainExtent, scene);
 
-
-	//updateUniformBuffer(imageIndex, swapChainExtent);
 }
 
 void Pipeline::Initialize(const std::string& vs, const std::string& fs, const std::vector<VkVertexInputBindingDescription>& bindings, std::vector<VkVertexInputAttributeDescription> attributes, const PipelineConfig& cfg)
@@ -128,9 +139,8 @@ void Pipeline::Initialize(const std::string& vs, const std::string& fs, const st
 	m_Config = cfg;
 	m_UseExternalDescriptors = (m_Config.externalSetLayout != VK_NULL_HANDLE && m_Config.externalSets != nullptr);
 
-	m_Shader = std::make_unique<ShaderBase>(vs, fs);
+	m_Shader = std::make_unique<ShaderBase>(vs, fs, m_Config.bindlessTextures, m_UseExternalDescriptors);
 	m_Shader->initialize(vk.physicalDevice, vk.device, bindings, attributes);
-	if (!m_UseExternalDescriptors) m_Shader->createDescriptorSetLayout(vk.device);
 	if (m_Config.enableDepthTest || m_Config.enableDepthWrite)
 		createDepthResources(vk.physicalDevice, vk.device, vk.swapChainExtent);
 	CreatePipeline(vk.device, (m_Config.renderPass ? m_Config.renderPass : vk.renderPass), m_Config.topology);
@@ -148,8 +158,11 @@ void Pipeline::drawScene(uint32_t imageIndex,
 	const uint32_t slice = static_cast<uint32_t>(vk.currentFrame % MAX_FRAMES_IN_FLIGHT);
 	VkCommandBuffer cmd = vk.commandBuffers[slice].m_VkCommandBuffer;
 
-	// Pipeline
-	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline3d);
+	// Pipeline; while it still compiles the fallback draws instead, or the pass is skipped
+	const VkPipeline pipeline = isReady() ? m_Pipeline3d : m_FallbackPipeline;
+	if (pipeline == VK_NULL_HANDLE) return;
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+	m_BoundPipeline = pipeline;
 
 	// Dynamic viewport/scissor
 	VkViewport viewport{};
@@ -168,7 +181,10 @@ void Pipeline::drawScene(uint32_t imageIndex,
 
 	// Descriptor set binding:
 	// - External sets (e.g., post-process sampling offscreen) are per swapchain image.
-	// - Our UBO-backed set is per frame-in-flight -> bind 'slice'.
+	// - Set 0 (frame constants) through this pipeline's layout (FrameUniforms::bind); the
+	//   previous pass may have bound it with a layout whose push constants differ.
+	// - Our own set 1 is per frame-in-flight -> bind 'slice', with this frame's copy of the
+	//   uniform block appended to the frame ring.
 	if (m_UseExternalDescriptors) {
 		const auto& sets = *m_Config.externalSets; // guaranteed non-null when m_UseExternalDescriptors == true
 		if (imageIndex < sets.size()) {
@@ -177,7 +193,15 @@ void Pipeline::drawScene(uint32_t imageIndex,
 		}
 	}
 	else {
-		m_Shader->bindDescriptorSet(cmd, m_PipelineLayout, slice);
+		FrameUniforms::GetInstance().bind(cmd, m_PipelineLayout);
+		if (m_Shader->getDescriptorSetLayout() != VK_NULL_HANDLE) {
+			uint32_t uniformOffset = 0;
+			if (const uint32_t blockSize = m_Shader->getUniformBlockSize()) {
+				m_UniformData.resize(blockSize, 0);
+				uniformOffset = FrameUniforms::GetInstance().push(m_UniformData.data(), blockSize);
+			}
+			m_Shader->bindDescriptorSet(cmd, m_PipelineLayout, slice, uniformOffset);
+		}
 	}
 
 	if (m_Config.fullscreenTriangle) {
@@ -185,159 +209,275 @@ void Pipeline::drawScene(uint32_t imageIndex,
 		vkCmdDraw(cmd, 3, 1, 0, 0);
 	}
 	else {
-		// Normal scene path
-		scene.drawScene(m_PipelineLayout, cmd);
-
-		// Update the same per-frame UBO slice we just bound
-		updateUniformBuffer(slice, swapChainExtent);
+		// Normal scene path; scenes that know about variants switch per batch through bindVariant
+		scene.setVariantPipeline(m_Config.specializationCount > 0 ? this : nullptr);
+		scene.drawScene(m_PipelineLayout, m_PushConstantRange, cmd);
+		scene.setVariantPipeline(nullptr);
 	}
 }
 
-void Pipeline::CreatePipeline(VkDevice device, VkRenderPass renderPass, VkPrimitiveTopology topology) {
+// Everything vkCreateGraphicsPipelines reads, owned by the build so it outlives CreatePipeline
+// while a worker compiles. The vertex input arrays stay with ShaderBase, which the Pipeline keeps.
+struct PipelineState {
 	VkPipelineViewportStateCreateInfo viewportState{};
-	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-	viewportState.viewportCount = 1;
-	viewportState.scissorCount = 1;
-
 	VkPipelineRasterizationStateCreateInfo rasterizer{};
-	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-	rasterizer.depthClampEnable = VK_FALSE;
-	rasterizer.rasterizerDiscardEnable = VK_FALSE;
-	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-	rasterizer.lineWidth = 1.0f;
+	VkPipelineMultisampleStateCreateInfo multisampling{};
+	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+	VkPipelineColorBlendStateCreateInfo colorBlending{};
+	std::vector<VkDynamicState> dynamicStates;
+	VkPipelineDynamicStateCreateInfo dynamicState{};
+	VkPipelineVertexInputStateCreateInfo vertexInput{};
+	VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+	VkPipelineDepthStencilStateCreateInfo depthStencil{};
+	VkPipelineShaderStageCreateInfo stages[2]{};
+	VkPipelineLayout layout = VK_NULL_HANDLE;
+	VkRenderPass renderPass = VK_NULL_HANDLE;
+	// Shader variants: bit i of the variant flags -> boolean constant_id i of the fragment stage
+	std::vector<VkSpecializationMapEntry> specEntries;
+	std::vector<VkBool32> specData;
+	VkSpecializationInfo specInfo{};
+};
+
+namespace {
+	// Thread-safe: the shared pipeline cache is internally synchronized
+	VkPipeline CompilePipeline(VkDevice device, PipelineState& s) {
+		s.colorBlending.pAttachments = &s.colorBlendAttachment;
+		s.dynamicState.dynamicStateCount = static_cast<uint32_t>(s.dynamicStates.size());
+		s.dynamicState.pDynamicStates = s.dynamicStates.data();
+		if (!s.specData.empty()) {
+			s.specInfo.mapEntryCount = static_cast<uint32_t>(s.specEntries.size());
+			s.specInfo.pMapEntries = s.specEntries.data();
+			s.specInfo.dataSize = s.specData.size() * sizeof(VkBool32);
+			s.specInfo.pData = s.specData.data();
+			s.stages[1].pSpecializationInfo = &s.specInfo;
+		}
+
+		VkGraphicsPipelineCreateInfo pipelineInfo{ VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
+		pipelineInfo.stageCount = 2;
+		pipelineInfo.pStages = s.stages;
+		pipelineInfo.pVertexInputState = &s.vertexInput;
+		pipelineInfo.pInputAssemblyState = &s.inputAssembly;
+		pipelineInfo.pViewportState = &s.viewportState;
+		pipelineInfo.pRasterizationState = &s.rasterizer;
+		pipelineInfo.pMultisampleState = &s.multisampling;
+		pipelineInfo.pDepthStencilState = &s.depthStencil; // <-- now dynamic
+		pipelineInfo.pColorBlendState = &s.colorBlending;
+		pipelineInfo.pDynamicState = &s.dynamicState;
+		pipelineInfo.layout = s.layout;
+		pipelineInfo.renderPass = s.renderPass;
+		pipelineInfo.subpass = 0;
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		VkResult r = vkCreateGraphicsPipelines(device, PipelineCache::GetInstance().get(), 1, &pipelineInfo, nullptr, &pipeline);
+		//fprintf(stderr, "vkCreateGraphicsPipelines => %d, handle=%p\n", r, (void*)pipeline);
+		if (r != VK_SUCCESS) throw std::runtime_error("failed to create graphics pipeline!");
+		return pipeline;
+	}
+
+	// Compiles, then drops the shader modules, which are only needed until the pipeline exists
+	VkPipeline CompileAndRelease(VkDevice device, PipelineState& s) {
+		try {
+			VkPipeline pipeline = CompilePipeline(device, s);
+			for (const auto& stage : s.stages) vkDestroyShaderModule(device, stage.module, nullptr);
+			return pipeline;
+		}
+		catch (...) {
+			for (const auto& stage : s.stages) vkDestroyShaderModule(device, stage.module, nullptr);
+			throw;
+		}
+	}
+}
+
+void Pipeline::CreatePipeline(VkDevice device, VkRenderPass renderPass, VkPrimitiveTopology topology) {
+	auto state = std::make_shared<PipelineState>();
+	PipelineState& s = *state;
+
+	s.viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	s.viewportState.viewportCount = 1;
+	s.viewportState.scissorCount = 1;
+
+	s.rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	s.rasterizer.depthClampEnable = VK_FALSE;
+	s.rasterizer.rasterizerDiscardEnable = VK_FALSE;
+	s.rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+	s.rasterizer.lineWidth = 1.0f;
 	if (m_Config.fullscreenTriangle) {
-		rasterizer.cullMode = VK_CULL_MODE_NONE;   // no culling for post
+		s.rasterizer.cullMode = VK_CULL_MODE_NONE;   // no culling for post
 	}
 	else {
-		rasterizer.cullMode = VK_CULL_MODE_FRONT_BIT;
-		rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+		s.rasterizer.cullMode = VK_CULL_MODE_FRONT_BIT;
+		s.rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
 	}
 
-	rasterizer.depthBiasEnable = VK_FALSE;
+	s.rasterizer.depthBiasEnable = VK_FALSE;
 
-	VkPipelineMultisampleStateCreateInfo multisampling{};
-	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-	multisampling.sampleShadingEnable = VK_FALSE;
-	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+	s.multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	s.multisampling.sampleShadingEnable = VK_FALSE;
+	s.multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 
-	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-	colorBlendAttachment.blendEnable = VK_FALSE;
+	s.colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+	s.colorBlendAttachment.blendEnable = VK_FALSE;
 
-	VkPipelineColorBlendStateCreateInfo colorBlending{};
-	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-	colorBlending.logicOpEnable = VK_FALSE;
-	colorBlending.logicOp = VK_LOGIC_OP_COPY;
-	colorBlending.attachmentCount = 1;
-	colorBlending.pAttachments = &colorBlendAttachment;
-	colorBlending.blendConstants[0] = 0.0f;
-	colorBlending.blendConstants[1] = 0.0f;
-	colorBlending.blendConstants[2] = 0.0f;
-	colorBlending.blendConstants[3] = 0.0f;
-
-	std::vector<VkDynamicState> dynamicStates = {
+	s.colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	s.colorBlending.logicOpEnable = VK_FALSE;
+	s.colorBlending.logicOp = VK_LOGIC_OP_COPY;
+	s.colorBlending.attachmentCount = 1;
+	s.colorBlending.blendConstants[0] = 0.0f;
+	s.colorBlending.blendConstants[1] = 0.0f;
+	s.colorBlending.blendConstants[2] = 0.0f;
+	s.colorBlending.blendConstants[3] = 0.0f;
+
+	s.dynamicStates = {
 		VK_DYNAMIC_STATE_VIEWPORT,
 		VK_DYNAMIC_STATE_SCISSOR
 	};
 	if (m_Config.enableDynamicLineWidth) {
-		dynamicStates.push_back(VK_DYNAMIC_STATE_LINE_WIDTH);
+		s.dynamicStates.push_back(VK_DYNAMIC_STATE_LINE_WIDTH);
 	}
-	VkPipelineDynamicStateCreateInfo dynamicState{};
-	dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-	dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
-	dynamicState.pDynamicStates = dynamicStates.data();
+	s.dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
 
 
 	VkDescriptorSetLayout setLayout = m_UseExternalDescriptors ? m_Config.externalSetLayout : m_Shader->getDescriptorSetLayout();
 
-
-	// Push constants on/off
-	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	pipelineLayoutInfo.setLayoutCount = 1;
-	pipelineLayoutInfo.pSetLayouts = &setLayout;
-
-	VkPushConstantRange pushConstantRange{};
-	if (m_Config.usePushConstants) {
-		pushConstantRange = createPushConstantRange();
-		pipelineLayoutInfo.pushConstantRangeCount = 1;
-		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+	// Exactly the push constants the stages declare (none if neither does). Scene pipelines put
+	// the frame constants (set 0) in front of their own set; drawScene binds set 0 per pass, since
+	// layouts with different ranges don't share it. External sets: just those.
+	// Pipelines with the same sets and range share the layout. It is cheap and Record needs it
+	// right away, so it is never deferred.
+	const ShaderReflection& reflection = m_Shader->getReflection();
+	m_PushConstantRange = {};
+	m_PushConstantRange.stageFlags = reflection.pushConstantStages;
+	m_PushConstantRange.offset = 0;
+	m_PushConstantRange.size = reflection.pushConstantSize;
+	if (m_UseExternalDescriptors) {
+		m_PipelineLayout = PipelineLayoutCache::GetInstance().getPipelineLayout({ setLayout }, m_PushConstantRange);
 	}
 	else {
-		pipelineLayoutInfo.pushConstantRangeCount = 0;
-		pipelineLayoutInfo.pPushConstantRanges = nullptr;
-	}
-
-	if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS) {
-		throw std::runtime_error("failed to create pipeline layout!");
+		m_PipelineLayout = FrameUniforms::GetInstance().getPipelineLayout(setLayout, m_PushConstantRange);
 	}
 
 	// Shader stages from ShaderBase (same as before)
-	auto vertShaderStageInfo = m_Shader->getVertexShaderStageInfo();
-	auto fragShaderStageInfo = m_Shader->getFragmentShaderStageInfo();
-	VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
+	s.stages[0] = m_Shader->getVertexShaderStageInfo();
+	s.stages[1] = m_Shader->getFragmentShaderStageInfo();
 
 	// Vertex Input: select empty or mesh VI
-	const VkPipelineVertexInputStateCreateInfo* viPtr = pickVI();
+	s.vertexInput = *pickVI();
 
 	// Depth state: dynamic per config
-	VkPipelineDepthStencilStateCreateInfo depthStencil{};
-	depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-	depthStencil.depthTestEnable = m_Config.enableDepthTest ? VK_TRUE : VK_FALSE;
-	depthStencil.depthWriteEnable = m_Config.enableDepthWrite ? VK_TRUE : VK_FALSE;
-	depthStencil.depthCompareOp = m_Config.depthCompareOp;
-	depthStencil.depthBoundsTestEnable = VK_FALSE;
-	depthStencil.stencilTestEnable = VK_FALSE;
+	s.depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	s.depthStencil.depthTestEnable = m_Config.enableDepthTest ? VK_TRUE : VK_FALSE;
+	s.depthStencil.depthWriteEnable = m_Config.enableDepthWrite ? VK_TRUE : VK_FALSE;
+	s.depthStencil.depthCompareOp = m_Config.depthCompareOp;
+	s.depthStencil.depthBoundsTestEnable = VK_FALSE;
+	s.depthStencil.stencilTestEnable = VK_FALSE;
 
 	// Input Assembly still comes from ShaderBase (ok), but use the chosen topology
-	auto ia = m_Shader->getInputAssemblyStateInfo(m_Config.topology);
-
-
-	VkGraphicsPipelineCreateInfo pipelineInfo{ VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
-	pipelineInfo.stageCount = 2;
-	pipelineInfo.pStages = shaderStages;
-	pipelineInfo.pVertexInputState = viPtr;
-	pipelineInfo.pInputAssemblyState = &ia;
-	pipelineInfo.pViewportState = &viewportState;
-	pipelineInfo.pRasterizationState = &rasterizer;
-	pipelineInfo.pMultisampleState = &multisampling;
-	pipelineInfo.pDepthStencilState = &depthStencil; // <-- now dynamic
-	pipelineInfo.pColorBlendState = &colorBlending;
-	pipelineInfo.pDynamicState = &dynamicState;
-	pipelineInfo.layout = m_PipelineLayout;
-	pipelineInfo.renderPass = renderPass;
-	pipelineInfo.subpass = 0;
+	s.inputAssembly = m_Shader->getInputAssemblyStateInfo(m_Config.topology);
+
+	s.layout = m_PipelineLayout;
+	s.renderPass = renderPass;
+
+	// Stand-in with the same layout, vertex input and state but a trivial fragment shader. It
+	// compiles in a fraction of the time, so it is built right here.
+	if (!m_Config.fallbackFragmentShader.empty()) {
+		PipelineState fallback = s;
+		fallback.stages[1] = m_Shader->createFragmentShaderStageInfo(m_Config.fallbackFragmentShader);
+		try {
+			m_FallbackPipeline = CompilePipeline(device, fallback);
+		}
+		catch (const std::exception& e) {
+			std::cerr << "Fallback pipeline failed: " << e.what() << std::endl;
+		}
+		vkDestroyShaderModule(device, fallback.stages[1].module, nullptr);
+	}
 
+	// Variants are compiled from the same state and modules later on, so those stay until Destroy
+	if (m_Config.specializationCount > 0) {
+		m_State = state;
+		if (!m_Config.asyncCompile) {
+			m_Pipeline3d = CompilePipeline(device, s);
+			return;
+		}
+		m_Build = AssetLoader::GetInstance().pool().submit([device, state] { return CompilePipeline(device, *state); }).share();
+		return;
+	}
 
-	VkResult r = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_Pipeline3d);
-	//fprintf(stderr, "vkCreateGraphicsPipelines => %d, handle=%p\n", r, (void*)m_Pipeline3d);
-	if (r != VK_SUCCESS) throw std::runtime_error("failed to create graphics pipeline!");
+	if (!m_Config.asyncCompile) {
+		m_Pipeline3d = CompileAndRelease(device, s);
+		return;
+	}
+	m_Build = AssetLoader::GetInstance().pool().submit([device, state] { return CompileAndRelease(device, *state); }).share();
+}
 
-	//auto& vertexInput = m_Shader->getVertexInputStateInfo();
+void Pipeline::bindVariant(VkCommandBuffer cmd, uint32_t flags)
+{
+	if (!isReady()) return;   // the fallback bound by drawScene stays
 
-	vkDestroyShaderModule(device, vertShaderStageInfo.module, nullptr);
-	vkDestroyShaderModule(device, fragShaderStageInfo.module, nullptr);
+	// The base pipeline has every feature on, so it stands in while a variant compiles
+	VkPipeline pipeline = m_Pipeline3d;
+	flags &= (1u << m_Config.specializationCount) - 1u;
+	if (flags != (1u << m_Config.specializationCount) - 1u) {
+		if (VkPipeline variant = requestVariant(flags)) pipeline = variant;
+	}
+	if (pipeline == m_BoundPipeline) return;
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+	m_BoundPipeline = pipeline;
 }
 
+VkPipeline Pipeline::requestVariant(uint32_t flags)
+{
+	if (!m_State || !isReady()) return VK_NULL_HANDLE;   // the base compile still reads m_State
+	Variant& v = m_Variants[flags];
+	if (v.pipeline || v.failed) return v.pipeline;
+
+	if (!v.build.valid()) {
+		auto state = std::make_shared<PipelineState>(*m_State);
+		for (uint32_t i = 0; i < m_Config.specializationCount; ++i) {
+			state->specEntries.push_back({ i, static_cast<uint32_t>(i * sizeof(VkBool32)), sizeof(VkBool32) });
+			state->specData.push_back((flags >> i) & 1u ? VK_TRUE : VK_FALSE);
+		}
+		const VkDevice device = vulkanVars::GetInstance().device;
+		v.build = AssetLoader::GetInstance().pool().submit([device, state] { return CompilePipeline(device, *state); }).share();
+		return VK_NULL_HANDLE;
+	}
 
+	if (v.build.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return VK_NULL_HANDLE;
+	try {
+		v.pipeline = v.build.get();
+	}
+	catch (const std::exception& e) {
+		// Keeps drawing with the base pipeline
+		std::cerr << "Shader variant " << flags << " failed: " << e.what() << std::endl;
+		v.failed = true;
+	}
+	v.build = {};
+	return v.pipeline;
+}
 
-void Pipeline::updateUniformBuffer(uint32_t currentImage, VkExtent2D swapChainExtent)
+bool Pipeline::isReady()
 {
-	//m_Ubo.proj[1][1] *= -1;
-	m_Shader->updateUniformBuffer(currentImage, m_Ubo);
+	if (!m_Pipeline3d && m_Build.valid() && m_Build.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+		// Called while a command buffer is recording, so a failed compile must not throw out of here.
+		// The build is dropped and the fallback keeps drawing (or the pass is skipped), as for variants.
+		try {
+			m_Pipeline3d = m_Build.get();
+		}
+		catch (const std::exception& e) {
+			std::cerr << "Pipeline compile failed, drawing with the fallback: " << e.what() << std::endl;
+		}
+		m_Build = {};
+	}
+	return m_Pipeline3d != VK_NULL_HANDLE;
 }
 
-VkPushConstantRange Pipeline::createPushConstantRange()
+void Pipeline::waitUntilReady()
 {
-	VkPushConstantRange pushConstantRange = {};
-	pushConstantRange.stageFlags = m_Config.pushConstantFlags;
-	pushConstantRange.offset = 0;
-	pushConstantRange.size = m_Config.pushConstantSize;
-
-	return pushConstantRange;
+	if (m_Build.valid()) m_Build.wait();
+	isReady();
 }
 
 
+
 void Pipeline::createImage(VkPhysicalDevice& vkPhysicalDevice, VkDevice& vkDevice, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory)
 {
 	VkImageCreateInfo imageInfo{};
@@ -396,9 +536,14 @@ void Pipeline::createDepthResources(VkPhysicalDevice& vkPhysicalDevice, VkDevice
 	m_DepthImageView = createImageView(vkDevice, m_DepthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
 }
 
-void Pipeline::updateDescriptorSets()
+void Pipeline::updateTextureSlots(size_t frameIndex, const std::vector<TextureSlot>& slots)
+{
+	if (!m_UseExternalDescriptors) m_Shader->updateTextureSlots(frameIndex, slots);
+}
+
+void Pipeline::setTextureSampler(VkSampler sampler)
 {
-	m_Shader->updateDescriptorSet();
+	if (!m_UseExternalDescriptors) m_Shader->setTextureSampler(sampler);
 }
 
 VkFormat Pipeline::findDepthFormat(VkPhysicalDevice& vkPhysicalDevice, VkDevice& vkDevice)
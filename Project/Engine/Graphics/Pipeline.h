@@ -1,15 +1,18 @@
 #pragma once
 #include <vector>
 #include <memory>
+#include <future>
+#include <unordered_map>
 #include <vulkan\vulkan_core.h>
 
 #include <Engine/Graphics/ShaderBase.h>
 #include <Engine/Graphics/CommandBuffer.h>
 #include <Engine/Graphics/CommandPool.h>
 #include <Engine/Scene/Scene.h>
-#include <Engine/Graphics/UniformBufferObject.h>
 #include <Engine/Graphics/MeshData.h>
 
+struct PipelineState;
+
 struct PipelineConfig {
 	VkRenderPass renderPass = VK_NULL_HANDLE;           // which render pass to build for
 	VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
@@ -21,9 +24,6 @@ struct PipelineConfig {
 	// Vertex input: if false -> fullscreen/no-VB style
 	bool useVertexInput = true;
 
-	// Push constants: keep off for post
-	bool usePushConstants = true;
-
 	// If provided, Pipeline will use these instead of ShaderBases layout & sets.
 	VkDescriptorSetLayout externalSetLayout = VK_NULL_HANDLE;
 	const std::vector<VkDescriptorSet>* externalSets = nullptr;
@@ -31,8 +31,20 @@ struct PipelineConfig {
 	// If true, Record() draws a fullscreen triangle (3 verts) instead of Scene.
 	bool fullscreenTriangle = false;
 	bool enableDynamicLineWidth = false;
-	uint16_t pushConstantSize = sizeof(MeshData);
-	int pushConstantFlags = (VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
+	// Descriptor sets and push constants aren't configured: they come from reflecting the shaders
+	// (ShaderBase::getReflection), see getPushConstantRange
+	// Texture table sized to vulkanVars::textureSlots when the device has descriptor indexing
+	// (the fragment shader must declare an unsized sampler array); MAX_TEXTURES otherwise
+	bool bindlessTextures = false;
+	// Compile on the asset worker pool instead of blocking Initialize. Until it is done Record
+	// draws with the fallback (same layout and vertex input, this fragment shader) if one is
+	// given, and skips the pass otherwise.
+	bool asyncCompile = true;
+	std::string fallbackFragmentShader;
+	// Shader variants: the fragment shader declares this many boolean specialization constants
+	// (constant_id 0..n-1, default true). The pipeline itself is the all-true variant; others are
+	// compiled on first use through bindVariant.
+	uint32_t specializationCount = 0;
 
 };
 
@@ -54,33 +66,60 @@ public:
 		const std::vector<VkVertexInputBindingDescription>& bindings,
 		std::vector<VkVertexInputAttributeDescription> attributes,
 		const PipelineConfig& cfg);
-	void setUbo(const UniformBufferObject& ubo) { m_Ubo = ubo; }
-	void updateDescriptorSets();
+	// Contents of the shaders' own uniform block (set 1, binding 0), copied into the frame ring
+	// each time the pipeline records; camera and time come from FrameUniforms instead
+	void setUniformData(const void* data, size_t size) { m_UniformData.assign(static_cast<const char*>(data), static_cast<const char*>(data) + size); }
+	// New/changed texture table entries (TextureManager::takeDirtySlots); call every frame
+	void updateTextureSlots(size_t frameIndex, const std::vector<TextureSlot>& slots);
+	void setTextureSampler(VkSampler sampler);
 	static VkFormat findDepthFormat(VkPhysicalDevice& vkPhysicalDevice, VkDevice& vkDevice);
 	VkImage getDepthImage() { return m_DepthImage; };
 	VkDeviceMemory getDepthImageMemory() { return m_DepthImageMemory; };
 	VkImageView getDepthImageView() { return m_DepthImageView; };
 	// Pipeline.h (add)
 	VkPipelineLayout getPipelineLayout() { return m_PipelineLayout; };
+	// Push constant range of the layout (size 0 if none); pushes must use these stage flags
+	const VkPushConstantRange& getPushConstantRange() const { return m_PushConstantRange; }
 
 	PipelineConfig getConfig() { return m_Config; };
+
+	// Future-like view of the compile (PipelineConfig::asyncCompile): isReady() polls without
+	// blocking and stays false after a failed compile (logged; the fallback keeps drawing);
+	// waitUntilReady() blocks until it has finished
+	bool isReady();
+	void waitUntilReady();
+
+	// Binds the variant for 'flags' (bit i = constant_id i) while recording this pipeline's pass.
+	// A variant that isn't compiled yet is queued, and the all-true pipeline draws meanwhile.
+	void bindVariant(VkCommandBuffer cmd, uint32_t flags);
+	// Compiled variant, or VK_NULL_HANDLE after queueing its compile (once the pipeline is ready)
+	VkPipeline requestVariant(uint32_t flags);
 private:
 	void drawScene(uint32_t imageIndex, VkRenderPass renderPass, const std::vector<VkFramebuffer>& swapChainFramebuffers, VkExtent2D swapChainExtent, Scene& scene);
 
 	void CreatePipeline(VkDevice device, VkRenderPass renderPass, VkPrimitiveTopology topology);
 
 	VkPipeline m_Pipeline3d;
+	VkPipeline m_FallbackPipeline = VK_NULL_HANDLE;
+	std::shared_future<VkPipeline> m_Build;     // valid while the worker compile hasn't been picked up
+	VkPipeline m_BoundPipeline = VK_NULL_HANDLE;
+
+	struct Variant {
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		std::shared_future<VkPipeline> build;
+		bool failed = false;
+	};
+	std::shared_ptr<PipelineState> m_State;    // kept for variants (specializationCount > 0)
+	std::unordered_map<uint32_t, Variant> m_Variants;
 	std::unique_ptr<ShaderBase> m_Shader;
 	PipelineConfig m_Config{};                  // NEW
 	bool m_UseExternalDescriptors = false;      // NEW
 	VkPipelineVertexInputStateCreateInfo m_EmptyVI{}; // NEW
 	const VkPipelineVertexInputStateCreateInfo* pickVI(); // NEW
-	UniformBufferObject m_Ubo{};
-
-	VkPipelineLayout m_PipelineLayout;
-	void updateUniformBuffer(uint32_t currentImage, VkExtent2D swapChainExtent);
+	std::vector<char> m_UniformData;
 
-	VkPushConstantRange createPushConstantRange();
+	VkPipelineLayout m_PipelineLayout;            // owned by PipelineLayoutCache
+	VkPushConstantRange m_PushConstantRange{};
 
 	void createImage(VkPhysicalDevice& vkPhysicalDevice, VkDevice& vkDevice,uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory);
 	
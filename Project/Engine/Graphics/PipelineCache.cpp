@@ -0,0 +1,137 @@
+// PipelineCache.cpp
+#include "PipelineCache.h"
+#include <Engine/Graphics/vulkanVars.h>
+#include <Engine/Core/Hash.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace {
+    constexpr uint32_t kMagic = 0x43505056u;   // "VPPC"
+    constexpr uint32_t kVersion = 1;
+
+    // The driver validates its own blob too, but only against vendor, device and cache UUID;
+    // the driver version and a checksum are on us
+    struct FileHeader {
+        uint32_t magic = kMagic;
+        uint32_t version = kVersion;
+        uint32_t vendorID = 0;
+        uint32_t deviceID = 0;
+        uint32_t driverVersion = 0;
+        uint8_t cacheUUID[VK_UUID_SIZE] = {};
+        uint64_t dataSize = 0;
+        uint64_t dataHash = 0;   // Hash::XXH64 of the blob
+    };
+
+    FileHeader DeviceHeader() {
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(vulkanVars::GetInstance().physicalDevice, &properties);
+        FileHeader h;
+        h.vendorID = properties.vendorID;
+        h.deviceID = properties.deviceID;
+        h.driverVersion = properties.driverVersion;
+        std::memcpy(h.cacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+        return h;
+    }
+
+    // Blob from 'path' if it was written for this device and driver, empty otherwise
+    std::vector<char> ReadBlob(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return {};
+
+        FileHeader h;
+        if (!in.read(reinterpret_cast<char*>(&h), sizeof(h))) return {};
+        const FileHeader expected = DeviceHeader();
+        if (h.magic != kMagic || h.version != kVersion) return {};
+        if (h.vendorID != expected.vendorID || h.deviceID != expected.deviceID ||
+            h.driverVersion != expected.driverVersion ||
+            std::memcmp(h.cacheUUID, expected.cacheUUID, VK_UUID_SIZE) != 0) {
+            std::cout << "[PipelineCache] \"" << path << "\" is from another device or driver, starting empty\n";
+            return {};
+        }
+
+        // The header's size has to be what follows it, before anything is allocated for it
+        std::error_code ec;
+        const uintmax_t fileSize = std::filesystem::file_size(path, ec);
+        if (ec || fileSize < sizeof(h) || h.dataSize != fileSize - sizeof(h)) {
+            std::cerr << "[PipelineCache] \"" << path << "\" is damaged, starting empty\n";
+            return {};
+        }
+
+        std::vector<char> data(static_cast<size_t>(h.dataSize));
+        if (!in.read(data.data(), std::streamsize(data.size())) || Hash::XXH64(data.data(), data.size()) != h.dataHash) {
+            std::cerr << "[PipelineCache] \"" << path << "\" is damaged, starting empty\n";
+            return {};
+        }
+        return data;
+    }
+}
+
+void PipelineCache::load(const std::string& path)
+{
+    auto& vulkan_vars = vulkanVars::GetInstance();
+    m_Path = path;
+    const std::vector<char> blob = ReadBlob(path);
+
+    VkPipelineCacheCreateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    info.initialDataSize = blob.size();
+    info.pInitialData = blob.empty() ? nullptr : blob.data();
+    if (vkCreatePipelineCache(vulkan_vars.device, &info, nullptr, &m_Cache) != VK_SUCCESS) {
+        // A blob the driver still refuses is no reason to run without a cache
+        info.initialDataSize = 0;
+        info.pInitialData = nullptr;
+        if (vkCreatePipelineCache(vulkan_vars.device, &info, nullptr, &m_Cache) != VK_SUCCESS) {
+            std::cerr << "[PipelineCache] failed to create pipeline cache, pipelines compile uncached\n";
+            m_Cache = VK_NULL_HANDLE;
+            return;
+        }
+    }
+    std::cout << "[PipelineCache] " << (blob.empty() ? "empty" : std::to_string(blob.size()) + " bytes from \"" + path + "\"") << "\n";
+}
+
+bool PipelineCache::save() const
+{
+    if (!m_Cache || m_Path.empty()) return false;
+    auto& vulkan_vars = vulkanVars::GetInstance();
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(vulkan_vars.device, m_Cache, &size, nullptr) != VK_SUCCESS || size == 0) return false;
+    std::vector<char> data(size);
+    if (vkGetPipelineCacheData(vulkan_vars.device, m_Cache, &size, data.data()) != VK_SUCCESS) return false;
+    data.resize(size);
+
+    FileHeader h = DeviceHeader();
+    h.dataSize = data.size();
+    h.dataHash = Hash::XXH64(data.data(), data.size());
+
+    std::error_code ec;
+    const std::filesystem::path target(m_Path);
+    if (target.has_parent_path()) std::filesystem::create_directories(target.parent_path(), ec);
+
+    // Temp file + rename, so a crash mid-write never leaves a half file behind
+    const std::string tmpPath = m_Path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.write(data.data(), std::streamsize(data.size()));
+        if (!out) { out.close(); std::filesystem::remove(tmpPath, ec); return false; }
+    }
+    std::filesystem::rename(tmpPath, m_Path, ec);
+    if (ec) {
+        std::cerr << "[PipelineCache] failed to write \"" << m_Path << "\": " << ec.message() << "\n";
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+void PipelineCache::destroy()
+{
+    if (m_Cache) vkDestroyPipelineCache(vulkanVars::GetInstance().device, m_Cache, nullptr);
+    m_Cache = VK_NULL_HANDLE;
+}
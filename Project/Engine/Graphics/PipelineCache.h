@@ -0,0 +1,30 @@
+// PipelineCache.h
+#pragma once
+#include <vulkan/vulkan.h>
+#include <string>
+
+#include <Engine/Core/Singleton.h>
+
+// One VkPipelineCache shared by every pipeline the renderer creates, kept on disk between runs so
+// the driver can skip shader compilation it already did. The file carries its own header with the
+// vendor, device, driver version and pipelineCacheUUID it was written for; a blob from another
+// GPU or driver (or a damaged one) is ignored and the cache starts out empty.
+class PipelineCache : public Singleton<PipelineCache> {
+public:
+    // Creates the cache, seeded from 'path' when that file matches this device. Call once the
+    // logical device exists, before the first pipeline.
+    void load(const std::string& path);
+    // VK_NULL_HANDLE before load() (pipelines then compile uncached)
+    VkPipelineCache get() const { return m_Cache; }
+
+    // Writes the driver's cache data back to the path given to load(); device must be idle
+    bool save() const;
+    void destroy();
+
+private:
+    friend class Singleton<PipelineCache>;
+    PipelineCache() = default;
+
+    VkPipelineCache m_Cache = VK_NULL_HANDLE;
+    std::string m_Path;
+};
@@ -0,0 +1,86 @@
+// PipelineLayoutCache.cpp
+#include "PipelineLayoutCache.h"
+#include <Engine/Graphics/vulkanVars.h>
+#include <algorithm>
+#include <stdexcept>
+
+bool SetLayoutDesc::updateAfterBind() const
+{
+    return std::any_of(bindingFlags.begin(), bindingFlags.end(),
+        [](VkDescriptorBindingFlagsEXT f) { return (f & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT) != 0; });
+}
+
+bool SetLayoutDesc::operator==(const SetLayoutDesc& o) const
+{
+    if (bindingFlags != o.bindingFlags || bindings.size() != o.bindings.size()) return false;
+    for (size_t i = 0; i < bindings.size(); ++i) {
+        const VkDescriptorSetLayoutBinding& a = bindings[i];
+        const VkDescriptorSetLayoutBinding& b = o.bindings[i];
+        if (a.binding != b.binding || a.descriptorType != b.descriptorType ||
+            a.descriptorCount != b.descriptorCount || a.stageFlags != b.stageFlags) return false;
+    }
+    return true;
+}
+
+VkDescriptorSetLayout PipelineLayoutCache::getSetLayout(const SetLayoutDesc& desc)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (const auto& [key, layout] : m_SetLayouts)
+        if (key == desc) return layout;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(desc.bindings.size());
+    layoutInfo.pBindings = desc.bindings.data();
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT flagsInfo{};
+    flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+    flagsInfo.bindingCount = static_cast<uint32_t>(desc.bindingFlags.size());
+    flagsInfo.pBindingFlags = desc.bindingFlags.data();
+    if (std::any_of(desc.bindingFlags.begin(), desc.bindingFlags.end(), [](VkDescriptorBindingFlagsEXT f) { return f != 0; }))
+        layoutInfo.pNext = &flagsInfo;
+    if (desc.updateAfterBind())
+        layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+
+    VkDescriptorSetLayout layout;
+    if (vkCreateDescriptorSetLayout(vulkanVars::GetInstance().device, &layoutInfo, nullptr, &layout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create descriptor set layout!");
+    }
+    m_SetLayouts.emplace_back(desc, layout);
+    return layout;
+}
+
+VkPipelineLayout PipelineLayoutCache::getPipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts, const VkPushConstantRange& range)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (const PipelineLayoutEntry& e : m_PipelineLayouts) {
+        if (e.setLayouts == setLayouts && e.range.size == range.size &&
+            (range.size == 0 || e.range.stageFlags == range.stageFlags)) return e.layout;
+    }
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = range.size > 0 ? 1 : 0;
+    pipelineLayoutInfo.pPushConstantRanges = range.size > 0 ? &range : nullptr;
+
+    VkPipelineLayout layout;
+    if (vkCreatePipelineLayout(vulkanVars::GetInstance().device, &pipelineLayoutInfo, nullptr, &layout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create pipeline layout!");
+    }
+    m_PipelineLayouts.push_back({ setLayouts, range, layout });
+    return layout;
+}
+
+void PipelineLayoutCache::destroy()
+{
+    auto& vulkan_vars = vulkanVars::GetInstance();
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (const PipelineLayoutEntry& e : m_PipelineLayouts)
+        vkDestroyPipelineLayout(vulkan_vars.device, e.layout, nullptr);
+    for (const auto& [key, layout] : m_SetLayouts)
+        vkDestroyDescriptorSetLayout(vulkan_vars.device, layout, nullptr);
+    m_PipelineLayouts.clear();
+    m_SetLayouts.clear();
+}
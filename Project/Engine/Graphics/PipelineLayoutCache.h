@@ -0,0 +1,46 @@
+// PipelineLayoutCache.h
+#pragma once
+#include <vulkan/vulkan.h>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <Engine/Core/Singleton.h>
+
+// Descriptor set layout as ShaderBase builds it from shader reflection
+struct SetLayoutDesc {
+    std::vector<VkDescriptorSetLayoutBinding> bindings;    // sorted by binding, no immutable samplers
+    std::vector<VkDescriptorBindingFlagsEXT> bindingFlags; // one per binding (descriptor indexing)
+
+    // Some binding is update-after-bind: the layout and its pool need the matching create flags
+    bool updateAfterBind() const;
+
+    bool operator==(const SetLayoutDesc& o) const;
+};
+
+// One VkDescriptorSetLayout per distinct SetLayoutDesc and one VkPipelineLayout per distinct
+// (set layouts, push constant range), shared by every pipeline whose shaders declare the same
+// interface. Owns them all until destroy().
+class PipelineLayoutCache : public Singleton<PipelineLayoutCache> {
+public:
+    VkDescriptorSetLayout getSetLayout(const SetLayoutDesc& desc);
+    // range.size == 0: no push constants
+    VkPipelineLayout getPipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts, const VkPushConstantRange& range);
+
+    // Device must be idle
+    void destroy();
+
+private:
+    friend class Singleton<PipelineLayoutCache>;
+    PipelineLayoutCache() = default;
+
+    struct PipelineLayoutEntry {
+        std::vector<VkDescriptorSetLayout> setLayouts;
+        VkPushConstantRange range;
+        VkPipelineLayout layout;
+    };
+
+    std::mutex m_Mutex;
+    std::vector<std::pair<SetLayoutDesc, VkDescriptorSetLayout>> m_SetLayouts; // few entries, linear search
+    std::vector<PipelineLayoutEntry> m_PipelineLayouts;
+};
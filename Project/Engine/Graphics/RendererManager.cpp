@@ -3,6 +3,7 @@
 #include  <Engine/Core/WindowManager.h>
 #include <set>
 #include <algorithm>
+#include <cstring>
 #include <Engine/Graphics/Particle.h>
 #include <Engine/Platform/Windows/VulkanSurface_Windows.h>
 #include <Engine/Graphics/MaterialManager.h>
@@ -11,6 +12,10 @@
 #include <Engine/Graphics/InstanceData.h>
 #include <Engine/Platform/Windows/PlatformWindow_Windows.h>
 #include "Engine/Core/Settings.h"
+#include <Engine/Core/AssetLoader.h>
+#include <Engine/Graphics/SamplerCache.h>
+#include <Engine/Graphics/PipelineCache.h>
+#include <Engine/Graphics/FrameUniforms.h>
 
 RendererManager::RendererManager() {
 }
@@ -122,6 +127,11 @@ void RendererManager::Initialize() {
 
 	pickPhysicalDevice();
 	createLogicalDevice();
+	// Every pipeline below compiles through it; Game::run writes it back on shutdown
+	PipelineCache::GetInstance().load(Settings::GetInstance().Get<std::string>("assets.pipelineCache", "cache/pipelines.bin"));
+	// Set 0 of every scene pipeline, so before any of them is created
+	FrameUniforms::GetInstance().init();
+	m_StartTime = std::chrono::steady_clock::now();
 
 	createSwapChain();
 	createImageViews();
@@ -211,18 +221,20 @@ void RendererManager::RenderFrame(const std::vector<RenderItem>& renderItems, Ca
 	}
 	imagesInFlight[imageIndex] = inFlightFences[frameIndex]; // hand off
 
-	// 4) Update UBOs 
-	UniformBufferObject vp{};
+	// 4) Frame constants, written once into this frame's part of the uniform ring (idle since the fence wait)
+	FrameConstants vp{};
 	vp.view = glm::inverse(camera.CalculateCameraToWorld());
 	vp.proj = glm::perspectiveRH_ZO(glm::radians(camera.fovAngle), camera.aspectRatio, camera.nearPlane, camera.farPlane);
 	vp.proj[1][1] *= -1.0f;
-	vp.cameraPos = camera.origin;
-	m_Pipeline3d.setUbo(vp);
-	m_PipelineParticles.setUbo(vp);
-	m_PipelineDebugLines.setUbo(vp);
+	vp.viewProj = vp.proj * vp.view;
+	vp.cameraPos = glm::vec4(camera.origin, 1.0f);
+	vp.time = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_StartTime).count();
+	FrameUniforms::GetInstance().beginFrame(vk.currentFrame, vp);
 
 
 	SyncSettings();
+	// Finish async loads (uploads, mesh swaps) within the frame budget, then register the results
+	AssetLoader::GetInstance().pump(m_AssetLoadBudgetMs);
 	SceneModelManager::getInstance().flushRuntimeAdds();
 
 	// --- Your basic window (example) ---
@@ -235,15 +247,25 @@ void RendererManager::RenderFrame(const std::vector<RenderItem>& renderItems, Ca
 	const bool useCenterTest = true;
 	const float frontSideDegrees = 200.f;
 
-	SceneModelManager::getInstance().setFrameView(vp.cameraPos, renderDistance,-camera.forward, use2d, frontSideDegrees, useCenterTest);
+	SceneModelManager::getInstance().setFrameView(camera.origin, renderDistance,-camera.forward, use2d, frontSideDegrees, useCenterTest);
 
+	// Texture streaming: visible materials ask for their mip levels, which are loaded or dropped
+	// before the texture table update below picks up the new images
 	auto& texMgr = TextureManager::GetInstance();
-	if (texMgr.isTextureListDirty()) { m_Pipeline3d.updateDescriptorSets(); texMgr.clearTextureListDirty(); }
+	if (auto* mesh = SceneModelManager::getInstance().getMeshScene()) {
+		mesh->requestTextureLevels(m_StreamFullResDistance);
+	}
+	texMgr.updateStreaming(vk.frameIndex);
+	texMgr.updateResidency(vk.frameIndex);
+	// Only changed slots are written, into this frame's set (idle since the fence wait above).
+	// The shared sampler changes with the anisotropy setting.
+	m_Pipeline3d.setTextureSampler(Texture::GetMaterialSampler());
+	m_Pipeline3d.updateTextureSlots(frameIndex, texMgr.takeDirtySlots());
 
 	if (m_EnableChunkDebug) {
 		auto* mesh = SceneModelManager::getInstance().getMeshScene();
 		if (mesh) {
-			BuildChunkDebug(m_DebugLineScene, *mesh, vp.cameraPos, m_ChunkRangeToRender);
+			BuildChunkDebug(m_DebugLineScene, *mesh, camera.origin, m_ChunkRangeToRender);
 		}
 	}
 
@@ -252,6 +274,13 @@ void RendererManager::RenderFrame(const std::vector<RenderItem>& renderItems, Ca
 
 	vk.commandBuffers[frameIndex].beginRecording();
 
+	// Cluster culling for large meshes has to be recorded before the offscreen pass begins
+	if (m_EnableMeshletCulling) {
+		if (auto* mesh = SceneModelManager::getInstance().getMeshScene()) {
+			mesh->recordMeshletCulling(vk.commandBuffers[frameIndex].m_VkCommandBuffer, vp.viewProj, camera.origin);
+		}
+	}
+
 	for (const RenderStage& stage : m_RenderStages) {
 		VkRenderPassBeginInfo begin{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
 		begin.renderPass = stage.renderPass;
@@ -286,14 +315,18 @@ void RendererManager::RenderFrame(const std::vector<RenderItem>& renderItems, Ca
 					DebugLinePC dlp = {};
 					dlp.world = glm::mat4(1.0f);
 					dlp.lineWidth = 1.0f;
-					vkCmdPushConstants(
-						cmd,
-						p->getPipelineLayout(),
-						p->getConfig().pushConstantFlags,
-						0,
-						p->getConfig().pushConstantSize,
-						&dlp
-					);
+					// The shader's block is shorter than the padded struct; push what it declares
+					const VkPushConstantRange& range = p->getPushConstantRange();
+					if (range.size > 0) {
+						vkCmdPushConstants(
+							cmd,
+							p->getPipelineLayout(),
+							range.stageFlags,
+							0,
+							std::min<uint32_t>(range.size, sizeof(dlp)),
+							&dlp
+						);
+					}
 
 
 					m_PipelineDebugLines.Record(imageIndex, stage.renderPass, *stage.framebuffers, vk.swapChainExtent, m_DebugLineScene);
@@ -396,6 +429,14 @@ void RendererManager::SyncSettings()
 		}
 	}
 
+	// GPU meshlet culling
+	{
+		const bool v = S.Get<bool>("renderer.meshletCulling", m_EnableMeshletCulling);
+		if (v != m_EnableMeshletCulling) {
+			m_EnableMeshletCulling = v;
+		}
+	}
+
 	// Chunk debug overlay
 	{
 		const bool v = S.Get<bool>("renderer.chunkDebug", m_EnableChunkDebug);
@@ -419,6 +460,27 @@ void RendererManager::SyncSettings()
 			m_ChunkRangeToRender = v;
 		}
 	}
+
+	// Async asset finalize budget
+	{
+		const float v = S.Get<float>("assets.loadBudgetMs", m_AssetLoadBudgetMs);
+		if (std::abs(v - m_AssetLoadBudgetMs) > 1e-3f) {
+			m_AssetLoadBudgetMs = v;
+		}
+	}
+
+	// Texture streaming budgets
+	{
+		auto& texMgr = TextureManager::GetInstance();
+		m_StreamFullResDistance = S.Get<float>("streaming.fullResDistance", m_StreamFullResDistance);
+		texMgr.setStreamingBudget(static_cast<size_t>(S.Get<float>("streaming.budgetMB", 1024.f) * 1024.0 * 1024.0));
+		texMgr.setStreamingUploadLimit(static_cast<size_t>(S.Get<float>("streaming.uploadMBPerFrame", 32.f) * 1024.0 * 1024.0));
+		texMgr.setResidencyBudget(static_cast<size_t>(S.Get<float>("memory.textureBudgetMB", 2048.f) * 1024.0 * 1024.0),
+			static_cast<uint64_t>(std::max(S.Get<int>("memory.textureIdleFrames", 300), 1)),
+			S.Get<bool>("memory.followDeviceBudget", true));
+		// Applies to batches loaded from now on
+		texMgr.setPacking(S.Get<bool>("assets.packSmallTextures", true), static_cast<uint32_t>(S.Get<float>("assets.packMaxSize", 256.f)));
+	}
 }
 
 void RendererManager::createInstance()
@@ -434,7 +496,7 @@ void RendererManager::createInstance()
 	appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
 	appInfo.pEngineName = "No Engine";
 	appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-	appInfo.apiVersion = VK_API_VERSION_1_0;
+	appInfo.apiVersion = VK_API_VERSION_1_1; // vkGetPhysicalDeviceFeatures2 for descriptor indexing
 
 	VkInstanceCreateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -615,18 +677,92 @@ void RendererManager::createLogicalDevice()
 	queueCreateInfo.queueFamilyIndex = indices.graphicsFamily.value();
 	queueCreateInfo.queueCount = 1;
 
+	VkPhysicalDeviceFeatures supportedFeatures{};
+	vkGetPhysicalDeviceFeatures(vulkan_vars.physicalDevice, &supportedFeatures);
+
 	VkPhysicalDeviceFeatures deviceFeatures{};
+	// Cooked textures may be block compressed; Texture falls back to the source image without it
+	deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+	vulkan_vars.textureCompressionBC = supportedFeatures.textureCompressionBC == VK_TRUE;
+	// Anisotropic filtering for textures seen at grazing angles (ground, walls)
+	deviceFeatures.samplerAnisotropy = supportedFeatures.samplerAnisotropy;
+	if (supportedFeatures.samplerAnisotropy) {
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(vulkan_vars.physicalDevice, &properties);
+		vulkan_vars.maxSamplerAnisotropy = properties.limits.maxSamplerAnisotropy;
+	}
+
+	// Bindless texture table (VK_EXT_descriptor_indexing, core in 1.2). Optional: the PBR pipeline
+	// falls back to the fixed MAX_TEXTURES array when any of the needed features is missing.
+	std::vector<const char*> extensions = deviceExtensions;
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures{};
+	indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT enabledIndexing{};
+	enabledIndexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+	{
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(vulkan_vars.physicalDevice, &properties);
+
+		uint32_t extensionCount = 0;
+		vkEnumerateDeviceExtensionProperties(vulkan_vars.physicalDevice, nullptr, &extensionCount, nullptr);
+		std::vector<VkExtensionProperties> available(extensionCount);
+		vkEnumerateDeviceExtensionProperties(vulkan_vars.physicalDevice, nullptr, &extensionCount, available.data());
+		const bool hasExtension = std::any_of(available.begin(), available.end(), [](const VkExtensionProperties& e) {
+			return std::strcmp(e.extensionName, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) == 0; });
+
+		if (hasExtension && properties.apiVersion >= VK_API_VERSION_1_1) {
+			VkPhysicalDeviceFeatures2 features2{};
+			features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			features2.pNext = &indexingFeatures;
+			vkGetPhysicalDeviceFeatures2(vulkan_vars.physicalDevice, &features2);
+
+			VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexingProperties{};
+			indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+			VkPhysicalDeviceProperties2 properties2{};
+			properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+			properties2.pNext = &indexingProperties;
+			vkGetPhysicalDeviceProperties2(vulkan_vars.physicalDevice, &properties2);
+
+			// The texture arrays of packed textures count against the same limits
+			const uint32_t limit = std::min(indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+				indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages);
+			const uint32_t slots = limit > MAX_TEXTURE_ARRAYS ? std::min(MAX_BINDLESS_TEXTURES, limit - MAX_TEXTURE_ARRAYS) : 0;
+
+			if (indexingFeatures.runtimeDescriptorArray && indexingFeatures.descriptorBindingPartiallyBound &&
+				indexingFeatures.descriptorBindingSampledImageUpdateAfterBind &&
+				indexingFeatures.shaderSampledImageArrayNonUniformIndexing && slots > uint32_t(MAX_TEXTURES)) {
+				enabledIndexing.runtimeDescriptorArray = VK_TRUE;
+				enabledIndexing.descriptorBindingPartiallyBound = VK_TRUE;
+				enabledIndexing.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+				enabledIndexing.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+				extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+				vulkan_vars.bindlessTextures = true;
+				vulkan_vars.textureSlots = slots;
+			}
+		}
+		std::cout << "Texture slots: " << vulkan_vars.textureSlots
+			<< (vulkan_vars.bindlessTextures ? " (descriptor indexing)\n" : " (fixed array)\n");
+
+		// Heap budgets, so the texture budget can follow what the driver grants us
+		const bool hasMemoryBudget = std::any_of(available.begin(), available.end(), [](const VkExtensionProperties& e) {
+			return std::strcmp(e.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0; });
+		if (hasMemoryBudget && properties.apiVersion >= VK_API_VERSION_1_1) {
+			extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+			vulkan_vars.memoryBudget = true;
+		}
+	}
 
 	VkDeviceCreateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	if (vulkan_vars.bindlessTextures) createInfo.pNext = &enabledIndexing;
 
 	createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 	createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
 	createInfo.pEnabledFeatures = &deviceFeatures;
 
-	createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-	createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+	createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+	createInfo.ppEnabledExtensionNames = extensions.data();
 
 	if (enableValidationLayers) {
 		createInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
@@ -896,7 +1032,7 @@ void RendererManager::initPipeLines() {
 
 	// attributes: mesh 0..3 + instance 4..9
 	auto meshAttribs = Vertex::getAttributeDescriptions();           // loc 0..3
-	auto instAttribs = InstanceData::getAttributeDescriptions(1, 4); // loc 4..9
+	auto instAttribs = InstanceData::getAttributeDescriptions(1, 4); // loc 4..10
 	meshAttribs.insert(meshAttribs.end(), instAttribs.begin(), instAttribs.end());
 
 	PipelineConfig pbr{};
@@ -906,11 +1042,13 @@ void RendererManager::initPipeLines() {
 	pbr.enableDepthWrite = true;                 // write depth for main pass
 	pbr.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
 	pbr.useVertexInput = true;
-	pbr.usePushConstants = false;                 // still fine; Mesh pushes pc
+	pbr.bindlessTextures = true;                  // only takes effect with descriptor indexing
+	pbr.fallbackFragmentShader = "shaders/pbrFallback.frag.spv"; // untextured, while the real one compiles
+	pbr.specializationCount = Material::kPbrFeatureCount;       // per-batch variants, see MeshScene::drawScene
 
 	// IMPORTANT: do NOT call the single-binding Initialize first  call only this:
 	m_Pipeline3d.Initialize("shaders/pbrShader.vert.spv",
-		"shaders/pbrShader.frag.spv",
+		vk.bindlessTextures ? "shaders/pbrShader.frag.spv" : "shaders/pbrShaderFixed.frag.spv",
 		instBindings, std::move(meshAttribs),
 		pbr);
 
@@ -941,7 +1079,6 @@ void RendererManager::initPipeLines() {
 	postCfg.enableDepthTest = false;
 	postCfg.enableDepthWrite = false;
 	postCfg.useVertexInput = false;   // fullscreen tri, no VB
-	postCfg.usePushConstants = false;
 	postCfg.fullscreenTriangle = true;
 	postCfg.externalSetLayout = m_PostSetLayout;
 	postCfg.externalSets = &m_PostDescSets;
@@ -962,10 +1099,7 @@ void RendererManager::initPipeLines() {
 	lcfg.enableDepthWrite = true;  // dont disturb main depth
 	lcfg.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
 	lcfg.useVertexInput = true;
-	lcfg.usePushConstants = true;
 	lcfg.enableDynamicLineWidth = true;
-	lcfg.pushConstantSize = sizeof(DebugLinePC);
-	lcfg.pushConstantFlags = VK_SHADER_STAGE_VERTEX_BIT;
 	
 
 	m_PipelineDebugLines.Initialize(
@@ -1166,22 +1300,19 @@ void RendererManager::createPostDescriptors() {
 	if (vkCreateDescriptorPool(vk.device, &pci, nullptr, &m_PostDescPool) != VK_SUCCESS)
 		throw std::runtime_error("post desc pool failed");
 
-	// color sampler
-	VkSamplerCreateInfo sci{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+	// color sampler (shared, see SamplerCache)
+	SamplerDesc sci;
 	sci.magFilter = VK_FILTER_LINEAR; sci.minFilter = VK_FILTER_LINEAR;
 	sci.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
-	sci.addressModeU = sci.addressModeV = sci.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-	if (vkCreateSampler(vk.device, &sci, nullptr, &m_PostSampler) != VK_SUCCESS)
-		throw std::runtime_error("post sampler failed");
+	sci.addressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	m_PostSampler = SamplerCache::GetInstance().get(sci);
 
 	// depth sampler (no compare)
-	VkSamplerCreateInfo dsi{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+	SamplerDesc dsi;
 	dsi.magFilter = VK_FILTER_NEAREST; dsi.minFilter = VK_FILTER_NEAREST;
 	dsi.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
-	dsi.addressModeU = dsi.addressModeV = dsi.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-	dsi.compareEnable = VK_FALSE;
-	if (vkCreateSampler(vk.device, &dsi, nullptr, &m_PostDepthSampler) != VK_SUCCESS)
-		throw std::runtime_error("post depth sampler failed");
+	dsi.addressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	m_PostDepthSampler = SamplerCache::GetInstance().get(dsi);
 
 	// allocate sets
 	std::vector<VkDescriptorSetLayout> layouts(m_OffscreenTargets.size(), m_PostSetLayout);
@@ -1231,7 +1362,9 @@ void RendererManager::loadSettings()
 	m_EnableNormals = S.Get<bool>("renderer.showNormals", m_EnableNormals);
 	m_RenderDistance = S.Get<float>("renderer.renderDistance", m_RenderDistance);
 	m_EnableChunkDebug = S.Get<bool>("renderer.chunkDebug", m_EnableChunkDebug);
+	m_EnableMeshletCulling = S.Get<bool>("renderer.meshletCulling", m_EnableMeshletCulling);
 	m_ChunkRangeToRender = S.Get<float>("renderer.chunkRange", m_ChunkRangeToRender);
+	m_AssetLoadBudgetMs = S.Get<float>("assets.loadBudgetMs", m_AssetLoadBudgetMs);
 }
 
 void RendererManager::writePostDescriptors()
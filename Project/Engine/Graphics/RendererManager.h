@@ -2,6 +2,7 @@
 
 #include <vulkan/vulkan.h>
 #include <GLFW/glfw3.h>
+#include <chrono>
 #include <Engine/Scene/Scene.h>
 #include <Engine/Math/Camera.h>
 #include <Engine/Graphics/Pipeline.h>
@@ -68,7 +69,10 @@ private:
     Pipeline m_PipelinePostProcess;
     Pipeline m_PipelineNormals;
     bool m_EnableNormals = false;
+    bool m_EnableMeshletCulling = true;
     float m_RenderDistance{ 200.f };
+    float m_AssetLoadBudgetMs{ 2.f };   // main-thread time per frame for finishing async loads
+    float m_StreamFullResDistance{ 16.f };  // texture streaming: full resolution up to this chunk distance
     std::vector<RenderStage> m_RenderStages;
 
     VkRenderPass m_RenderPassOffscreen = VK_NULL_HANDLE; // scene (color+depth), final = COLOR_ATTACHMENT_OPTIMAL
@@ -154,4 +158,7 @@ private:
     bool       m_EnableChunkDebug = true;
     float       m_ChunkRangeToRender = 100.f;
     ImGuiLayer m_ImGui;
+
+    std::chrono::steady_clock::time_point m_StartTime; // FrameConstants::time
+
 };
@@ -0,0 +1,58 @@
+// SamplerCache.cpp
+#include "SamplerCache.h"
+#include <Engine/Graphics/vulkanVars.h>
+#include <algorithm>
+#include <stdexcept>
+
+VkSampler SamplerCache::get(const SamplerDesc& requested)
+{
+    auto& vulkan_vars = vulkanVars::GetInstance();
+
+    // Clamp first so settings above the device limit don't create duplicates
+    SamplerDesc desc = requested;
+    desc.maxAnisotropy = std::max(std::min(desc.maxAnisotropy, vulkan_vars.maxSamplerAnisotropy), 1.0f);
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (const auto& [key, sampler] : m_Samplers)
+        if (key == desc) return sampler;
+
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = desc.magFilter;
+    samplerInfo.minFilter = desc.minFilter;
+    samplerInfo.addressModeU = desc.addressMode;
+    samplerInfo.addressModeV = desc.addressMode;
+    samplerInfo.addressModeW = desc.addressMode;
+    samplerInfo.anisotropyEnable = desc.maxAnisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+    samplerInfo.maxAnisotropy = desc.maxAnisotropy;
+    samplerInfo.borderColor = desc.borderColor;
+    samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.compareEnable = VK_FALSE;
+    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+    samplerInfo.mipmapMode = desc.mipmapMode;
+    samplerInfo.mipLodBias = 0.0f;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+
+    VkSampler sampler;
+    if (vkCreateSampler(vulkan_vars.device, &samplerInfo, nullptr, &sampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create sampler!");
+    }
+    m_Samplers.emplace_back(desc, sampler);
+    return sampler;
+}
+
+size_t SamplerCache::getSamplerCount() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Samplers.size();
+}
+
+void SamplerCache::destroy()
+{
+    auto& vulkan_vars = vulkanVars::GetInstance();
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (const auto& [key, sampler] : m_Samplers)
+        vkDestroySampler(vulkan_vars.device, sampler, nullptr);
+    m_Samplers.clear();
+}
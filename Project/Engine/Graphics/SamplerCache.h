@@ -0,0 +1,45 @@
+// SamplerCache.h
+#pragma once
+#include <vulkan/vulkan.h>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <Engine/Core/Singleton.h>
+
+// Sampler state a VkSampler is created from. LOD is never clamped by the sampler (the image
+// view decides which levels exist), so textures with different mip counts share one sampler.
+struct SamplerDesc {
+    VkFilter magFilter = VK_FILTER_LINEAR;
+    VkFilter minFilter = VK_FILTER_LINEAR;
+    VkSamplerMipmapMode mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT; // U, V and W
+    float maxAnisotropy = 1.0f;        // <= 1 disables anisotropy; clamped to the device limit
+    VkBorderColor borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+
+    bool operator==(const SamplerDesc& o) const {
+        return magFilter == o.magFilter && minFilter == o.minFilter && mipmapMode == o.mipmapMode &&
+            addressMode == o.addressMode && maxAnisotropy == o.maxAnisotropy && borderColor == o.borderColor;
+    }
+};
+
+// One immutable VkSampler per distinct SamplerDesc, shared by every texture and pass that asks
+// for it. Textures and the PBR texture table reference samplers separately from their images,
+// so the number of samplers stays at a handful however many textures are loaded.
+class SamplerCache : public Singleton<SamplerCache> {
+public:
+    // Creates the sampler on first use; lives until destroy()
+    VkSampler get(const SamplerDesc& desc);
+
+    size_t getSamplerCount() const;
+
+    // Device must be idle
+    void destroy();
+
+private:
+    friend class Singleton<SamplerCache>;
+    SamplerCache() = default;
+
+    mutable std::mutex m_Mutex;
+    std::vector<std::pair<SamplerDesc, VkSampler>> m_Samplers; // few entries, linear search
+};
@@ -1,5 +1,4 @@
 #include "ShaderBase.h"
-#include <fstream>
 #include <stdexcept>
 #include <iostream>
 #include <glm\gtc\type_ptr.hpp>
@@ -7,6 +6,9 @@
 #include <Engine/Graphics/MaterialManager.h>
 #include <Engine/Graphics/Texture.h>
 #include <Engine/Graphics/TextureManager.h>
+#include <Engine/Graphics/PipelineLayoutCache.h>
+#include <Engine/Graphics/FrameUniforms.h>
+#include <Engine/Core/AssetArchive.h>
 #include <algorithm>
 #include <Engine/Scene/LineScene.h>
 #include <Engine/Scene/MeshScene.h>
@@ -14,12 +16,18 @@
 
 
 
-ShaderBase::ShaderBase(const std::string& vertexShaderPath, const std::string& fragmentShaderPath)
-    :vertexShaderModule_(VK_NULL_HANDLE), fragmentShaderModule_(VK_NULL_HANDLE)
+ShaderBase::ShaderBase(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, bool bindlessTextures, bool externalDescriptors)
+    :vertexShaderModule_(VK_NULL_HANDLE), fragmentShaderModule_(VK_NULL_HANDLE), m_ExternalDescriptors(externalDescriptors)
 {
+    m_BindlessTextures = bindlessTextures && vulkanVars::GetInstance().bindlessTextures;
+    m_TextureSlots = m_BindlessTextures ? vulkanVars::GetInstance().textureSlots : MAX_TEXTURES;
+
     vertexShaderCode_ = readFile(vertexShaderPath);
     fragmentShaderCode_ = readFile(fragmentShaderPath);
 
+    m_Reflection = ShaderReflection::Reflect(vertexShaderCode_, VK_SHADER_STAGE_VERTEX_BIT);
+    m_Reflection.merge(ShaderReflection::Reflect(fragmentShaderCode_, VK_SHADER_STAGE_FRAGMENT_BIT));
+
 
     m_Tex = TextureManager::GetInstance().getOrCreateTexture(kErrorTexturePath);
 }
@@ -47,52 +55,67 @@ void ShaderBase::initialize(const VkPhysicalDevice& vkPhysicalDevice, const VkDe
     m_VertexInputStateInfo.pVertexAttributeDescriptions =
         m_VkVertexInputAttributeDesc.data();
 
-    // --- Your existing UBO / descriptor setup (unchanged) ---
-    m_UBOBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-        UniformBufferObject ubo{};
-        ubo.view = glm::mat4(1.0f);
-        ubo.proj = glm::mat4(1.0f);
-
-        m_UBOBuffers[i] = std::make_unique<DataBuffer>(
-            vkPhysicalDevice,
-            vkDevice,
-            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            sizeof(ubo)
-        );
-        m_UBOBuffers[i]->upload(sizeof(ubo), &ubo);
+    if (m_ExternalDescriptors) return;
+
+    // Set 0 is the frame constants (FrameUniforms); the pipeline's own set 1 comes from reflection.
+    // Its uniform block (binding 0) lives in the frame ring at a dynamic offset. Runtime-sized
+    // arrays are the texture table (m_TextureSlots) or, for arrays of array images, the packed
+    // texture arrays (MAX_TEXTURE_ARRAYS); with descriptor indexing they are partially bound and
+    // written while sets are in use.
+    SetLayoutDesc layoutDesc;
+    for (const ReflectedBinding& r : m_Reflection.bindings) {
+        if (r.set == 0) {
+            if (r.binding != 0 || r.type != VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || r.size > sizeof(FrameConstants))
+                throw std::runtime_error("set 0 is reserved for the frame constants!");
+            continue;
+        }
+        if (r.set != 1) throw std::runtime_error("shaders may only use descriptor sets 0 and 1!");
+        VkDescriptorSetLayoutBinding b{};
+        b.binding = r.binding;
+        b.descriptorType = r.type;
+        b.descriptorCount = r.count != 0 ? r.count : (r.arrayedImage ? MAX_TEXTURE_ARRAYS : m_TextureSlots);
+        b.stageFlags = r.stages;
+        if (r.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) {
+            if (r.binding != 0 || r.count != 1) throw std::runtime_error("a pipeline's uniform block must be set 1, binding 0!");
+            b.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+            m_UniformBlockSize = r.size;
+        }
+        layoutDesc.bindings.push_back(b);
+        layoutDesc.bindingFlags.push_back(r.count == 0 && m_BindlessTextures
+            ? VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT : 0);
     }
-
-    m_DescriptorPool = { vkDevice, sizeof(UniformBufferObject), MAX_FRAMES_IN_FLIGHT };
-    m_DescriptorPool.Initialize(vkDevice);
-
-    std::vector<VkBuffer> buffers;
-    std::vector<std::vector<VkDescriptorImageInfo>> imagesPerFrame(MAX_FRAMES_IN_FLIGHT);
-
-    const auto& defaultTexture = TextureManager::GetInstance().getStandardTexture();
-    auto cachedTextures = TextureManager::GetInstance().getAllCachedTextures(); // copy is fine
-    buffers.reserve(MAX_FRAMES_IN_FLIGHT);
-
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-        buffers.push_back(m_UBOBuffers[i]->getVkBuffer());
-        imagesPerFrame[i].resize(MAX_TEXTURES);
-
-        for (size_t j = 0; j < MAX_TEXTURES; ++j) {
-            if (j < cachedTextures.size() && cachedTextures[j]) {
-                imagesPerFrame[i][j] = cachedTextures[j]->getDescriptorInfo();
-            }
-            else if (defaultTexture) {
-                imagesPerFrame[i][j] = defaultTexture->getDescriptorInfo();
-            }
-            else {
-                imagesPerFrame[i][j] = VkDescriptorImageInfo{};
-            }
+    // Nothing of its own: the pipeline layout is set 0 alone
+    if (layoutDesc.bindings.empty()) return;
+    m_DescriptorSetLayout = PipelineLayoutCache::GetInstance().getSetLayout(layoutDesc);
+
+    m_DescriptorPool = DescriptorPool(vkDevice, m_UniformBlockSize, MAX_FRAMES_IN_FLIGHT, m_DescriptorSetLayout, layoutDesc);
+
+    // Every slot starts out as the standard texture, then the textures that exist already go to
+    // their slot (= ID; 0 is the standard texture itself). Later ones arrive through updateTextureSlots.
+    std::vector<VkDescriptorImageInfo> table;
+    if (const auto defaultTexture = TextureManager::GetInstance().getStandardTexture()) {
+        table.assign(m_TextureSlots, defaultTexture->getDescriptorInfo());
+        for (const auto& texture : TextureManager::GetInstance().getAllCachedTextures()) {
+            const uint32_t id = texture ? texture->getID() : 0;
+            if (id != 0 && id < m_TextureSlots && texture->isResident()) table[id] = texture->getDescriptorInfo();
         }
     }
 
-    m_DescriptorPool.createDescriptorSets(buffers, imagesPerFrame);
-
+    m_TextureSampler = Texture::GetMaterialSampler();
+    m_DescriptorPool.createDescriptorSets(FrameUniforms::GetInstance().getBuffer(), std::vector<std::vector<VkDescriptorImageInfo>>(MAX_FRAMES_IN_FLIGHT, table), m_TextureSampler);
+
+    // Arrays of packed textures have their own binding; it's partially bound, so only existing ones get written
+    if (m_BindlessTextures) {
+        std::vector<TextureSlot> arrays;
+        for (const auto& texture : TextureManager::GetInstance().getAllCachedTextures()) {
+            if (!texture || !texture->isPacked()) continue;
+            const uint32_t arrayID = texture->getArrayID();
+            if (std::none_of(arrays.begin(), arrays.end(), [&](const TextureSlot& s) { return s.slot == arrayID; }))
+                arrays.push_back({ arrayID, texture->getArray()->getDescriptorInfo(), 3 });
+        }
+        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT && !arrays.empty(); ++i)
+            m_DescriptorPool.writeTextures(i, arrays);
+    }
 }
 
 ShaderBase::~ShaderBase() {
@@ -101,14 +124,9 @@ ShaderBase::~ShaderBase() {
 
 void ShaderBase::Destroy(const VkDevice& vkDevice)
 {
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        m_UBOBuffers[i]->destroy(vkDevice);
-    }
-
+    // The set layout belongs to PipelineLayoutCache
     m_DescriptorPool.Destroy(vkDevice);
 
-    vkDestroyDescriptorSetLayout(vkDevice, m_DescriptorSetLayout, nullptr);
-    
 }
 
 void ShaderBase::initialize(const VkPhysicalDevice& vkPhysicalDevice, const VkDevice& vkDevice, const VkVertexInputBindingDescription& vkVertexInputBindingDesc, std::vector<VkVertexInputAttributeDescription>& vkVertexInputAttributeDesc) {
@@ -117,105 +135,34 @@ void ShaderBase::initialize(const VkPhysicalDevice& vkPhysicalDevice, const VkDe
 
 }
 
-void ShaderBase::updateDescriptorSet()
+void ShaderBase::updateTextureSlots(size_t frameIndex, const std::vector<TextureSlot>& slots)
 {
-    auto& vulkan_vars = vulkanVars::GetInstance();
-    m_UBOBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        UniformBufferObject ubo{};
-        ubo.view = glm::mat4{ {1,0,0,0},{0,1,0,0},{0,0,1,0},{0,0,0,1} };
-        ubo.proj = glm::mat4{ {1,0,0,0},{0,1,0,0},{0,0,1,0},{0,0,0,1} };
-
-        m_UBOBuffers[i] = std::make_unique<DataBuffer>(
-            vulkan_vars.physicalDevice,
-            vulkan_vars.device,
-            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            sizeof(ubo)
-        );
-
-        m_UBOBuffers[i]->upload(sizeof(ubo), &ubo);
-
-
+    // Each set only changes while its frame is not in flight; later writes to a slot win
+    for (auto& pending : m_PendingTextureSlots)
+        pending.insert(pending.end(), slots.begin(), slots.end());
+
+    const size_t set = frameIndex % MAX_FRAMES_IN_FLIGHT;
+    if (m_PendingSampler[set]) {
+        m_DescriptorPool.writeSampler(set, m_TextureSampler);
+        m_PendingSampler[set] = false;
     }
 
-
-
-    m_DescriptorPool = { vulkan_vars.device, sizeof(UniformBufferObject), MAX_FRAMES_IN_FLIGHT };
-    m_DescriptorPool.Initialize(vulkan_vars.device);
-    std::vector<VkBuffer> buffers{};
-    std::vector<VkDescriptorImageInfo> images{};
-    std::vector<std::vector<VkDescriptorImageInfo>> imagesPerFrame(MAX_FRAMES_IN_FLIGHT);
-
-    auto& texmanager = TextureManager::GetInstance();
-
-    const auto& defaultTexture = texmanager.getStandardTexture();
-    auto& cachedTextures = texmanager.getAllCachedTextures();
-
-    std::sort(
-        cachedTextures.begin(),
-        cachedTextures.end(),
-        [](const std::shared_ptr<Texture>& a, const std::shared_ptr<Texture>& b) {
-            return a->getID() < b->getID();
-        }
-    );
-
-    size_t numTextures = cachedTextures.size();
-
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        buffers.push_back(m_UBOBuffers[i]->getVkBuffer());
-
-        imagesPerFrame[i].resize(MAX_TEXTURES);
-        for (size_t j = 0; j < MAX_TEXTURES; ++j) {
-            if (j < cachedTextures.size() && cachedTextures[j] ) {
-                imagesPerFrame[i][j] = cachedTextures[j]->getDescriptorInfo();
-            }
-            else if (defaultTexture) {
-                imagesPerFrame[i][j] = defaultTexture->getDescriptorInfo();
-            }
-            else {
-                imagesPerFrame[i][j] = VkDescriptorImageInfo{};
-            }
-        }
-    }
-
-    m_DescriptorPool.createDescriptorSets(buffers, imagesPerFrame);
+    auto& mine = m_PendingTextureSlots[set];
+    if (mine.empty()) return;
+    m_DescriptorPool.writeTextures(set, mine);
+    mine.clear();
 }
 
-void ShaderBase::createDescriptorSetLayout(const VkDevice& vkDevice)
+void ShaderBase::setTextureSampler(VkSampler sampler)
 {
-    // Uniform Buffer (binding 0)
-    VkDescriptorSetLayoutBinding uboLayoutBinding{};
-    uboLayoutBinding.binding = 0;
-    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    uboLayoutBinding.descriptorCount = 1;
-    uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-    uboLayoutBinding.pImmutableSamplers = nullptr;
-
-    // Combined Image Sampler (binding 1)
-    VkDescriptorSetLayoutBinding samplerLayoutBinding{};
-    samplerLayoutBinding.binding = 1;
-    samplerLayoutBinding.descriptorCount = MAX_TEXTURES;
-    samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    samplerLayoutBinding.pImmutableSamplers = nullptr;
-    samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-
-    std::vector<VkDescriptorSetLayoutBinding> bindings = { uboLayoutBinding, samplerLayoutBinding };
-
-    VkDescriptorSetLayoutCreateInfo layoutInfo{};
-    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-    layoutInfo.pBindings = bindings.data();
-
-    if (vkCreateDescriptorSetLayout(vkDevice, &layoutInfo, nullptr, &m_DescriptorSetLayout) != VK_SUCCESS) {
-        throw std::runtime_error("failed to create descriptor set layout!");
-    }
+    if (sampler == m_TextureSampler) return;
+    m_TextureSampler = sampler;
+    m_PendingSampler.fill(true);
 }
 
-void ShaderBase::bindDescriptorSet(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, size_t index)
+void ShaderBase::bindDescriptorSet(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, size_t index, uint32_t uniformOffset)
 {
-    m_DescriptorPool.bindDescriptorSet(commandBuffer, pipelineLayout, index);
+    m_DescriptorPool.bindDescriptorSet(commandBuffer, pipelineLayout, index, 1, m_UniformBlockSize > 0 ? 1 : 0, &uniformOffset);
 }
 
 VkPipelineShaderStageCreateInfo ShaderBase::getVertexShaderStageInfo()  {
@@ -236,21 +183,21 @@ VkPipelineShaderStageCreateInfo ShaderBase::getFragmentShaderStageInfo()  {
     return info;
 }
 
+VkPipelineShaderStageCreateInfo ShaderBase::createFragmentShaderStageInfo(const std::string& path) {
+    VkPipelineShaderStageCreateInfo info = getFragmentShaderStageInfo();
+    info.module = createShaderModule(readFile(path));
+    return info;
+}
+
 std::vector<char> ShaderBase::readFile(const std::string& filename) {
-    std::ifstream file(filename, std::ios::ate | std::ios::binary);
+    // Mounted archive first, loose file otherwise
+    const AssetData file = AssetArchive::Open(filename);
 
-    if (!file.is_open()) {
+    if (!file) {
         throw std::runtime_error("failed to open file!");
     }
 
-    size_t fileSize = (size_t)file.tellg();
-    std::vector<char> buffer(fileSize);
-
-    file.seekg(0);
-    file.read(buffer.data(), fileSize);
-
-    file.close();
-    return buffer;
+    return std::vector<char>(file.data, file.data + file.size);
 }
 
 VkShaderModule ShaderBase::createShaderModule(const std::vector<char>& code) {
@@ -283,10 +230,4 @@ VkPipelineInputAssemblyStateCreateInfo& ShaderBase::getInputAssemblyStateInfo(Vk
     return m_VkPipelineInputAssemblyStateCreateInfo;
 }
 
-void ShaderBase::updateUniformBuffer(uint32_t currentImage, UniformBufferObject& ubo) {
-    if (m_UBOBuffers.size() > currentImage) {
-        m_UBOBuffers[currentImage]->remap(sizeof(ubo), &ubo);
-    }   
-}
-
 
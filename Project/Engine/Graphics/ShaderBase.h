@@ -10,15 +10,19 @@
 #include <array>
 #include <Engine/Graphics/DataBuffer.h>
 #include <Engine/Graphics/DescriptorPool.h>
-#include <Engine/Graphics/UniformBufferObject.h>
+#include <Engine/Graphics/ShaderReflection.h>
 
 #include <memory>
 #include <Engine/Graphics/Texture.h>
+#include <Engine/Graphics/vulkanVars.h>
 
 class ShaderBase {
 public:
     ShaderBase() {};
-    ShaderBase( const std::string& vertexShaderPath, const std::string& fragmentShaderPath);
+    // bindlessTextures: the texture table gets vulkanVars::textureSlots update-after-bind entries
+    // instead of MAX_TEXTURES (only when the device has descriptor indexing).
+    // externalDescriptors: the pipeline binds sets of its own, so no UBOs, pool or sets here.
+    ShaderBase( const std::string& vertexShaderPath, const std::string& fragmentShaderPath, bool bindlessTextures = false, bool externalDescriptors = false);
     void initialize(const VkPhysicalDevice& vkPhysicalDevice,
         const VkDevice& vkDevice,
         const std::vector<VkVertexInputBindingDescription>& bindings,
@@ -29,17 +33,27 @@ public:
 
     void initialize(const VkPhysicalDevice& vkPhysicalDevice, const VkDevice& vkDevice, const VkVertexInputBindingDescription& vkVertexInputBindingDesc, std::vector<VkVertexInputAttributeDescription>& vkVertexInputAttributeDesc);
 
-    void createDescriptorSetLayout(const VkDevice& vkDevice);
+    // Bindings and push constants both stages declare
+    const ShaderReflection& getReflection() const { return m_Reflection; }
+    // The pipeline's own set 1 exactly as the stages declare it (shared through PipelineLayoutCache);
+    // VK_NULL_HANDLE if they only read the frame constants. Valid after initialize.
     const VkDescriptorSetLayout& getDescriptorSetLayout()
     {
         return m_DescriptorSetLayout;
     }
-    void bindDescriptorSet(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, size_t index);
-
-    void updateUniformBuffer(uint32_t currentImage, UniformBufferObject& ubo);
-    void updateDescriptorSet();
+    // Set 1 of frame 'index'; 'uniformOffset' places the uniform block in the frame ring (FrameUniforms::push)
+    void bindDescriptorSet(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, size_t index, uint32_t uniformOffset = 0);
+    // Bytes of the set 1 uniform block, 0 if the shaders declare none
+    uint32_t getUniformBlockSize() const { return m_UniformBlockSize; }
+    // Texture table changes: written into the set of 'frameIndex' now (its last use has finished)
+    // and into every other frame's set when that frame comes around
+    void updateTextureSlots(size_t frameIndex, const std::vector<TextureSlot>& slots);
+    // Sampler for the whole table; reaches each frame's set through updateTextureSlots like a slot
+    void setTextureSampler(VkSampler sampler);
     VkPipelineShaderStageCreateInfo getVertexShaderStageInfo() ;
     VkPipelineShaderStageCreateInfo getFragmentShaderStageInfo() ;
+    // Another fragment stage for the same vertex stage (Pipeline fallbacks); caller destroys the module
+    VkPipelineShaderStageCreateInfo createFragmentShaderStageInfo(const std::string& path);
     VkPipelineVertexInputStateCreateInfo& getVertexInputStateInfo() ;
     VkPipelineInputAssemblyStateCreateInfo& getInputAssemblyStateInfo(VkPrimitiveTopology topology) ;
 
@@ -58,10 +72,15 @@ private:
     VkPipelineVertexInputStateCreateInfo m_VertexInputStateInfo{};
 
     VkDescriptorSetLayout m_DescriptorSetLayout{};
-    std::vector<std::unique_ptr<DataBuffer>> m_UBOBuffers{};
-
-    UniformBufferObject m_UBOSrc{};
+    ShaderReflection m_Reflection{};
+    bool m_ExternalDescriptors = false;
     DescriptorPool m_DescriptorPool{};
+    uint32_t m_UniformBlockSize = 0;
+    uint32_t m_TextureSlots = MAX_TEXTURES;
+    bool m_BindlessTextures = false;
+    std::array<std::vector<TextureSlot>, MAX_FRAMES_IN_FLIGHT> m_PendingTextureSlots{};
+    VkSampler m_TextureSampler = VK_NULL_HANDLE;
+    std::array<bool, MAX_FRAMES_IN_FLIGHT> m_PendingSampler{};
 
 
     std::vector<char> readFile(const std::string& filename);
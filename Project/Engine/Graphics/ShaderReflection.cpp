@@ -0,0 +1,271 @@
+// ShaderReflection.cpp
+#include "ShaderReflection.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    // The few parts of the SPIR-V specification the reflection needs
+    constexpr uint32_t SpirvMagic = 0x07230203;
+
+    enum Op : uint32_t {
+        OpTypeBool = 20, OpTypeInt = 21, OpTypeFloat = 22, OpTypeVector = 23, OpTypeMatrix = 24,
+        OpTypeImage = 25, OpTypeSampler = 26, OpTypeSampledImage = 27, OpTypeArray = 28,
+        OpTypeRuntimeArray = 29, OpTypeStruct = 30, OpTypePointer = 32, OpConstant = 43,
+        OpSpecConstant = 50, OpVariable = 59, OpDecorate = 71, OpMemberDecorate = 72
+    };
+
+    enum Decoration : uint32_t {
+        DecorationBufferBlock = 3, DecorationArrayStride = 6, DecorationMatrixStride = 7,
+        DecorationBinding = 33, DecorationDescriptorSet = 34, DecorationOffset = 35
+    };
+
+    enum StorageClass : uint32_t {
+        StorageUniformConstant = 0, StorageUniform = 2, StoragePushConstant = 9, StorageStorageBuffer = 12
+    };
+
+    constexpr uint32_t DimBuffer = 5;
+    constexpr uint32_t DimSubpassData = 6;
+    constexpr uint32_t Unset = UINT32_MAX;
+
+    // Everything recorded about one result id
+    struct Id {
+        uint32_t opcode = 0;
+        std::vector<uint32_t> operands;            // words after the result id (types, constants, variables)
+        uint32_t set = Unset;
+        uint32_t binding = Unset;
+        uint32_t arrayStride = 0;
+        bool bufferBlock = false;
+        std::vector<uint32_t> memberOffsets;
+        std::vector<uint32_t> memberMatrixStrides;
+    };
+
+    class Module {
+    public:
+        explicit Module(const std::vector<char>& spirv)
+        {
+            if (spirv.size() < 5 * sizeof(uint32_t) || spirv.size() % sizeof(uint32_t) != 0)
+                throw std::runtime_error("shader is not a SPIR-V module!");
+            m_Words.resize(spirv.size() / sizeof(uint32_t));
+            std::memcpy(m_Words.data(), spirv.data(), spirv.size());
+            if (m_Words[0] != SpirvMagic) throw std::runtime_error("shader is not a SPIR-V module!");
+            m_Ids.resize(m_Words[3]);
+
+            for (size_t i = 5; i < m_Words.size();) {
+                const uint32_t count = m_Words[i] >> 16;
+                const uint32_t op = m_Words[i] & 0xFFFF;
+                if (count == 0 || i + count > m_Words.size())
+                    throw std::runtime_error("truncated SPIR-V instruction!");
+                parse(op, &m_Words[i], count);
+                i += count;
+            }
+        }
+
+        const Id& at(uint32_t id) const
+        {
+            if (id >= m_Ids.size()) throw std::runtime_error("SPIR-V id out of bounds!");
+            return m_Ids[id];
+        }
+
+        const std::vector<uint32_t>& variables() const { return m_Variables; }
+
+        uint32_t constant(uint32_t id) const
+        {
+            const Id& c = at(id);
+            return (c.opcode == OpConstant || c.opcode == OpSpecConstant) && !c.operands.empty() ? c.operands[0] : 1;
+        }
+
+        // Bytes a value of 'type' occupies in a block with explicit layout (push constants)
+        uint32_t sizeOf(uint32_t type, uint32_t matrixStride = 0) const
+        {
+            const Id& t = at(type);
+            switch (t.opcode) {
+            case OpTypeBool: return 4;
+            case OpTypeInt:
+            case OpTypeFloat: return t.operands[0] / 8;
+            case OpTypeVector: return t.operands[1] * sizeOf(t.operands[0]);
+            case OpTypeMatrix: return t.operands[1] * (matrixStride ? matrixStride : sizeOf(t.operands[0]));
+            case OpTypeArray: return constant(t.operands[1]) * (t.arrayStride ? t.arrayStride : sizeOf(t.operands[0]));
+            case OpTypeStruct: {
+                uint32_t size = 0;
+                for (size_t m = 0; m < t.operands.size(); ++m) {
+                    const uint32_t offset = m < t.memberOffsets.size() ? t.memberOffsets[m] : size;
+                    const uint32_t stride = m < t.memberMatrixStrides.size() ? t.memberMatrixStrides[m] : 0;
+                    size = std::max(size, offset + sizeOf(t.operands[m], stride));
+                }
+                return size;
+            }
+            default: return 0;
+            }
+        }
+
+    private:
+        Id& mut(uint32_t id)
+        {
+            if (id >= m_Ids.size()) throw std::runtime_error("SPIR-V id out of bounds!");
+            return m_Ids[id];
+        }
+
+        void parse(uint32_t op, const uint32_t* w, uint32_t count)
+        {
+            switch (op) {
+            case OpDecorate: {
+                if (count < 3) break;
+                Id& id = mut(w[1]);
+                const uint32_t value = count > 3 ? w[3] : 0;
+                switch (w[2]) {
+                case DecorationDescriptorSet: id.set = value; break;
+                case DecorationBinding: id.binding = value; break;
+                case DecorationArrayStride: id.arrayStride = value; break;
+                case DecorationBufferBlock: id.bufferBlock = true; break;
+                default: break;
+                }
+                break;
+            }
+            case OpMemberDecorate: {
+                if (count < 5) break;
+                Id& id = mut(w[1]);
+                const uint32_t member = w[2];
+                if (w[3] == DecorationOffset) {
+                    if (id.memberOffsets.size() <= member) id.memberOffsets.resize(member + 1, 0);
+                    id.memberOffsets[member] = w[4];
+                }
+                else if (w[3] == DecorationMatrixStride) {
+                    if (id.memberMatrixStrides.size() <= member) id.memberMatrixStrides.resize(member + 1, 0);
+                    id.memberMatrixStrides[member] = w[4];
+                }
+                break;
+            }
+            case OpTypeBool: case OpTypeInt: case OpTypeFloat: case OpTypeVector: case OpTypeMatrix:
+            case OpTypeImage: case OpTypeSampler: case OpTypeSampledImage: case OpTypeArray:
+            case OpTypeRuntimeArray: case OpTypeStruct: case OpTypePointer: {
+                Id& id = mut(w[1]);
+                id.opcode = op;
+                id.operands.assign(w + 2, w + count);
+                break;
+            }
+            case OpConstant:
+            case OpSpecConstant: {
+                if (count < 4) break;
+                Id& id = mut(w[2]);
+                id.opcode = op;
+                id.operands.assign(w + 3, w + count);
+                break;
+            }
+            case OpVariable: {
+                if (count < 4) break;
+                Id& id = mut(w[2]);
+                id.opcode = op;
+                id.operands = { w[1], w[3] };   // pointer type, storage class
+                m_Variables.push_back(w[2]);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+
+        std::vector<uint32_t> m_Words;
+        std::vector<Id> m_Ids;
+        std::vector<uint32_t> m_Variables;
+    };
+
+    bool ByLocation(const ReflectedBinding& a, const ReflectedBinding& b)
+    {
+        return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+    }
+}
+
+ShaderReflection ShaderReflection::Reflect(const std::vector<char>& spirv, VkShaderStageFlagBits stage)
+{
+    const Module module(spirv);
+    ShaderReflection result;
+
+    for (uint32_t v : module.variables()) {
+        const Id& var = module.at(v);
+        const Id& pointer = module.at(var.operands[0]);
+        if (pointer.opcode != OpTypePointer || pointer.operands.size() < 2) continue;
+        const uint32_t storage = var.operands[1];
+        uint32_t type = pointer.operands[1];
+
+        if (storage == StoragePushConstant) {
+            result.pushConstantSize = std::max(result.pushConstantSize, module.sizeOf(type));
+            result.pushConstantStages |= stage;
+            continue;
+        }
+        if (storage != StorageUniformConstant && storage != StorageUniform && storage != StorageStorageBuffer) continue;
+        if (var.set == Unset || var.binding == Unset) continue;
+
+        ReflectedBinding b;
+        b.set = var.set;
+        b.binding = var.binding;
+        b.stages = stage;
+
+        // Arrays of descriptors; arrays of arrays flatten into one binding
+        while (module.at(type).opcode == OpTypeArray || module.at(type).opcode == OpTypeRuntimeArray) {
+            const Id& array = module.at(type);
+            if (array.opcode == OpTypeRuntimeArray) b.count = 0;
+            else if (b.count != 0) b.count *= module.constant(array.operands[1]);
+            type = array.operands[0];
+        }
+
+        const Id& t = module.at(type);
+        switch (t.opcode) {
+        case OpTypeSampler:
+            b.type = VK_DESCRIPTOR_TYPE_SAMPLER;
+            break;
+        case OpTypeSampledImage:
+            b.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            b.arrayedImage = module.at(t.operands[0]).operands.size() > 3 && module.at(t.operands[0]).operands[3] == 1;
+            break;
+        case OpTypeImage: {
+            // operands: sampled type, dim, depth, arrayed, multisampled, sampled (2 = storage), format
+            if (t.operands.size() < 7) continue;
+            const uint32_t dim = t.operands[1];
+            const bool storageImage = t.operands[5] == 2;
+            if (dim == DimBuffer) b.type = storageImage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+            else if (dim == DimSubpassData) b.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            else b.type = storageImage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            b.arrayedImage = t.operands[3] == 1;
+            break;
+        }
+        case OpTypeStruct:
+            b.type = (storage == StorageStorageBuffer || t.bufferBlock) ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            b.size = module.sizeOf(type);
+            break;
+        default:
+            continue;   // nothing a set layout here can describe
+        }
+
+        ShaderReflection single;
+        single.bindings.push_back(b);
+        result.merge(single);
+    }
+
+    return result;
+}
+
+void ShaderReflection::merge(const ShaderReflection& other)
+{
+    for (const ReflectedBinding& b : other.bindings) {
+        auto it = std::find_if(bindings.begin(), bindings.end(),
+            [&](const ReflectedBinding& mine) { return mine.set == b.set && mine.binding == b.binding; });
+        if (it == bindings.end()) {
+            bindings.push_back(b);
+            continue;
+        }
+        if (it->type != b.type) {
+            throw std::runtime_error("shader stages disagree on the descriptor type of set " + std::to_string(b.set) +
+                ", binding " + std::to_string(b.binding) + "!");
+        }
+        it->stages |= b.stages;
+        it->count = (it->count == 0 || b.count == 0) ? 0 : std::max(it->count, b.count);
+        it->arrayedImage = it->arrayedImage || b.arrayedImage;
+        it->size = std::max(it->size, b.size);
+    }
+    std::sort(bindings.begin(), bindings.end(), ByLocation);
+
+    pushConstantSize = std::max(pushConstantSize, other.pushConstantSize);
+    pushConstantStages |= other.pushConstantStages;
+}
@@ -0,0 +1,31 @@
+// ShaderReflection.h
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+// One descriptor a shader module declares
+struct ReflectedBinding {
+    uint32_t set = 0;
+    uint32_t binding = 0;
+    VkDescriptorType type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    uint32_t count = 1;             // array length; 0 = runtime-sized (whoever builds the layout sizes it)
+    bool arrayedImage = false;      // the image type is an array itself (texture2DArray, ...)
+    uint32_t size = 0;              // buffers: bytes the block declares
+    VkShaderStageFlags stages = 0;
+};
+
+// Resource interface of compiled SPIR-V, read straight from the module: the descriptors it
+// declares and the size of its push constant block. Pipeline layouts are built from this
+// instead of a fixed layout, so a pipeline only gets what its stages actually declare.
+struct ShaderReflection {
+    std::vector<ReflectedBinding> bindings;   // sorted by set, then binding
+    uint32_t pushConstantSize = 0;            // 0 = no push constant block
+    VkShaderStageFlags pushConstantStages = 0;
+
+    // Throws std::runtime_error when 'spirv' isn't a valid module
+    static ShaderReflection Reflect(const std::vector<char>& spirv, VkShaderStageFlagBits stage);
+
+    // Adds another stage of the same pipeline; stages that share a binding must agree on its type
+    void merge(const ShaderReflection& other);
+};
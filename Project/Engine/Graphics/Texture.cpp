@@ -4,25 +4,199 @@
 #include <cstring>
 #include <Engine/Graphics/vulkanVars.h>
 #include <Engine/Graphics/DataBuffer.h>
+#include <Engine/Graphics/SamplerCache.h>
+#include <Engine/ObjUtils/CookedAssets.h>
+#include <Engine/Core/AssetArchive.h>
+#include <algorithm>
+#include <vector>
 #include <iostream>
+#ifdef VR_WITH_BASISU
+#include <basisu_transcoder.h>
+#include <mutex>
+#endif
 
 
 
-std::atomic<uint32_t> Texture::s_NextID = 0;
+Texture::IDPool Texture::s_IDs;
+Texture::IDPool Texture::s_ArrayIDs;
+std::atomic<bool> Texture::s_GenerateMips = true;
+std::atomic<float> Texture::s_MaxAnisotropy = 16.0f;
+std::atomic<bool> Texture::s_Streaming = false;
+std::atomic<uint32_t> Texture::s_StreamResidentSize = 128;
 
-Texture::Texture(const std::string& filename)
+// Bytes of one level of 'format' (RGBA8 or one of the BC formats KTX2 files may hold)
+static size_t MipSize(VkFormat format, uint32_t width, uint32_t height)
+{
+    return ObjUtils::Ktx2LevelSize(static_cast<ObjUtils::Ktx2Format>(format), width, height);
+}
+
+#ifdef VR_WITH_BASISU
+// Basis Universal payload (ETC1S or UASTC) -> BC7, or RGBA8 when the device can't sample BC
+static TextureImage TranscodeBasis(const ObjUtils::Ktx2Texture& ktx, const std::string& name)
+{
+    static std::once_flag init;
+    std::call_once(init, [] { basist::basisu_transcoder_init(); });
+
+    basist::ktx2_transcoder transcoder;
+    if (!transcoder.init(ktx.file.data, static_cast<uint32_t>(ktx.file.size)) || !transcoder.start_transcoding()) {
+        std::cerr << "[Texture] \"" << name << "\": Basis transcoder rejected the file\n";
+        return {};
+    }
+
+    TextureImage image{};
+    const bool bc = vulkanVars::GetInstance().textureCompressionBC;
+    const bool srgb = transcoder.get_dfd_transfer_func() == 2; // KHR_DF_TRANSFER_SRGB
+    const basist::transcoder_texture_format target =
+        bc ? basist::transcoder_texture_format::cTFBC7_RGBA : basist::transcoder_texture_format::cTFRGBA32;
+    image.format = bc ? (srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK)
+        : (srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM);
+    image.width = static_cast<int>(transcoder.get_width());
+    image.height = static_cast<int>(transcoder.get_height());
+    image.mipLevels = std::max(transcoder.get_levels(), 1u);
+
+    auto buffer = std::make_shared<std::vector<unsigned char>>();
+    for (uint32_t level = 0; level < image.mipLevels; ++level) {
+        const uint32_t width = std::max(uint32_t(image.width) >> level, 1u);
+        const uint32_t height = std::max(uint32_t(image.height) >> level, 1u);
+        const size_t size = MipSize(image.format, width, height);
+        const size_t at = buffer->size();
+        buffer->resize(at + size);
+        // Output size is counted in blocks for BC and in pixels for RGBA32
+        const uint32_t units = bc ? uint32_t(size / 16) : width * height;
+        if (!transcoder.transcode_image_level(level, 0, 0, buffer->data() + at, units, target)) {
+            std::cerr << "[Texture] \"" << name << "\": failed to transcode level " << level << "\n";
+            return {};
+        }
+    }
+    image.size = buffer->size();
+    image.pixels = std::shared_ptr<unsigned char>(buffer, buffer->data());
+    return image;
+}
+#endif
+
+// KTX2 levels as they sit in the file (no copy). Empty if the device can't sample the format,
+// or for Basis payloads without VR_BASISU.
+static TextureImage FromKtx2(const ObjUtils::Ktx2Texture& ktx, const std::string& name)
+{
+    if (ktx.format == ObjUtils::Ktx2Format::Undefined) {
+#ifdef VR_WITH_BASISU
+        return TranscodeBasis(ktx, name);
+#else
+        (void)name;
+        return {};
+#endif
+    }
+    if (ObjUtils::Ktx2IsBlockCompressed(ktx.format) && !vulkanVars::GetInstance().textureCompressionBC)
+        return {};
+
+    TextureImage image{};
+    image.width = static_cast<int>(ktx.width);
+    image.height = static_cast<int>(ktx.height);
+    image.format = static_cast<VkFormat>(ktx.format);
+    image.mipLevels = static_cast<uint32_t>(ktx.levels.size());
+    for (const ObjUtils::Ktx2Level& level : ktx.levels) {
+        image.mipOffsets.push_back(size_t(level.data - ktx.file.data));
+        image.size += level.size;
+    }
+    // aliasing pointer: keeps the file alive for as long as the pixels are referenced
+    image.pixels = std::shared_ptr<unsigned char>(ktx.file.owner, const_cast<unsigned char*>(ktx.file.data));
+    return image;
+}
+
+Texture::Texture(const std::string& filename, ObjUtils::TextureRole role)
+{
+    init(Decode(filename, role), filename);
+}
+
+Texture::Texture(const TextureImage& image, const std::string& filename)
+{
+    init(image, filename);
+}
+
+TextureImage Texture::Decode(const std::string& filename, ObjUtils::TextureRole role)
+{
+    // Cooked package: mip chain straight from the mapping, no decode. BC data needs the device
+    // feature; without it the source image is decoded as usual.
+    ObjUtils::Ktx2Texture ktx;
+    if (ObjUtils::LoadCookedTexture(filename, role, ktx)) {
+        TextureImage image = FromKtx2(ktx, filename);
+        if (image.pixels) return image;
+    }
+
+    // From the archive or the loose file: KTX2 as is, anything else through stbi
+    const AssetData file = AssetArchive::Open(filename);
+    if (!file) return {};
+    if (ObjUtils::IsKTX2(file.data, file.size)) {
+        if (!ObjUtils::ParseKTX2(file, ktx, filename)) return {};
+        TextureImage image = FromKtx2(ktx, filename);
+        if (!image.pixels)
+            std::cerr << "[Texture] \"" << filename << "\": format not supported on this device/build\n";
+        return image;
+    }
+
+    TextureImage image = DecodeMemory(file.data, file.size);
+    // Normal and data maps hold linear values; sampling them as sRGB would bend them
+    if (role != ObjUtils::TextureRole::Color)
+        image.format = VK_FORMAT_R8G8B8A8_UNORM;
+    return image;
+}
+
+TextureImage Texture::DecodeMemory(const unsigned char* data, size_t size)
+{
+    TextureImage image{};
+    int texChannels = 0;
+    stbi_uc* pixels = stbi_load_from_memory(data, static_cast<int>(size), &image.width, &image.height, &texChannels, STBI_rgb_alpha);
+    if (pixels) {
+        image.pixels = std::shared_ptr<unsigned char>(pixels, stbi_image_free);
+        image.size = size_t(image.width) * image.height * 4;
+    }
+    return image;
+}
+
+TextureImage Texture::ExtractChannel(const TextureImage& image, int channel)
+{
+    TextureImage out{};
+    if (!image.pixels || channel < 0 || channel > 3) return out;
+    if (image.format != VK_FORMAT_R8G8B8A8_SRGB && image.format != VK_FORMAT_R8G8B8A8_UNORM) return out;
+    if (image.mipLevels != 1 || !image.mipOffsets.empty()) return out;
+    const size_t count = static_cast<size_t>(image.width) * image.height;
+    out.width = image.width;
+    out.height = image.height;
+    out.format = VK_FORMAT_R8G8B8A8_UNORM; // a single data channel, not a color
+    out.pixels = std::shared_ptr<unsigned char>(new unsigned char[count * 4], std::default_delete<unsigned char[]>());
+    out.size = count * 4;
+
+    const unsigned char* src = image.pixels.get();
+    unsigned char* dst = out.pixels.get();
+    for (size_t i = 0; i < count; ++i) {
+        const unsigned char v = src[i * 4 + channel];
+        dst[i * 4 + 0] = v;
+        dst[i * 4 + 1] = v;
+        dst[i * 4 + 2] = v;
+        dst[i * 4 + 3] = 255;
+    }
+    return out;
+}
+
+void Texture::init(const TextureImage& image, const std::string& filename)
+{
+    m_ID = AcquireID();
+    upload(image, filename);
+}
+
+void Texture::upload(const TextureImage& image, const std::string& filename)
 {
-    m_ID = s_NextID;
-    s_NextID += 1;
     try {
-        createTextureImage(filename);
+        createTextureImage(beginStreaming(image));
     }
     catch (const std::exception& e) {
         std::cerr << "Texture load failed for: " << filename
             << ". Error: " << e.what()
             << "\nUsing error texture instead: " << kErrorTexturePath << std::endl;
+        m_Source = {};
+        m_ResidentLevel = 0;
         try {
-            createTextureImage(kErrorTexturePath);
+            createTextureImage(Decode(kErrorTexturePath));
         }
         catch (const std::exception& e2) {
             std::cerr << "Critical: Error texture also failed to load: " << e2.what() << std::endl;
@@ -30,67 +204,75 @@ Texture::Texture(const std::string& filename)
         }
     }
     createTextureImageView();
-    createTextureSampler();
 }
 
 Texture::~Texture()
 {
     auto& vulkan_vars = vulkanVars::GetInstance();
-    if (m_Sampler) vkDestroySampler(vulkan_vars.device, m_Sampler, nullptr);
     if (m_ImageView) vkDestroyImageView(vulkan_vars.device, m_ImageView, nullptr);
     if (m_Image) vkDestroyImage(vulkan_vars.device, m_Image, nullptr);
     if (m_ImageMemory) vkFreeMemory(vulkan_vars.device, m_ImageMemory, nullptr);
+    if (m_ID != UINT32_MAX) s_IDs.release(m_ID);
+    if (m_ArrayID != UINT32_MAX) s_ArrayIDs.release(m_ArrayID);
+}
+
+// Lowest slots first, so the table stays dense (and inside the fixed array for as long as possible)
+uint32_t Texture::IDPool::acquire()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (free.empty()) return next++;
+    auto lowest = std::min_element(free.begin(), free.end());
+    const uint32_t id = *lowest;
+    free.erase(lowest);
+    return id;
+}
+
+void Texture::IDPool::release(uint32_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    free.push_back(id);
 }
 
 VkDescriptorImageInfo Texture::getDescriptorInfo() const
 {
     VkDescriptorImageInfo imageInfo{};
     imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageInfo.imageView = m_ImageView;
-    imageInfo.sampler = m_Sampler;
+    imageInfo.imageView = m_Array ? m_Array->m_ImageView : m_ImageView;
+    imageInfo.sampler = GetMaterialSampler();
     return imageInfo;
 }
 
 uint32_t Texture::getID()
 {
+    if (m_Array)
+        return kPackedTexture | (m_Array->m_ArrayID << kPackedLayerBits) | m_Layer;
 
-    if (m_ID > MAX_TEXTURES)
+    if (m_ID >= vulkanVars::GetInstance().textureSlots)
     {
         return 0;
     }
     return m_ID;
 }
 
-void Texture::createTextureImage(const std::string& filename)
+// Staging buffers and one-time command buffers for uploads. Everything goes through the graphics
+// queue; a whole upload (one texture or a TextureManager::loadMany batch) is one submit and one wait.
+// Streaming (BeginRestream) is the exception: it signals a fence and nobody waits.
+static void CreateStagingBuffer(VkDeviceSize size, VkBuffer& buffer, VkDeviceMemory& memory)
 {
     auto& vulkan_vars = vulkanVars::GetInstance();
 
-    int texWidth, texHeight, texChannels;
-    stbi_uc* pixels = stbi_load(filename.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-    if (!pixels) {
-        throw std::runtime_error("failed to load texture image!");
-    }
-
-    VkDeviceSize imageSize = texWidth * texHeight * 4;
-    m_Width = texWidth;
-    m_Height = texHeight;
-
-    // 1. Create a staging buffer
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-
     VkBufferCreateInfo bufferInfo{};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size = imageSize;
+    bufferInfo.size = size;
     bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    if (vkCreateBuffer(vulkan_vars.device, &bufferInfo, nullptr, &stagingBuffer) != VK_SUCCESS) {
+    if (vkCreateBuffer(vulkan_vars.device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
         throw std::runtime_error("failed to create staging buffer!");
     }
 
     VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(vulkan_vars.device, stagingBuffer, &memRequirements);
+    vkGetBufferMemoryRequirements(vulkan_vars.device, buffer, &memRequirements);
 
     VkMemoryAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
@@ -100,32 +282,154 @@ void Texture::createTextureImage(const std::string& filename)
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
     );
 
-    if (vkAllocateMemory(vulkan_vars.device, &allocInfo, nullptr, &stagingBufferMemory) != VK_SUCCESS) {
+    if (vkAllocateMemory(vulkan_vars.device, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+        vkDestroyBuffer(vulkan_vars.device, buffer, nullptr);
         throw std::runtime_error("failed to allocate staging buffer memory!");
     }
 
-    vkBindBufferMemory(vulkan_vars.device, stagingBuffer, stagingBufferMemory, 0);
+    vkBindBufferMemory(vulkan_vars.device, buffer, memory, 0);
+}
+
+static void DestroyStagingBuffer(VkBuffer buffer, VkDeviceMemory memory)
+{
+    auto& vulkan_vars = vulkanVars::GetInstance();
+    vkDestroyBuffer(vulkan_vars.device, buffer, nullptr);
+    vkFreeMemory(vulkan_vars.device, memory, nullptr);
+}
+
+static VkCommandBuffer BeginUploadCommands()
+{
+    auto& vulkan_vars = vulkanVars::GetInstance();
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool = vulkan_vars.commandPoolModelPipeline.m_CommandPool;
+    allocInfo.commandBufferCount = 1;
+
+    VkCommandBuffer commandBuffer;
+    vkAllocateCommandBuffers(vulkan_vars.device, &allocInfo, &commandBuffer);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    return commandBuffer;
+}
+
+static void SubmitUploadCommands(VkCommandBuffer commandBuffer)
+{
+    auto& vulkan_vars = vulkanVars::GetInstance();
+
+    vkEndCommandBuffer(commandBuffer);
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+
+    vkQueueSubmit(vulkan_vars.graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
+    vkQueueWaitIdle(vulkan_vars.graphicsQueue);
+
+    vkFreeCommandBuffers(vulkan_vars.device, vulkan_vars.commandPoolModelPipeline.m_CommandPool, 1, &commandBuffer);
+}
+
+VkDeviceSize Texture::StagingSize(const TextureImage& image)
+{
+    if (image.size) return image.size;
+    return VkDeviceSize(image.width) * image.height * 4;
+}
+
+void Texture::WriteStaging(const TextureImage& image, unsigned char* dst)
+{
+    const unsigned char* pixels = image.pixels.get();
+    if (image.mipOffsets.empty()) {
+        memcpy(dst, pixels, static_cast<size_t>(StagingSize(image)));
+        return;
+    }
+    // KTX2 keeps the smallest level first; stage them largest first, as recordCopy reads them
+    size_t offset = 0;
+    for (uint32_t level = 0; level < image.mipOffsets.size(); ++level) {
+        const size_t size = MipSize(image.format,
+            std::max(uint32_t(image.width) >> level, 1u), std::max(uint32_t(image.height) >> level, 1u));
+        memcpy(dst + offset, pixels + image.mipOffsets[level], size);
+        offset += size;
+    }
+}
+
+void Texture::createTextureImage(const TextureImage& image)
+{
+    createImage(image);
 
+    const VkDeviceSize stagingSize = StagingSize(image);
+    VkBuffer stagingBuffer;
+    VkDeviceMemory stagingBufferMemory;
+    CreateStagingBuffer(stagingSize, stagingBuffer, stagingBufferMemory);
+
+    auto& vulkan_vars = vulkanVars::GetInstance();
     void* data;
-    vkMapMemory(vulkan_vars.device, stagingBufferMemory, 0, imageSize, 0, &data);
-    memcpy(data, pixels, static_cast<size_t>(imageSize));
+    vkMapMemory(vulkan_vars.device, stagingBufferMemory, 0, stagingSize, 0, &data);
+    WriteStaging(image, static_cast<unsigned char*>(data));
     vkUnmapMemory(vulkan_vars.device, stagingBufferMemory);
 
-    stbi_image_free(pixels);
+    VkCommandBuffer commandBuffer = BeginUploadCommands();
+    recordUpload(commandBuffer, stagingBuffer, 0, image);
+    SubmitUploadCommands(commandBuffer);
+
+    DestroyStagingBuffer(stagingBuffer, stagingBufferMemory);
+}
+
+void Texture::createImage(const TextureImage& image)
+{
+    auto& vulkan_vars = vulkanVars::GetInstance();
+
+    // A retry with the error texture replaces whatever the failed upload left behind
+    if (m_Image) vkDestroyImage(vulkan_vars.device, m_Image, nullptr);
+    if (m_ImageMemory) vkFreeMemory(vulkan_vars.device, m_ImageMemory, nullptr);
+    m_Image = VK_NULL_HANDLE;
+    m_ImageMemory = VK_NULL_HANDLE;
+    m_GpuBytes = 0;
+
+    if (!image.pixels) {
+        throw std::runtime_error("failed to load texture image!");
+    }
+    const int texWidth = image.width;
+    const int texHeight = image.height;
+
+    m_Width = texWidth;
+    m_Height = texHeight;
+    m_Format = image.format;
+    m_MipLevels = std::max(image.mipLevels, 1u);
+
+    // Full chain down to 1x1 for single-level uploads, if the format can be blitted with a
+    // linear filter (true for RGBA8 sRGB on all desktop GPUs, never for BC formats)
+    m_GenerateMips = false;
+    if (m_MipLevels == 1 && s_GenerateMips && (texWidth > 1 || texHeight > 1)) {
+        VkFormatProperties props;
+        vkGetPhysicalDeviceFormatProperties(vulkan_vars.physicalDevice, m_Format, &props);
+        const VkFormatFeatureFlags needed = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+            VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        if ((props.optimalTilingFeatures & needed) == needed) {
+            m_GenerateMips = true;
+            uint32_t largest = static_cast<uint32_t>(std::max(texWidth, texHeight));
+            while (largest > 1) { largest >>= 1; ++m_MipLevels; }
+        }
+    }
 
-    // 2. Create the Vulkan image (GPU local)
     VkImageCreateInfo imageInfo{};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
     imageInfo.extent.width = texWidth;
     imageInfo.extent.height = texHeight;
     imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
-    imageInfo.arrayLayers = 1;
-    imageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
+    imageInfo.mipLevels = m_MipLevels;
+    imageInfo.arrayLayers = m_Layers;
+    imageInfo.format = m_Format;
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    if (m_GenerateMips) imageInfo.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     imageInfo.flags = 0;
@@ -134,102 +438,382 @@ void Texture::createTextureImage(const std::string& filename)
         throw std::runtime_error("failed to create image!");
     }
 
+    VkMemoryRequirements memRequirements;
     vkGetImageMemoryRequirements(vulkan_vars.device, m_Image, &memRequirements);
 
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
     allocInfo.allocationSize = memRequirements.size;
     allocInfo.memoryTypeIndex = DataBuffer::findMemoryType(
         vulkan_vars.physicalDevice, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
     if (vkAllocateMemory(vulkan_vars.device, &allocInfo, nullptr, &m_ImageMemory) != VK_SUCCESS) {
+        vkDestroyImage(vulkan_vars.device, m_Image, nullptr);
+        m_Image = VK_NULL_HANDLE;
         throw std::runtime_error("failed to allocate image memory!");
     }
 
     vkBindImageMemory(vulkan_vars.device, m_Image, m_ImageMemory, 0);
+    m_GpuBytes = memRequirements.size;
+}
 
-    // 3. Transition image to TRANSFER_DST_OPTIMAL, copy, then transition to SHADER_READ_ONLY_OPTIMAL
-    transitionImageLayout(m_Image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    copyBufferToImage(stagingBuffer, m_Image, texWidth, texHeight);
-    transitionImageLayout(m_Image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+std::vector<std::shared_ptr<Texture>> Texture::CreateBatch(const std::vector<TextureImage>& images,
+    const std::vector<std::string>& names)
+{
+    std::vector<std::shared_ptr<Texture>> textures(images.size());
+    std::vector<Texture*> targets(images.size());
+    std::vector<TextureImage> uploads(images.size());
+    TextureImage errorImage;
+
+    for (size_t i = 0; i < images.size(); ++i) {
+        auto texture = std::shared_ptr<Texture>(new Texture());
+        texture->m_ID = AcquireID();
+        try {
+            uploads[i] = texture->beginStreaming(images[i]);
+            texture->createImage(uploads[i]);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Texture load failed for: " << names[i]
+                << ". Error: " << e.what()
+                << "\nUsing error texture instead: " << kErrorTexturePath << std::endl;
+            if (!errorImage.pixels) errorImage = Decode(kErrorTexturePath);
+            texture->m_Source = {};
+            texture->m_ResidentLevel = 0;
+            uploads[i] = errorImage;
+            texture->createImage(uploads[i]);
+        }
+        targets[i] = texture.get();
+        textures[i] = std::move(texture);
+    }
 
-    vkDestroyBuffer(vulkan_vars.device, stagingBuffer, nullptr);
-    vkFreeMemory(vulkan_vars.device, stagingBufferMemory, nullptr);
+    std::vector<const TextureImage*> sources(uploads.size());
+    for (size_t i = 0; i < uploads.size(); ++i) sources[i] = &uploads[i];
+    UploadImages(targets, sources);
+
+    for (auto& texture : textures) {
+        texture->createTextureImageView();
+    }
+    return textures;
 }
 
-void Texture::createTextureImageView()
+std::vector<std::shared_ptr<Texture>> Texture::CreatePacked(const std::vector<TextureImage>& images)
 {
+    constexpr VkDeviceSize kStagingAlignment = 16;
+
+    if (images.empty() || images.size() > kMaxPackedLayers)
+        throw std::invalid_argument("packed texture count out of range!");
+
+    auto array = std::shared_ptr<Texture>(new Texture());
+    array->m_ArrayID = s_ArrayIDs.acquire();   // released by the destructor, also on failure
+    if (array->m_ArrayID >= MAX_TEXTURE_ARRAYS)
+        throw std::runtime_error("no free texture array slot!");
+    array->m_Layers = static_cast<uint32_t>(images.size());
+    array->createImage(images[0]);   // format, size and mip chain are the same for every layer
+
+    // Layers back to back in one staging buffer, one submit for the whole array
+    std::vector<VkDeviceSize> offsets(images.size());
+    VkDeviceSize total = 0;
+    for (size_t i = 0; i < images.size(); ++i) {
+        offsets[i] = total;
+        total = (total + StagingSize(images[i]) + kStagingAlignment - 1) / kStagingAlignment * kStagingAlignment;
+    }
+
     auto& vulkan_vars = vulkanVars::GetInstance();
-    VkImageViewCreateInfo viewInfo{};
-    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    viewInfo.image = m_Image;
-    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
-    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = 1;
-    viewInfo.subresourceRange.baseArrayLayer = 0;
-    viewInfo.subresourceRange.layerCount = 1;
+    VkBuffer stagingBuffer;
+    VkDeviceMemory stagingBufferMemory;
+    CreateStagingBuffer(total, stagingBuffer, stagingBufferMemory);
 
-    if (vkCreateImageView(vulkan_vars.device, &viewInfo, nullptr, &m_ImageView) != VK_SUCCESS) {
-        throw std::runtime_error("failed to create texture image view!");
+    void* data;
+    vkMapMemory(vulkan_vars.device, stagingBufferMemory, 0, total, 0, &data);
+    for (size_t i = 0; i < images.size(); ++i)
+        WriteStaging(images[i], static_cast<unsigned char*>(data) + offsets[i]);
+    vkUnmapMemory(vulkan_vars.device, stagingBufferMemory);
+
+    VkCommandBuffer commandBuffer = BeginUploadCommands();
+    array->recordTransition(commandBuffer, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    for (size_t i = 0; i < images.size(); ++i)
+        array->recordCopy(commandBuffer, stagingBuffer, offsets[i], images[i], static_cast<uint32_t>(i));
+    if (array->m_GenerateMips)
+        array->recordMipmaps(commandBuffer);
+    else
+        array->recordTransition(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    SubmitUploadCommands(commandBuffer);
+
+    DestroyStagingBuffer(stagingBuffer, stagingBufferMemory);
+    array->createTextureImageView();
+
+    // Members report an even share of the array's memory, so cache totals stay right
+    std::vector<std::shared_ptr<Texture>> textures(images.size());
+    for (size_t i = 0; i < images.size(); ++i) {
+        auto texture = std::shared_ptr<Texture>(new Texture());
+        texture->m_Array = array;
+        texture->m_Layer = static_cast<uint32_t>(i);
+        texture->m_Width = array->m_Width;
+        texture->m_Height = array->m_Height;
+        texture->m_Format = array->m_Format;
+        texture->m_MipLevels = array->m_MipLevels;
+        texture->m_GpuBytes = array->m_GpuBytes / images.size();
+        textures[i] = std::move(texture);
     }
+    return textures;
 }
 
-void Texture::createTextureSampler()
+void Texture::UploadImages(const std::vector<Texture*>& textures, const std::vector<const TextureImage*>& images)
 {
+    constexpr VkDeviceSize kStagingBudget = 256ull << 20;
+    constexpr VkDeviceSize kStagingAlignment = 16; // covers the texel block size of every format we upload
+
     auto& vulkan_vars = vulkanVars::GetInstance();
+    for (size_t first = 0; first < textures.size();) {
+        // As many textures as fit the budget, always at least one
+        std::vector<VkDeviceSize> offsets;
+        VkDeviceSize total = 0;
+        size_t last = first;
+        for (; last < textures.size(); ++last) {
+            const VkDeviceSize size = StagingSize(*images[last]);
+            if (last > first && total + size > kStagingBudget) break;
+            offsets.push_back(total);
+            total = (total + size + kStagingAlignment - 1) / kStagingAlignment * kStagingAlignment;
+        }
+
+        VkBuffer stagingBuffer;
+        VkDeviceMemory stagingBufferMemory;
+        CreateStagingBuffer(total, stagingBuffer, stagingBufferMemory);
+
+        void* data;
+        vkMapMemory(vulkan_vars.device, stagingBufferMemory, 0, total, 0, &data);
+        for (size_t i = first; i < last; ++i)
+            WriteStaging(*images[i], static_cast<unsigned char*>(data) + offsets[i - first]);
+        vkUnmapMemory(vulkan_vars.device, stagingBufferMemory);
 
-    VkSamplerCreateInfo samplerInfo{};
-    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-    samplerInfo.magFilter = VK_FILTER_LINEAR;
-    samplerInfo.minFilter = VK_FILTER_LINEAR;
-    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.anisotropyEnable = VK_FALSE;
-    samplerInfo.maxAnisotropy = 16.0f;
-    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-    samplerInfo.unnormalizedCoordinates = VK_FALSE;
-    samplerInfo.compareEnable = VK_FALSE;
-    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
-    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        VkCommandBuffer commandBuffer = BeginUploadCommands();
+        for (size_t i = first; i < last; ++i)
+            textures[i]->recordUpload(commandBuffer, stagingBuffer, offsets[i - first], *images[i]);
+        SubmitUploadCommands(commandBuffer);
 
-    if (vkCreateSampler(vulkan_vars.device, &samplerInfo, nullptr, &m_Sampler) != VK_SUCCESS) {
-        throw std::runtime_error("failed to create texture sampler!");
+        DestroyStagingBuffer(stagingBuffer, stagingBufferMemory);
+        first = last;
     }
 }
 
-// Helper: Transition image layout
-void Texture::transitionImageLayout(VkImage image, VkFormat /*format*/, VkImageLayout oldLayout, VkImageLayout newLayout)
+TextureImage Texture::MipTail(const TextureImage& image, uint32_t level)
+{
+    TextureImage tail = image;
+    tail.width = static_cast<int>(std::max(uint32_t(image.width) >> level, 1u));
+    tail.height = static_cast<int>(std::max(uint32_t(image.height) >> level, 1u));
+    tail.mipLevels = image.mipLevels - level;
+    tail.mipOffsets.assign(image.mipOffsets.begin() + level, image.mipOffsets.end());
+    tail.size = 0;
+    for (uint32_t i = 0; i < tail.mipLevels; ++i)
+        tail.size += MipSize(tail.format, std::max(uint32_t(tail.width) >> i, 1u), std::max(uint32_t(tail.height) >> i, 1u));
+    return tail;
+}
+
+TextureImage Texture::beginStreaming(const TextureImage& image)
+{
+    m_Source = {};
+    m_ResidentLevel = 0;
+    // Needs every level addressable in memory, which only KTX2 sources give
+    if (!s_Streaming || !image.pixels || image.mipLevels < 2 || image.mipOffsets.size() != image.mipLevels)
+        return image;
+
+    uint32_t tail = 0;
+    while (tail + 1 < image.mipLevels &&
+        std::max(uint32_t(image.width) >> tail, uint32_t(image.height) >> tail) > s_StreamResidentSize)
+        ++tail;
+    if (tail == 0) return image; // small enough to keep whole
+
+    m_Source = image;
+    m_TailLevel = tail;
+    m_ResidentLevel = tail;
+    return MipTail(image, tail);
+}
+
+VkDeviceSize Texture::streamedBytes(uint32_t level) const
+{
+    VkDeviceSize bytes = 0;
+    for (uint32_t i = level; i < m_Source.mipLevels; ++i)
+        bytes += MipSize(m_Source.format,
+            std::max(uint32_t(m_Source.width) >> i, 1u), std::max(uint32_t(m_Source.height) >> i, 1u));
+    return bytes;
+}
+
+void Texture::GpuHandles::destroy() const
 {
     auto& vulkan_vars = vulkanVars::GetInstance();
+    if (view) vkDestroyImageView(vulkan_vars.device, view, nullptr);
+    if (image) vkDestroyImage(vulkan_vars.device, image, nullptr);
+    if (memory) vkFreeMemory(vulkan_vars.device, memory, nullptr);
+}
 
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = vulkan_vars.commandPoolModelPipeline.m_CommandPool;
-    allocInfo.commandBufferCount = 1;
+Texture::GpuHandles Texture::detachGpu()
+{
+    GpuHandles handles{ m_Image, m_ImageMemory, m_ImageView, m_Width, m_Height, m_MipLevels, m_GpuBytes };
+    m_Image = VK_NULL_HANDLE;
+    m_ImageMemory = VK_NULL_HANDLE;
+    m_ImageView = VK_NULL_HANDLE;
+    return handles;
+}
 
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(vulkan_vars.device, &allocInfo, &commandBuffer);
+void Texture::restoreGpu(const GpuHandles& handles)
+{
+    auto& vulkan_vars = vulkanVars::GetInstance();
+    if (m_Image) vkDestroyImage(vulkan_vars.device, m_Image, nullptr);
+    if (m_ImageMemory) vkFreeMemory(vulkan_vars.device, m_ImageMemory, nullptr);
+    m_Image = handles.image;
+    m_ImageMemory = handles.memory;
+    m_ImageView = handles.view;
+    m_Width = handles.width;
+    m_Height = handles.height;
+    m_MipLevels = handles.mipLevels;
+    m_GpuBytes = handles.gpuBytes;
+}
 
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+Texture::StreamUpload Texture::BeginRestream(const std::vector<std::pair<std::shared_ptr<Texture>, uint32_t>>& changes)
+{
+    constexpr VkDeviceSize kStagingAlignment = 16;
+    auto& vulkan_vars = vulkanVars::GetInstance();
 
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    StreamUpload upload;
+    std::vector<TextureImage> tails;
+    std::vector<VkDeviceSize> offsets;
+    VkDeviceSize total = 0;
+    for (const auto& [texture, requested] : changes) {
+        if (!texture->isStreamed() || texture->m_StreamPending) continue;
+        const uint32_t level = std::min(requested, texture->m_TailLevel);
+        if (level == texture->m_ResidentLevel) continue;
+
+        // The new image is created next to the current one, which stays bound until the swap
+        TextureImage tail = MipTail(texture->m_Source, level);
+        const GpuHandles current = texture->detachGpu();
+        try {
+            texture->createImage(tail);
+        }
+        catch (const std::exception& e) {
+            // Most likely out of device memory; keep what is resident
+            std::cerr << "Texture streaming failed for level " << level << ": " << e.what() << std::endl;
+            texture->restoreGpu(current);
+            continue;
+        }
+        upload.items.push_back({ texture, texture->detachGpu(), level });
+        texture->restoreGpu(current);
+        texture->m_StreamPending = true;
 
+        offsets.push_back(total);
+        total = (total + StagingSize(tail) + kStagingAlignment - 1) / kStagingAlignment * kStagingAlignment;
+        tails.push_back(std::move(tail));
+    }
+    if (upload.items.empty()) return upload;
+
+    CreateStagingBuffer(total, upload.staging, upload.stagingMemory);
+    void* data;
+    vkMapMemory(vulkan_vars.device, upload.stagingMemory, 0, total, 0, &data);
+    for (size_t i = 0; i < tails.size(); ++i)
+        WriteStaging(tails[i], static_cast<unsigned char*>(data) + offsets[i]);
+    vkUnmapMemory(vulkan_vars.device, upload.stagingMemory);
+
+    // recordUpload works on the texture's own image, so the new one is put in place just for recording
+    upload.commandBuffer = BeginUploadCommands();
+    for (size_t i = 0; i < upload.items.size(); ++i) {
+        StreamUpload::Item& item = upload.items[i];
+        const GpuHandles current = item.texture->detachGpu();
+        item.texture->restoreGpu(item.next);
+        item.texture->recordUpload(upload.commandBuffer, upload.staging, offsets[i], tails[i]);
+        item.next = item.texture->detachGpu();
+        item.texture->restoreGpu(current);
+    }
+    vkEndCommandBuffer(upload.commandBuffer);
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    if (vkCreateFence(vulkan_vars.device, &fenceInfo, nullptr, &upload.fence) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create texture streaming fence!");
+    }
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &upload.commandBuffer;
+    if (vkQueueSubmit(vulkan_vars.graphicsQueue, 1, &submitInfo, upload.fence) != VK_SUCCESS) {
+        throw std::runtime_error("failed to submit texture streaming upload!");
+    }
+    return upload;
+}
+
+bool Texture::StreamUpload::isDone() const
+{
+    return !fence || vkGetFenceStatus(vulkanVars::GetInstance().device, fence) == VK_SUCCESS;
+}
+
+void Texture::FinishRestream(StreamUpload& upload, std::vector<GpuHandles>& retired)
+{
+    auto& vulkan_vars = vulkanVars::GetInstance();
+    for (StreamUpload::Item& item : upload.items) {
+        Texture* texture = item.texture.get();
+        retired.push_back(texture->detachGpu());
+        texture->restoreGpu(item.next);
+        texture->m_ResidentLevel = item.level;
+        texture->m_StreamPending = false;
+        texture->createTextureImageView();
+    }
+    if (upload.fence) vkDestroyFence(vulkan_vars.device, upload.fence, nullptr);
+    if (upload.commandBuffer)
+        vkFreeCommandBuffers(vulkan_vars.device, vulkan_vars.commandPoolModelPipeline.m_CommandPool, 1, &upload.commandBuffer);
+    if (upload.staging) DestroyStagingBuffer(upload.staging, upload.stagingMemory);
+    upload = {};
+}
+
+// Transition to TRANSFER_DST, copy, then mips or a transition to SHADER_READ_ONLY
+void Texture::recordUpload(VkCommandBuffer commandBuffer, VkBuffer staging, VkDeviceSize stagingOffset, const TextureImage& image)
+{
+    recordTransition(commandBuffer, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    recordCopy(commandBuffer, staging, stagingOffset, image);
+    if (m_GenerateMips)
+        recordMipmaps(commandBuffer);
+    else
+        recordTransition(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+}
+
+void Texture::createTextureImageView()
+{
+    auto& vulkan_vars = vulkanVars::GetInstance();
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = m_Image;
+    viewInfo.viewType = m_ArrayID != UINT32_MAX ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = m_Format;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = m_MipLevels;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = m_Layers;
+
+    if (vkCreateImageView(vulkan_vars.device, &viewInfo, nullptr, &m_ImageView) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create texture image view!");
+    }
+}
+
+VkSampler Texture::GetMaterialSampler()
+{
+    SamplerDesc desc;
+    desc.maxAnisotropy = s_MaxAnisotropy.load();
+    return SamplerCache::GetInstance().get(desc);
+}
+
+// Helper: Transition image layout (all levels and layers)
+void Texture::recordTransition(VkCommandBuffer commandBuffer, VkImageLayout oldLayout, VkImageLayout newLayout)
+{
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.oldLayout = oldLayout;
     barrier.newLayout = newLayout;
     barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = image;
+    barrier.image = m_Image;
     barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.levelCount = m_MipLevels;
     barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
+    barrier.subresourceRange.layerCount = m_Layers;
 
     VkPipelineStageFlags srcStage;
     VkPipelineStageFlags dstStage;
@@ -258,69 +842,98 @@ void Texture::transitionImageLayout(VkImage image, VkFormat /*format*/, VkImageL
         0, nullptr,
         1, &barrier
     );
-
-    vkEndCommandBuffer(commandBuffer);
-
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-
-    vkQueueSubmit(vulkan_vars.graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(vulkan_vars.graphicsQueue);
-
-    vkFreeCommandBuffers(vulkan_vars.device, vulkan_vars.commandPoolModelPipeline.m_CommandPool, 1, &commandBuffer);
 }
 
-// Helper: Copy buffer to image
-void Texture::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
+// Helper: Copy staging buffer to image
+void Texture::recordCopy(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize bufferOffset, const TextureImage& layout, uint32_t layer)
 {
-    auto& vulkan_vars = vulkanVars::GetInstance();
-
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = vulkan_vars.commandPoolModelPipeline.m_CommandPool;
-    allocInfo.commandBufferCount = 1;
-
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(vulkan_vars.device, &allocInfo, &commandBuffer);
-
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = { 0, 0, 0 };
-    region.imageExtent = { width, height, 1 };
+    // One region per mip level in the staging buffer (back to back); generated levels aren't in it
+    std::vector<VkBufferImageCopy> regions(std::clamp(layout.mipLevels, 1u, m_MipLevels));
+    VkDeviceSize offset = bufferOffset;
+    for (uint32_t level = 0; level < regions.size(); ++level) {
+        const uint32_t width = std::max(uint32_t(layout.width) >> level, 1u);
+        const uint32_t height = std::max(uint32_t(layout.height) >> level, 1u);
+
+        VkBufferImageCopy& region = regions[level];
+        region.bufferOffset = offset;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = level;
+        region.imageSubresource.baseArrayLayer = layer;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = { 0, 0, 0 };
+        region.imageExtent = { width, height, 1 };
+        offset += MipSize(m_Format, width, height);
+    }
 
     vkCmdCopyBufferToImage(
         commandBuffer,
         buffer,
-        image,
+        m_Image,
         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        1,
-        &region
+        static_cast<uint32_t>(regions.size()),
+        regions.data()
     );
+}
 
-    vkEndCommandBuffer(commandBuffer);
-
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
+void Texture::recordMipmaps(VkCommandBuffer commandBuffer)
+{
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = m_Image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = m_Layers;
+
+    // Each level is blitted from the one above it, which is then done and handed to the shaders
+    int32_t width = static_cast<int32_t>(m_Width), height = static_cast<int32_t>(m_Height);
+    for (uint32_t level = 1; level < m_MipLevels; ++level) {
+        barrier.subresourceRange.baseMipLevel = level - 1;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+            0, nullptr, 0, nullptr, 1, &barrier);
+
+        const int32_t nextWidth = std::max(width / 2, 1), nextHeight = std::max(height / 2, 1);
+        VkImageBlit blit{};
+        blit.srcOffsets[1] = { width, height, 1 };
+        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.srcSubresource.mipLevel = level - 1;
+        blit.srcSubresource.baseArrayLayer = 0;
+        blit.srcSubresource.layerCount = m_Layers;
+        blit.dstOffsets[1] = { nextWidth, nextHeight, 1 };
+        blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.dstSubresource.mipLevel = level;
+        blit.dstSubresource.baseArrayLayer = 0;
+        blit.dstSubresource.layerCount = m_Layers;
+        vkCmdBlitImage(commandBuffer,
+            m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1, &blit, VK_FILTER_LINEAR);
+
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+            0, nullptr, 0, nullptr, 1, &barrier);
 
-    vkQueueSubmit(vulkan_vars.graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(vulkan_vars.graphicsQueue);
+        width = nextWidth;
+        height = nextHeight;
+    }
 
-    vkFreeCommandBuffers(vulkan_vars.device, vulkan_vars.commandPoolModelPipeline.m_CommandPool, 1, &commandBuffer);
+    // The last level was only ever written
+    barrier.subresourceRange.baseMipLevel = m_MipLevels - 1;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+        0, nullptr, 0, nullptr, 1, &barrier);
 }
@@ -3,37 +3,217 @@
 #include <vulkan/vulkan.h>
 #include <string>
 #include <atomic>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <mutex>
+#include <Engine/ObjUtils/TextureRole.h>
 
 namespace {
     const std::string kErrorTexturePath = "Resources/Textures/errorTexture.jpg";
 }
 
+// Pixels decoded on the CPU; no Vulkan calls involved, so it can be produced on any thread.
+// Usually one RGBA8 level from stbi; KTX2 files (cooked or not) bring a whole, often BC, mip chain.
+struct TextureImage {
+    int width = 0, height = 0;
+    std::shared_ptr<unsigned char> pixels; // stbi allocation or KTX2 file mapping, null if decoding failed
+    VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+    uint32_t mipLevels = 1;
+    size_t size = 0;                       // bytes of all levels
+    std::vector<size_t> mipOffsets;        // level starts from 'pixels'; empty = packed from level 0 on
+};
+
+// One entry of the texture table: the slot is the texture's ID. Binding 1 holds single
+// textures, binding 3 the arrays small textures are packed into (Texture::CreatePacked).
+struct TextureSlot {
+    uint32_t slot = 0;
+    VkDescriptorImageInfo info{};
+    uint32_t binding = 1;
+};
+
 class Texture {
     friend class TextureManager;
 public:
    
     ~Texture();
 
+    // stbi decode only, safe to call from worker threads
+    // Prefers the cooked package of 'filename' when there is one for 'role' (see ObjUtils/CookedAssets.h);
+    // .ktx2 files load as they are. Normal and data maps decode as UNORM.
+    static TextureImage Decode(const std::string& filename, ObjUtils::TextureRole role = ObjUtils::TextureRole::Color);
+    // Same for an encoded image already in memory (e.g. embedded in a .glb)
+    static TextureImage DecodeMemory(const unsigned char* data, size_t size);
+    // Copies one RGBA channel into R, G and B (alpha = 255). Used to split packed glTF
+    // metallic-roughness maps into the single-channel maps the PBR shader samples via .r.
+    // Only for single-level RGBA8 images; anything else gives an empty image. Result is UNORM
+    static TextureImage ExtractChannel(const TextureImage& image, int channel);
+
+    // Upload options (Game::init feeds them from settings). Single-level images get their full mip
+    // chain blitted on the GPU when generation is on, for textures created after the change; cooked
+    // packages already carry one. Anisotropy applies to all textures at once through the shared
+    // material sampler; it is clamped to the device limit, <= 1 disables it. It snaps down to
+    // 1/2/4/8/16, so no setting can grow SamplerCache past those five samplers.
+    static void SetMipmapGeneration(bool enabled) { s_GenerateMips = enabled; }
+    static void SetMaxAnisotropy(float maxAnisotropy) { s_MaxAnisotropy = QuantizeAnisotropy(maxAnisotropy); }
+    static float QuantizeAnisotropy(float maxAnisotropy) {
+        float q = 1.f;
+        while (q < 16.f && q * 2.f <= maxAnisotropy) q *= 2.f;
+        return q;
+    }
+    // Textures that arrive with their whole mip chain (KTX2) are streamed when enabled: they start
+    // with only the levels up to 'residentSize' texels on the GPU and keep their source mapped,
+    // so TextureManager can load finer levels or drop them again later.
+    static void SetStreaming(bool enabled, uint32_t residentSize) { s_Streaming = enabled; s_StreamResidentSize = residentSize; }
+
     VkImageView getImageView() const { return m_ImageView; }
-    VkSampler getSampler() const { return m_Sampler; }
+    // Every texture is sampled with the shared material sampler (SamplerCache)
+    VkSampler getSampler() const { return GetMaterialSampler(); }
+    static VkSampler GetMaterialSampler();
     VkDescriptorImageInfo getDescriptorInfo() const;
+    uint32_t getMipLevels() const { return m_MipLevels; }
+    VkDeviceSize getGpuBytes() const { return m_GpuBytes; }
 
+    bool isStreamed() const { return m_Source.pixels != nullptr; }
+    // False while evicted by TextureManager::updateResidency (its slot shows the standard texture)
+    bool isResident() const { return m_Array ? m_Array->isResident() : m_ImageView != VK_NULL_HANDLE; }
+    // First level of the full chain that is on the GPU (0 = full resolution)
+    uint32_t getResidentLevel() const { return m_ResidentLevel; }
+
+    // Slot in the texture table; 0 (the first texture, the error texture) when the slot is past
+    // what the device's table holds. Slots of destroyed textures are handed out again.
+    // Packed textures give kPackedTexture | array slot << kPackedLayerBits | layer instead.
     uint32_t getID();
+
+    // Layers of one 2D array image instead of an image each: every image must have the same format,
+    // size and mip count (at most kMaxPackedLayers). All of them take one array slot in the texture
+    // table and one allocation. Packed textures aren't streamed. Throws when no array slot is free.
+    static std::vector<std::shared_ptr<Texture>> CreatePacked(const std::vector<TextureImage>& images);
+    static constexpr uint32_t kPackedTexture = 0x40000000u;
+    static constexpr uint32_t kPackedLayerBits = 12;
+    static constexpr uint32_t kMaxPackedLayers = 256;  // minimum maxImageArrayLayers
+
+    bool isPacked() const { return m_Array != nullptr; }
+    // Array image a packed texture lives in (null otherwise), and its slot at binding 3
+    const std::shared_ptr<Texture>& getArray() const { return m_Array; }
+    uint32_t getArrayID() const { return m_ArrayID; }
 private:
-    Texture(const std::string& filename);
+    Texture() = default;
+    Texture(const std::string& filename, ObjUtils::TextureRole role = ObjUtils::TextureRole::Color);
+    // Upload of an image decoded earlier (falls back to the error texture if 'image' is empty)
+    Texture(const TextureImage& image, const std::string& filename);
+
+    // Creates and uploads all 'images' with one staging buffer and one submit (per ~256 MiB of
+    // pixels) instead of a queue wait per step and texture. Empty images get the error texture.
+    // IDs are handed out in input order. Main thread only, like every Texture constructor.
+    static std::vector<std::shared_ptr<Texture>> CreateBatch(const std::vector<TextureImage>& images,
+        const std::vector<std::string>& names);
+
+    // Uploads 'images' into already created 'textures', one staging buffer and submit per ~256 MiB
+    static void UploadImages(const std::vector<Texture*>& textures, const std::vector<const TextureImage*>& images);
+
+    // GPU objects of a texture, destroyed once no frame in flight samples them any more
+    struct GpuHandles {
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        // State that goes with them, to put them back if a re-create fails
+        uint32_t width = 0, height = 0, mipLevels = 1;
+        VkDeviceSize gpuBytes = 0;
+        void destroy() const;
+    };
+    // Streaming upload on its way to the GPU: new images for levels [level, n) of each texture,
+    // filled by one fenced submit while the textures keep sampling their current images
+    struct StreamUpload {
+        struct Item {
+            std::shared_ptr<Texture> texture;
+            GpuHandles next;               // no view yet
+            uint32_t level = 0;
+        };
+        std::vector<Item> items;
+        VkFence fence = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkBuffer staging = VK_NULL_HANDLE;
+        VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+        bool isDone() const;
+    };
+    // Creates and records the new images of 'changes' and submits them without waiting; textures
+    // that already have one in flight are skipped. Empty (no items) when nothing needed an upload.
+    static StreamUpload BeginRestream(const std::vector<std::pair<std::shared_ptr<Texture>, uint32_t>>& changes);
+    // Once 'upload' is done: swaps the new images in and frees the upload. The replaced objects go
+    // to 'retired'; frames in flight may still use them.
+    static void FinishRestream(StreamUpload& upload, std::vector<GpuHandles>& retired);
+    // Levels [level, n) of an image with a full chain, sharing its pixels
+    static TextureImage MipTail(const TextureImage& image, uint32_t level);
+    // Keeps 'image' as the streaming source if it qualifies and returns what to upload first
+    TextureImage beginStreaming(const TextureImage& image);
+    // Device bytes of levels [level, n) of the source (format sizes, ignoring driver padding)
+    VkDeviceSize streamedBytes(uint32_t level) const;
+    GpuHandles detachGpu();
+    void restoreGpu(const GpuHandles& handles);
 
-    void createTextureImage(const std::string& filename);
+    void init(const TextureImage& image, const std::string& filename);
+    // Image and view for 'image' into this texture's slot (init, reload after eviction); error texture on failure
+    void upload(const TextureImage& image, const std::string& filename);
+    // Upload of a single texture: its own staging buffer and submit
+    void createTextureImage(const TextureImage& image);
     void createTextureImageView();
-    void createTextureSampler();
-    void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
-    void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
+
+    // Upload steps, split so a batch can record many textures into one command buffer
+    // Device-local image for 'image' (mip chain decided here); throws on failure
+    void createImage(const TextureImage& image);   // m_Layers layers when it is an array
+    // Bytes 'image' takes in a staging buffer, and the copy into it (levels largest first)
+    static VkDeviceSize StagingSize(const TextureImage& image);
+    static void WriteStaging(const TextureImage& image, unsigned char* dst);
+    // Copy from 'staging' at 'stagingOffset', then mips; leaves every level SHADER_READ_ONLY
+    void recordUpload(VkCommandBuffer commandBuffer, VkBuffer staging, VkDeviceSize stagingOffset, const TextureImage& image);
+    void recordTransition(VkCommandBuffer commandBuffer, VkImageLayout oldLayout, VkImageLayout newLayout);
+    void recordCopy(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize bufferOffset, const TextureImage& layout, uint32_t layer = 0);
+    // Levels 1..n from level 0 (in TRANSFER_DST)
+    void recordMipmaps(VkCommandBuffer commandBuffer);
 
     VkImage m_Image = VK_NULL_HANDLE;
     VkDeviceMemory m_ImageMemory = VK_NULL_HANDLE;
     VkImageView m_ImageView = VK_NULL_HANDLE;
-    VkSampler m_Sampler = VK_NULL_HANDLE;
     uint32_t m_Width = 0, m_Height = 0;
+    VkFormat m_Format = VK_FORMAT_R8G8B8A8_SRGB;
+    uint32_t m_MipLevels = 1;
+    bool m_GenerateMips = false;   // levels past the uploaded ones are blitted
+
+    // Streaming (TextureManager::updateStreaming); m_Source stays empty for textures that aren't streamed
+    TextureImage m_Source;
+    uint32_t m_ResidentLevel = 0;
+    uint32_t m_TailLevel = 0;                  // coarsest level streaming falls back to
+    bool m_StreamPending = false;              // a StreamUpload for it hasn't been swapped in yet
+    uint32_t m_RequestedLevel = UINT32_MAX;    // finest level asked for this frame
+    uint64_t m_LastRequestFrame = 0;
+    // Residency (TextureManager::updateResidency)
+    bool m_Used = false;                       // a visible material asked for it this frame
+    uint64_t m_LastUseFrame = UINT64_MAX;      // UINT64_MAX until the first residency pass sees it
+    VkDeviceSize m_GpuBytes = 0;
     uint32_t m_ID = -1;
 
-    static std::atomic<uint32_t> s_NextID;
+    // Packing: an array texture has m_Layers layers and an array slot; each packed texture owns no
+    // image of its own, only a reference to its array and layer
+    uint32_t m_Layers = 1;
+    uint32_t m_ArrayID = UINT32_MAX;
+    std::shared_ptr<Texture> m_Array;
+    uint32_t m_Layer = 0;
+
+    // Table slots, lowest free one first so the table stays dense
+    struct IDPool {
+        std::mutex mutex;
+        uint32_t next = 0;
+        std::vector<uint32_t> free;
+        uint32_t acquire();
+        void release(uint32_t id);
+    };
+    static uint32_t AcquireID() { return s_IDs.acquire(); }
+    static IDPool s_IDs;
+    static IDPool s_ArrayIDs;
+    static std::atomic<bool> s_GenerateMips;
+    static std::atomic<float> s_MaxAnisotropy;
+    static std::atomic<bool> s_Streaming;
+    static std::atomic<uint32_t> s_StreamResidentSize;
 };
@@ -1,4 +1,13 @@
 #include "TextureManager.h"
+#include <Engine/Core/AssetLoader.h>
+#include <Engine/Graphics/vulkanVars.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <map>
+#include <tuple>
 
 // Constructor
 TextureManager::TextureManager() {
@@ -7,22 +16,194 @@ TextureManager::TextureManager() {
 }
 
 // Lookup or create texture by file path (cached)
-std::shared_ptr<Texture> TextureManager::getOrCreateTexture(const std::string& filepath) {
+std::shared_ptr<Texture> TextureManager::getOrCreateTexture(const std::string& filepath, ObjUtils::TextureRole role) {
     auto it = m_textureCache.find(filepath);
     if (it != m_textureCache.end())
         return it->second;
-    auto texture = std::shared_ptr<Texture>(new Texture(filepath));
+    auto texture = std::shared_ptr<Texture>(new Texture(filepath, role));
     
     m_textureCache[filepath] = texture;
+    m_fileRoles[filepath] = role;
+    markSlotDirty(texture); // descriptor array has to pick up the new slot
     return texture;
 }
 
+std::vector<std::shared_ptr<Texture>> TextureManager::loadMany(const std::vector<std::string>& filepaths,
+    const std::vector<ObjUtils::TextureRole>& roles) {
+    std::vector<std::pair<std::string, std::function<TextureImage()>>> sources;
+    sources.reserve(filepaths.size());
+    for (size_t i = 0; i < filepaths.size(); ++i) {
+        const std::string& path = filepaths[i];
+        const ObjUtils::TextureRole role = i < roles.size() ? roles[i] : ObjUtils::TextureRole::Color;
+        sources.emplace_back(path, [path, role] { return Texture::Decode(path, role); });
+        if (!path.empty() && !m_textureCache.count(path)) m_fileRoles.emplace(path, role);
+    }
+    return loadMany(sources);
+}
+
+std::vector<std::shared_ptr<Texture>> TextureManager::loadMany(
+    const std::vector<std::pair<std::string, std::function<TextureImage()>>>& sources) {
+    std::vector<size_t> missing;   // into 'sources', first occurrence of each uncached key
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const std::string& key = sources[i].first;
+        if (key.empty() || m_textureCache.count(key)) continue;
+        if (std::none_of(missing.begin(), missing.end(), [&](size_t m) { return sources[m].first == key; }))
+            missing.push_back(i);
+    }
+
+    if (!missing.empty()) {
+        // Each decode runs once, on whichever thread claims it first. The caller then takes
+        // every one the workers haven't started, so it only ever waits on decodes that are
+        // already running and can't deadlock when it is itself a pool task with all workers busy.
+        struct PendingDecode {
+            std::function<TextureImage()> decode;
+            std::atomic<bool> claimed{ false };
+            std::promise<TextureImage> result;
+            void run() {
+                if (claimed.exchange(true)) return;
+                try { result.set_value(decode()); }
+                catch (...) { result.set_exception(std::current_exception()); }
+            }
+        };
+        std::vector<std::shared_ptr<PendingDecode>> pending;
+        std::vector<std::future<TextureImage>> decodes;
+        pending.reserve(missing.size());
+        decodes.reserve(missing.size());
+        for (size_t m : missing) {
+            auto job = std::make_shared<PendingDecode>();
+            job->decode = sources[m].second;
+            decodes.push_back(job->result.get_future());
+            AssetLoader::GetInstance().pool().submit([job] { job->run(); });
+            pending.push_back(std::move(job));
+        }
+        for (const auto& job : pending) job->run();
+
+        std::vector<TextureImage> images(missing.size());
+        std::vector<std::string> names(missing.size());
+        for (size_t i = 0; i < missing.size(); ++i) {
+            names[i] = sources[missing[i]].first;
+            try {
+                images[i] = decodes[i].get();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "[TextureManager] decoding \"" << names[i] << "\" failed: " << e.what() << "\n";
+            }
+        }
+
+        auto textures = createTextures(images, names);
+        for (size_t i = 0; i < missing.size(); ++i) {
+            m_textureCache[names[i]] = textures[i];
+            markSlotDirty(textures[i]);
+        }
+    }
+
+    std::vector<std::shared_ptr<Texture>> result;
+    result.reserve(sources.size());
+    for (const auto& [key, decode] : sources)
+        result.push_back(key.empty() ? nullptr : m_textureCache[key]);
+    return result;
+}
+
+std::vector<std::shared_ptr<Texture>> TextureManager::createTextures(const std::vector<TextureImage>& images,
+    const std::vector<std::string>& names) {
+    std::vector<std::shared_ptr<Texture>> textures(images.size());
+
+    // Small textures of identical format, size and mip count go into shared 2D arrays. Needs
+    // descriptor indexing (the arrays have their own, partially bound, binding)
+    if (m_packTextures && vulkanVars::GetInstance().bindlessTextures) {
+        using Key = std::tuple<VkFormat, int, int, uint32_t>;
+        std::map<Key, std::vector<size_t>> groups;
+        for (size_t i = 0; i < images.size(); ++i) {
+            const TextureImage& image = images[i];
+            if (!image.pixels || uint32_t(std::max(image.width, image.height)) > m_packMaxSize) continue;
+            groups[{ image.format, image.width, image.height, image.mipLevels }].push_back(i);
+        }
+
+        for (const auto& [key, members] : groups) {
+            for (size_t first = 0; first + 1 < members.size(); first += Texture::kMaxPackedLayers) {
+                const size_t last = std::min(members.size(), first + Texture::kMaxPackedLayers);
+                if (last - first < 2) break;   // a lone texture gains nothing from an array
+                std::vector<TextureImage> layers;
+                for (size_t m = first; m < last; ++m) layers.push_back(images[members[m]]);
+                try {
+                    auto packed = Texture::CreatePacked(layers);
+                    for (size_t m = first; m < last; ++m) textures[members[m]] = std::move(packed[m - first]);
+                }
+                catch (const std::exception& e) {
+                    // Out of array slots or memory: these load as separate textures below
+                    std::cerr << "[TextureManager] packing " << (last - first) << " textures failed: " << e.what() << "\n";
+                }
+            }
+        }
+    }
+
+    std::vector<TextureImage> single;
+    std::vector<std::string> singleNames;
+    std::vector<size_t> singleIndex;
+    for (size_t i = 0; i < images.size(); ++i) {
+        if (textures[i]) continue;
+        single.push_back(images[i]);
+        singleNames.push_back(names[i]);
+        singleIndex.push_back(i);
+    }
+    if (!single.empty()) {
+        auto created = Texture::CreateBatch(single, singleNames);
+        for (size_t i = 0; i < created.size(); ++i) textures[singleIndex[i]] = std::move(created[i]);
+    }
+    return textures;
+}
+
+std::shared_ptr<Texture> TextureManager::getOrCreateTexture(const std::string& key, const std::function<TextureImage()>& decode) {
+    auto it = m_textureCache.find(key);
+    if (it != m_textureCache.end())
+        return it->second;
+    auto texture = std::shared_ptr<Texture>(new Texture(decode(), key));
+
+    m_textureCache[key] = texture;
+    markSlotDirty(texture);
+    return texture;
+}
+
+std::shared_ptr<Texture> TextureManager::getOrCreateTextureAsync(const std::string& filepath, ObjUtils::TextureRole role,
+    TextureReadyFn onReady) {
+    auto it = m_textureCache.find(filepath);
+    if (it != m_textureCache.end()) {
+        if (onReady) onReady(it->second);
+        return it->second;
+    }
+
+    // Only the first request starts a load; later ones just wait for it
+    auto [pending, first] = m_pendingTextures.try_emplace(filepath);
+    if (onReady) pending->second.push_back(std::move(onReady));
+    if (first) {
+        AssetLoader::GetInstance().enqueue<TextureImage>(filepath,
+            [filepath, role] { return Texture::Decode(filepath, role); },
+            [this, filepath, role](TextureImage& image) {
+                // Texture IDs index the descriptor array, so creation stays on the main thread.
+                // A blocking getOrCreateTexture may have loaded it meanwhile; keep that one.
+                auto& cached = m_textureCache[filepath];
+                if (!cached) {
+                    cached = std::shared_ptr<Texture>(new Texture(image, filepath));
+                    m_fileRoles[filepath] = role;
+                    markSlotDirty(cached);
+                }
+                std::shared_ptr<Texture> texture = cached;
+
+                auto waiting = m_pendingTextures.find(filepath);
+                if (waiting == m_pendingTextures.end()) return;
+                std::vector<TextureReadyFn> callbacks = std::move(waiting->second);
+                m_pendingTextures.erase(waiting);
+                for (auto& cb : callbacks) cb(texture);
+            });
+    }
+    return m_standardTexture;
+}
+
 // Add texture to active list (prevents duplicates)
 void TextureManager::addActiveTexture(const std::shared_ptr<Texture>& texture) {
     if (!texture) return;
     if (std::find(m_activeTextures.begin(), m_activeTextures.end(), texture) == m_activeTextures.end()) {
         m_activeTextures.push_back(texture);
-        m_textureListDirty = true;
     }
 }
 
@@ -31,14 +212,12 @@ void TextureManager::removeActiveTexture(const std::shared_ptr<Texture>& texture
     auto it = std::remove(m_activeTextures.begin(), m_activeTextures.end(), texture);
     if (it != m_activeTextures.end()) {
         m_activeTextures.erase(it, m_activeTextures.end());
-        m_textureListDirty = true;
     }
 }
 
 // Replace active texture list
 void TextureManager::setActiveTextures(const std::vector<std::shared_ptr<Texture>>& textures) {
     m_activeTextures = textures;
-    m_textureListDirty = true;
 }
 
 // Find texture by unique ID
@@ -58,7 +237,37 @@ std::shared_ptr<Texture> TextureManager::getTextureByIndex(size_t idx) const {
 // Clear the active texture list
 void TextureManager::clearActiveTextures() {
     m_activeTextures.clear();
-    m_textureListDirty = true;
+}
+
+// Key: binding << 32 | slot. Packed textures mark the array they live in.
+void TextureManager::markSlotDirty(const std::shared_ptr<Texture>& texture) {
+    if (!texture) return;
+    if (texture->isPacked())
+        m_dirtySlots[uint64_t(3) << 32 | texture->getArrayID()] = texture->getArray();
+    else
+        m_dirtySlots[uint64_t(1) << 32 | texture->m_ID] = texture;
+}
+
+std::vector<TextureSlot> TextureManager::takeDirtySlots() {
+    std::vector<TextureSlot> slots;
+    slots.reserve(m_dirtySlots.size());
+    for (const auto& [key, weak] : m_dirtySlots) {
+        const uint32_t binding = uint32_t(key >> 32), slot = uint32_t(key);
+        const auto texture = weak.lock();
+        if (texture && texture->isResident()) slots.push_back({ slot, texture->getDescriptorInfo(), binding });
+        // Table slots must stay valid for the fixed array; a gone array slot is simply unused
+        else if (binding == 1 && m_standardTexture) slots.push_back({ slot, m_standardTexture->getDescriptorInfo(), binding });
+    }
+    m_dirtySlots.clear();
+    return slots;
+}
+
+// Device memory held by the cached textures
+size_t TextureManager::getGpuBytes() const {
+    size_t bytes = 0;
+    for (const auto& [key, texture] : m_textureCache)
+        if (texture) bytes += static_cast<size_t>(texture->getGpuBytes());
+    return bytes;
 }
 
 // Return all cached textures
@@ -68,3 +277,213 @@ std::vector<std::shared_ptr<Texture>> TextureManager::getAllCachedTextures() con
         result.push_back(val);
     return result;
 }
+
+void TextureManager::requestLevel(const std::shared_ptr<Texture>& texture, uint32_t level) {
+    if (!texture) return;
+    texture->m_Used = true;
+    if (texture->isStreamed())
+        texture->m_RequestedLevel = std::min(texture->m_RequestedLevel, level);
+}
+
+size_t TextureManager::getStreamedBytes() const {
+    size_t bytes = 0;
+    for (const auto& [key, texture] : m_textureCache)
+        if (texture && texture->isStreamed()) bytes += static_cast<size_t>(texture->getGpuBytes());
+    return bytes;
+}
+
+void TextureManager::releaseRetired(uint64_t frame, bool all) {
+    // Teardown: the device is idle, so every upload is done; swap them in to free them
+    if (all) finishStreamUploads(frame, true);
+    auto done = [&](const std::pair<uint64_t, Texture::GpuHandles>& r) {
+        if (!all && frame < r.first + MAX_FRAMES_IN_FLIGHT + 1) return false;
+        r.second.destroy();
+        return true;
+    };
+    m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(), done), m_retired.end());
+}
+
+void TextureManager::finishStreamUploads(uint64_t frame, bool all) {
+    for (auto it = m_streamUploads.begin(); it != m_streamUploads.end();) {
+        if (!all && !it->isDone()) { ++it; continue; }
+        std::vector<Texture::GpuHandles> retired;
+        for (const auto& item : it->items) markSlotDirty(item.texture);
+        Texture::FinishRestream(*it, retired);
+        for (const auto& handles : retired) m_retired.emplace_back(frame, handles);
+        it = m_streamUploads.erase(it);
+    }
+}
+
+void TextureManager::updateStreaming(uint64_t frame) {
+    // Levels not asked for in this many frames go back to the resident tail
+    constexpr uint64_t kIdleFrames = 120;
+
+    releaseRetired(frame);
+    finishStreamUploads(frame);
+
+    struct Entry {
+        Texture* texture;
+        const std::shared_ptr<Texture>* owner;
+        uint32_t target;
+        bool requested;
+    };
+    std::vector<Entry> entries;
+    size_t total = 0;
+    for (const auto& [key, texture] : m_textureCache) {
+        if (!texture || !texture->isStreamed()) continue;
+        Texture* t = texture.get();
+        // The level on its way counts; nothing else is decided for it until it lands
+        if (t->m_StreamPending) {
+            t->m_RequestedLevel = UINT32_MAX;
+            t->m_LastRequestFrame = frame;
+            continue;
+        }
+        Entry e{ t, &texture, t->m_ResidentLevel, t->m_RequestedLevel != UINT32_MAX };
+        if (e.requested) {
+            t->m_LastRequestFrame = frame;
+            e.target = std::min(t->m_RequestedLevel, t->m_TailLevel);
+        }
+        else if (frame - t->m_LastRequestFrame > kIdleFrames) {
+            e.target = t->m_TailLevel;
+        }
+        t->m_RequestedLevel = UINT32_MAX;
+        total += static_cast<size_t>(t->streamedBytes(e.target));
+        entries.push_back(e);
+    }
+    if (entries.empty()) return;
+
+    // Over budget: drop what wasn't needed this frame, then the finest level of the sharpest
+    // textures, one level at a time so everything degrades evenly
+    auto coarsen = [&](Entry& e) {
+        if (e.target >= e.texture->m_TailLevel) return false;
+        total -= static_cast<size_t>(e.texture->streamedBytes(e.target) - e.texture->streamedBytes(e.target + 1));
+        ++e.target;
+        return true;
+    };
+    for (Entry& e : entries) {
+        if (total <= m_streamBudget) break;
+        if (!e.requested) while (coarsen(e)) {}
+    }
+    while (total > m_streamBudget) {
+        Entry* sharpest = nullptr;
+        for (Entry& e : entries)
+            if (e.target < e.texture->m_TailLevel && (!sharpest || e.target < sharpest->target)) sharpest = &e;
+        if (!sharpest) break;
+        coarsen(*sharpest);
+    }
+
+    // Drops are small re-uploads of the tail and free memory, so they all go; loads wait for
+    // their turn within the upload limit, finest requests first
+    std::vector<std::pair<std::shared_ptr<Texture>, uint32_t>> changes;
+    std::vector<Entry> loads;
+    for (const Entry& e : entries) {
+        if (e.target > e.texture->m_ResidentLevel) changes.emplace_back(*e.owner, e.target);
+        else if (e.target < e.texture->m_ResidentLevel) loads.push_back(e);
+    }
+    std::sort(loads.begin(), loads.end(), [](const Entry& a, const Entry& b) { return a.target < b.target; });
+    size_t uploaded = 0;
+    for (const Entry& e : loads) {
+        const size_t bytes = static_cast<size_t>(e.texture->streamedBytes(e.target));
+        if (uploaded > 0 && uploaded + bytes > m_streamUploadLimit) break;
+        uploaded += bytes;
+        changes.emplace_back(*e.owner, e.target);
+    }
+    if (changes.empty()) return;
+
+    // No wait here: the copies run behind the frame and finishStreamUploads swaps the images in
+    // (and marks their slots) on the first update after the fence has signalled
+    Texture::StreamUpload upload = Texture::BeginRestream(changes);
+    if (!upload.items.empty()) m_streamUploads.push_back(std::move(upload));
+}
+
+// Room for textures on the device-local heaps: what they use now plus what is left of the heap
+// budgets, keeping a tenth of the budget for buffers, render targets and the driver.
+// SIZE_MAX without VK_EXT_memory_budget.
+static size_t DeviceTextureBudget(size_t textureBytes) {
+    auto& vk = vulkanVars::GetInstance();
+    if (!vk.memoryBudget) return SIZE_MAX;
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget{};
+    budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    VkPhysicalDeviceMemoryProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    properties.pNext = &budget;
+    vkGetPhysicalDeviceMemoryProperties2(vk.physicalDevice, &properties);
+
+    VkDeviceSize heapBudget = 0, heapUsage = 0;
+    for (uint32_t i = 0; i < properties.memoryProperties.memoryHeapCount; ++i) {
+        if (!(properties.memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)) continue;
+        heapBudget += budget.heapBudget[i];
+        heapUsage += budget.heapUsage[i];
+    }
+    const VkDeviceSize limit = heapBudget - heapBudget / 10;
+    const VkDeviceSize others = heapUsage > textureBytes ? heapUsage - textureBytes : 0;
+    return limit > others ? static_cast<size_t>(limit - others) : 0;
+}
+
+void TextureManager::updateResidency(uint64_t frame) {
+    using CacheEntry = std::pair<const std::string, std::shared_ptr<Texture>>;
+    std::vector<CacheEntry*> candidates;
+    size_t total = 0;
+    for (auto& entry : m_textureCache) {
+        const auto& [key, texture] = entry;
+        if (!texture) continue;
+        Texture* t = texture.get();
+        const bool fileTexture = m_fileRoles.count(key) != 0;
+        if (t->m_Used || t->m_LastUseFrame == UINT64_MAX) {
+            t->m_LastUseFrame = frame;
+            if (t->m_Used && !t->isResident() && fileTexture) reload(key, texture);
+            t->m_Used = false;
+        }
+        total += static_cast<size_t>(t->getGpuBytes());
+
+        // Packed textures share their array's memory; streamed ones are bounded by the streaming budget
+        if (texture == m_standardTexture || t->isPacked() || !t->isResident()) continue;
+        if (frame - t->m_LastUseFrame < m_evictIdleFrames) continue;
+        const bool cacheOnly = texture.use_count() == 1;
+        if (!cacheOnly && (!fileTexture || t->isStreamed())) continue;
+        candidates.push_back(&entry);
+    }
+
+    m_effectiveBudget = m_residencyBudget;
+    if (m_followDeviceBudget) m_effectiveBudget = std::min(m_effectiveBudget, DeviceTextureBudget(total));
+    if (total <= m_effectiveBudget) return;
+
+    std::sort(candidates.begin(), candidates.end(), [](const CacheEntry* a, const CacheEntry* b) {
+        return a->second->m_LastUseFrame < b->second->m_LastUseFrame; });
+    for (CacheEntry* entry : candidates) {
+        if (total <= m_effectiveBudget) break;
+        Texture* t = entry->second.get();
+        total -= static_cast<size_t>(t->getGpuBytes());
+        // Frames in flight may still sample it; the slot goes back to the standard texture
+        m_retired.emplace_back(frame, t->detachGpu());
+        t->m_GpuBytes = 0;
+        markSlotDirty(entry->second);
+        if (entry->second.use_count() == 1) {
+            m_fileRoles.erase(entry->first);
+            m_textureCache.erase(entry->first);
+        }
+    }
+}
+
+void TextureManager::reload(const std::string& key, const std::shared_ptr<Texture>& texture) {
+    if (!m_reloading.insert(key).second) return;
+    std::weak_ptr<Texture> weak = texture;
+    const ObjUtils::TextureRole role = m_fileRoles.count(key) ? m_fileRoles[key] : ObjUtils::TextureRole::Color;
+    AssetLoader::GetInstance().enqueue<TextureImage>(key,
+        [key, role] { return Texture::Decode(key, role); },
+        [this, key, weak](TextureImage& image) {
+            m_reloading.erase(key);
+            auto texture = weak.lock();
+            if (!texture || texture->isResident()) return;
+            texture->upload(image, key);
+            markSlotDirty(texture);
+        });
+}
+
+size_t TextureManager::getEvictedCount() const {
+    size_t count = 0;
+    for (const auto& [key, texture] : m_textureCache)
+        if (texture && !texture->isResident()) ++count;
+    return count;
+}
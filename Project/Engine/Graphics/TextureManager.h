@@ -1,16 +1,45 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <string>
 #include <vector>
+#include <functional>
 #include <Engine/Graphics/Texture.h>
 #include <Engine/Core/Singleton.h>
 
 class TextureManager : public Singleton<TextureManager> {
 public:
-    // Get or create texture by filepath (uses cache)
-    std::shared_ptr<Texture> getOrCreateTexture(const std::string& filepath);
+    // Get or create texture by filepath (uses cache). 'role' picks the color space and cooked
+    // package; a file keeps the role it was first loaded with.
+    std::shared_ptr<Texture> getOrCreateTexture(const std::string& filepath,
+        ObjUtils::TextureRole role = ObjUtils::TextureRole::Color);
+
+    // Several textures at once: uncached files decode in parallel on the AssetLoader pool and are
+    // uploaded in one batch (see Texture::CreateBatch). Results follow 'filepaths'; empty paths give nullptr.
+    // 'roles' follows 'filepaths' too; missing entries are color. The calling thread decodes whatever
+    // the workers haven't picked up, so this doesn't deadlock when called from a pool task.
+    std::vector<std::shared_ptr<Texture>> loadMany(const std::vector<std::string>& filepaths,
+        const std::vector<ObjUtils::TextureRole>& roles = {});
+    // Same under arbitrary cache keys (see the keyed getOrCreateTexture); 'decode' runs on the pool
+    std::vector<std::shared_ptr<Texture>> loadMany(const std::vector<std::pair<std::string, std::function<TextureImage()>>>& sources);
+
+    // Import option: batches pack textures up to 'maxSize' texels that share format, size and mip
+    // count into 2D arrays (Texture::CreatePacked) instead of an image and table slot each.
+    // Only with descriptor indexing; packed textures aren't streamed.
+    void setPacking(bool enabled, uint32_t maxSize) { m_packTextures = enabled; m_packMaxSize = maxSize; }
+
+    // Cache lookup under an arbitrary key; 'decode' only runs on a miss. For textures that
+    // don't live in their own file (images embedded in a .glb, derived channel maps)
+    std::shared_ptr<Texture> getOrCreateTexture(const std::string& key, const std::function<TextureImage()>& decode);
+
+    // Non-blocking variant: decodes on the AssetLoader pool and uploads during AssetLoader::pump.
+    // Returns the cached texture, or the standard texture as a placeholder while loading.
+    // onReady runs on the main thread once the real texture exists (right away if cached).
+    using TextureReadyFn = std::function<void(const std::shared_ptr<Texture>&)>;
+    std::shared_ptr<Texture> getOrCreateTextureAsync(const std::string& filepath, ObjUtils::TextureRole role,
+        TextureReadyFn onReady = {});
 
     // Standard texture getter/setter (e.g. a default white or error texture)
     void setStandardTexture(const std::shared_ptr<Texture>& texture) { m_standardTexture = texture; }
@@ -38,16 +67,83 @@ public:
     // (Optional) Get all cached textures (not just active)
     std::vector<std::shared_ptr<Texture>> getAllCachedTextures() const;
 
-    bool isTextureListDirty() const { return m_textureListDirty; }
-    void clearTextureListDirty() { m_textureListDirty = false; }
+    // Device memory of all cached textures, mip chains included
+    size_t getGpuBytes() const;
+
+    // --- Streaming (textures with Texture::isStreamed) ---
+    // Each frame the scene asks for the finest level it needs per texture (0 = full resolution);
+    // updateStreaming then loads missing levels, nearest requests first and within the per-frame
+    // upload limit, drops levels nobody asked for in a while, and coarsens the sharpest textures
+    // while the streamed set is over budget. The uploads don't block: a texture keeps its current
+    // levels until a later update finds its upload finished. Call once per frame before the descriptor
+    // update, with vulkanVars::frameIndex (idle levels are aged by frame differences).
+    void requestLevel(const std::shared_ptr<Texture>& texture, uint32_t level);
+    void updateStreaming(uint64_t frame);
+    void setStreamingBudget(size_t bytes) { m_streamBudget = bytes; }
+    void setStreamingUploadLimit(size_t bytesPerFrame) { m_streamUploadLimit = bytesPerFrame; }
+    size_t getStreamingBudget() const { return m_streamBudget; }
+    size_t getStreamedBytes() const;
+    // Destroys the images streaming or eviction replaced; 'all' only once the device is idle.
+    // 'frame' is vulkanVars::frameIndex, as for updateStreaming and updateResidency.
+    void releaseRetired(uint64_t frame, bool all = false);
+
+    // --- Residency budget (all cached textures) ---
+    // requestLevel also marks a texture as used. While the cache is over budget, textures no visible
+    // material used for 'idleFrames' frames are evicted, least recently used first. Textures only the
+    // cache still holds are dropped from it (getOrCreateTexture loads them again); file textures that
+    // materials still hold keep their object and slot, show the standard texture, and reload in the
+    // background on their next use. With 'followDeviceBudget' the budget also shrinks to what
+    // VK_EXT_memory_budget leaves on the device-local heaps. Call once per frame after updateStreaming,
+    // with vulkanVars::frameIndex.
+    void updateResidency(uint64_t frame);
+    void setResidencyBudget(size_t bytes, uint64_t idleFrames, bool followDeviceBudget) {
+        m_residencyBudget = bytes; m_evictIdleFrames = idleFrames; m_followDeviceBudget = followDeviceBudget;
+    }
+    // Budget the last updateResidency worked with (device budget applied)
+    size_t getResidencyBudget() const { return m_effectiveBudget; }
+    // Cached textures currently without an image
+    size_t getEvictedCount() const;
+
+    // Texture table entries that changed since the last call (new textures, restreamed images);
+    // slots whose texture is gone or evicted fall back to the standard texture
+    std::vector<TextureSlot> takeDirtySlots();
 
 private:
     friend class Singleton<TextureManager>;
     TextureManager();
 
     std::unordered_map<std::string, std::shared_ptr<Texture>> m_textureCache;
+    // Async loads in flight -> callbacks waiting for them (main thread only)
+    std::unordered_map<std::string, std::vector<TextureReadyFn>> m_pendingTextures;
     std::vector<std::shared_ptr<Texture>> m_activeTextures;
     std::shared_ptr<Texture> m_standardTexture;
 
-    bool m_textureListDirty = true;
+    // Packs where it can, CreateBatch for the rest; results follow 'images'
+    std::vector<std::shared_ptr<Texture>> createTextures(const std::vector<TextureImage>& images, const std::vector<std::string>& names);
+
+    void markSlotDirty(const std::shared_ptr<Texture>& texture);
+    // Background decode + upload of an evicted file texture into its existing object
+    void reload(const std::string& key, const std::shared_ptr<Texture>& texture);
+    std::unordered_map<uint64_t, std::weak_ptr<Texture>> m_dirtySlots;
+
+    bool m_packTextures = true;
+    uint32_t m_packMaxSize = 256;
+
+    size_t m_streamBudget = size_t(1024) << 20;
+    size_t m_streamUploadLimit = size_t(32) << 20;
+    // Images replaced by streaming or evicted, with the frame that happened in
+    std::vector<std::pair<uint64_t, Texture::GpuHandles>> m_retired;
+    // Streaming uploads still on the GPU, oldest first
+    std::vector<Texture::StreamUpload> m_streamUploads;
+    // Swaps in the uploads whose fence signalled ('all': every one, the device must be idle)
+    void finishStreamUploads(uint64_t frame, bool all = false);
+
+    size_t m_residencyBudget = size_t(2048) << 20;
+    size_t m_effectiveBudget = size_t(2048) << 20;
+    uint64_t m_evictIdleFrames = 300;
+    bool m_followDeviceBudget = true;
+    // Cache keys that are file paths and the role they were loaded as, so an evicted texture can
+    // decode its file again
+    std::unordered_map<std::string, ObjUtils::TextureRole> m_fileRoles;
+    std::unordered_set<std::string> m_reloading;
 };
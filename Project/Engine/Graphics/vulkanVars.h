@@ -8,6 +8,8 @@ const uint32_t WIDTH = 800;
 const uint32_t HEIGHT = 600;
 const int MAX_FRAMES_IN_FLIGHT = 3;
 const int MAX_TEXTURES = 32;
+const uint32_t MAX_BINDLESS_TEXTURES = 16384; // texture table size with descriptor indexing (device limits permitting)
+const uint32_t MAX_TEXTURE_ARRAYS = 256;      // packed small textures (Texture::CreatePacked), descriptor indexing only
 
 class vulkanVars : public Singleton<vulkanVars> {
 public:
@@ -17,9 +19,19 @@ public:
 	VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
 	VkRenderPass renderPass = VK_NULL_HANDLE;
 	VkQueue graphicsQueue = VK_NULL_HANDLE;
+	bool textureCompressionBC = false; // BC1-7 sampling enabled on the device (cooked textures)
+	float maxSamplerAnisotropy = 1.0f; // 1 = samplerAnisotropy not available
+	// Descriptor indexing: one partially bound, update-after-bind texture table of 'textureSlots'
+	// entries. Without it the table is the classic MAX_TEXTURES sampler array.
+	bool bindlessTextures = false;
+	uint32_t textureSlots = MAX_TEXTURES;
+	bool memoryBudget = false; // VK_EXT_memory_budget: heap budgets for TextureManager::updateResidency
 	VkExtent2D swapChainExtent;
 	std::vector<CommandBuffer> commandBuffers; 
 	size_t currentFrame = 0;
+	// Frames since start, never reset (Game::run rewinds currentFrame every second). Use it for
+	// anything that compares frames: retirement, idle timeouts, LRU.
+	uint64_t frameIndex = 0;
 };
 
 
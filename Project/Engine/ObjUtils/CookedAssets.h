@@ -0,0 +1,348 @@
+// CookedAssets.h
+#pragma once
+
+#include <glm/glm.hpp>
+#include <Engine/Graphics/Vertex.h>
+#include <Engine/Graphics/MeshBlob.h>
+#include <Engine/Core/AssetArchive.h>
+#include <Engine/Core/Hash.h>
+#include <Engine/ObjUtils/Ktx2.h>
+#include <Engine/ObjUtils/TextureRole.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// Runtime packages written by the offline AssetCooker (Tools/AssetCooker).
+//   <cookedDir>/<source path>.vmesh  CookedMeshHeader | CookedVertex[] or Vertex[] | uint16/uint32 indices
+//   <cookedDir>/<source path>.ktx2   KTX2 (see Ktx2.h), source hash/size in its key/value data
+// Unlike the .meshbin cache, nothing here depends on timestamps: headers only hold content
+// hashes, so cooking the same sources twice gives byte-identical files. At load time a package is
+// trusted unless the source file still exists and its size differs (cheap staleness guard for
+// development; the cooker itself is the real invalidation via its manifest).
+namespace ObjUtils {
+
+    // Bump whenever the cooked output changes (quantization, optimizer, compressor, ...)
+    constexpr uint32_t kCookedMeshVersion = 1;
+    constexpr uint32_t kCookedTextureVersion = 2;
+    constexpr char kCookedMeshMagic[4] = { 'V', 'R', 'C', 'M' };
+
+    enum class CookedVertexFormat : uint32_t {
+        Float = 0,      // engine Vertex as is
+        Quantized = 1,  // CookedVertex
+    };
+
+    // 24 bytes instead of 44: position as unorm16 inside the mesh bounds, octahedral normal,
+    // unorm8 color. UVs stay float since tiling coordinates leave [0,1].
+    struct CookedVertex {
+        uint16_t pos[3];
+        uint16_t pad;
+        int16_t  normal[2];
+        uint8_t  color[4];
+        float    texCoord[2];
+    };
+    static_assert(sizeof(CookedVertex) == 24, "CookedVertex layout changed; bump kCookedMeshVersion");
+
+    struct CookedMeshHeader {
+        char     magic[4];
+        uint32_t version;
+        uint64_t sourceHash;     // XXH64 of the source file
+        uint64_t sourceSize;
+        uint64_t importFlags;    // MakeAssetId flag bits the mesh was imported with
+        uint64_t contentHash;    // Hash::Geometry of the decoded vertices/indices
+        uint32_t vertexFormat;   // CookedVertexFormat
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t indexSize;      // 2 or 4
+        float    boundsMin[3];
+        float    boundsMax[3];
+    };
+    static_assert(sizeof(CookedMeshHeader) == 80, "CookedMeshHeader layout changed; bump kCookedMeshVersion");
+
+    namespace detail {
+        struct CookedAssetConfig {
+            std::mutex mtx;
+            std::string dir;     // empty = disabled
+        };
+        inline CookedAssetConfig& CookedAssetSettings() {
+            static CookedAssetConfig c;
+            return c;
+        }
+
+        // Only relative sources map into the cooked tree ("Resources/x.obj" -> "<dir>/Resources/x.obj.vmesh")
+        inline std::string CookedPath(const std::string& dir, const std::string& sourcePath, const char* ext) {
+            if (dir.empty() || sourcePath.empty() || std::filesystem::path(sourcePath).is_absolute()) return {};
+            return (std::filesystem::path(dir) / (sourcePath + ext)).generic_string();
+        }
+
+        inline bool SourceStillMatches(const std::string& sourcePath, uint64_t cookedSize) {
+            std::error_code ec;
+            const auto size = std::filesystem::file_size(sourcePath, ec);
+            return ec || static_cast<uint64_t>(size) == cookedSize; // missing source = shipped build
+        }
+
+        inline uint16_t QuantizeUnorm16(float v, float mn, float extent) {
+            if (extent <= 0.f) return 0;
+            const float t = std::clamp((v - mn) / extent, 0.f, 1.f);
+            return static_cast<uint16_t>(std::lround(t * 65535.f));
+        }
+
+        inline int16_t QuantizeSnorm16(float v) {
+            return static_cast<int16_t>(std::lround(std::clamp(v, -1.f, 1.f) * 32767.f));
+        }
+
+        inline uint8_t QuantizeUnorm8(float v) {
+            return static_cast<uint8_t>(std::lround(std::clamp(v, 0.f, 1.f) * 255.f));
+        }
+
+        // Octahedral normal encoding. (-32768, -32768) is outside the encoded range and marks a
+        // zero normal (OBJ files without normals), so those survive a round trip unchanged.
+        inline void EncodeOctNormal(const glm::vec3& n, int16_t out[2]) {
+            const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+            if (l1 <= 0.f) { out[0] = out[1] = -32768; return; }
+            glm::vec2 p(n.x / l1, n.y / l1);
+            if (n.z < 0.f) {
+                p = glm::vec2((1.f - std::abs(p.y)) * (p.x >= 0.f ? 1.f : -1.f),
+                    (1.f - std::abs(p.x)) * (p.y >= 0.f ? 1.f : -1.f));
+            }
+            out[0] = QuantizeSnorm16(p.x);
+            out[1] = QuantizeSnorm16(p.y);
+        }
+
+        inline glm::vec3 DecodeOctNormal(const int16_t in[2]) {
+            if (in[0] == -32768 && in[1] == -32768) return glm::vec3(0.f);
+            glm::vec3 v(in[0] / 32767.f, in[1] / 32767.f, 0.f);
+            v.z = 1.f - std::abs(v.x) - std::abs(v.y);
+            const float t = std::max(-v.z, 0.f);
+            v.x += v.x >= 0.f ? -t : t;
+            v.y += v.y >= 0.f ? -t : t;
+            return glm::normalize(v);
+        }
+
+        inline Vertex DecodeCookedVertex(const CookedVertex& q, const glm::vec3& mn, const glm::vec3& extent) {
+            Vertex v;
+            for (int k = 0; k < 3; ++k) v.pos[k] = mn[k] + extent[k] * (q.pos[k] / 65535.f);
+            v.normal = DecodeOctNormal(q.normal);
+            v.color = glm::vec3(q.color[0], q.color[1], q.color[2]) / 255.f;
+            v.texCoord = glm::vec2(q.texCoord[0], q.texCoord[1]);
+            return v;
+        }
+
+        inline bool WriteFileAtomic(const std::string& path, const std::vector<std::pair<const void*, size_t>>& parts) {
+            std::error_code ec;
+            const std::filesystem::path target(path);
+            if (target.has_parent_path()) std::filesystem::create_directories(target.parent_path(), ec);
+
+            const std::string tmpPath = path + ".tmp";
+            {
+                std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+                if (!out) return false;
+                for (const auto& [data, size] : parts)
+                    out.write(static_cast<const char*>(data), std::streamsize(size));
+                if (!out) { out.close(); std::filesystem::remove(tmpPath, ec); return false; }
+            }
+            std::filesystem::rename(tmpPath, path, ec);
+            if (ec) {
+                std::cerr << "[CookedAssets] failed to write \"" << path << "\": " << ec.message() << "\n";
+                std::filesystem::remove(tmpPath, ec);
+                return false;
+            }
+            return true;
+        }
+    }
+
+    // Root of the cooked tree; empty disables cooked lookups
+    inline void SetCookedAssetDir(const std::string& dir) {
+        auto& c = detail::CookedAssetSettings();
+        std::lock_guard<std::mutex> lock(c.mtx);
+        c.dir = dir;
+    }
+
+    inline std::string GetCookedAssetDir() {
+        auto& c = detail::CookedAssetSettings();
+        std::lock_guard<std::mutex> lock(c.mtx);
+        return c.dir;
+    }
+
+    // Cooked form of one import: quantizes (or copies) the geometry and writes the package.
+    // Returns the decoded blob, i.e. exactly what LoadCookedMesh will hand out at runtime.
+    inline MeshBlobPtr WriteCookedMesh(const std::string& outPath, uint64_t sourceHash, uint64_t sourceSize,
+        uint64_t importFlags, const MeshBlob& geometry, bool quantize)
+    {
+        // Views, so a mapped mesh cache entry works as a source too
+        const ArrayView<Vertex> vertices = geometry.vertexData();
+        const ArrayView<uint32_t> indices = geometry.indexData();
+
+        CookedMeshHeader h{};
+        std::memcpy(h.magic, kCookedMeshMagic, 4);
+        h.version = kCookedMeshVersion;
+        h.sourceHash = sourceHash;
+        h.sourceSize = sourceSize;
+        h.importFlags = importFlags;
+        h.vertexFormat = static_cast<uint32_t>(quantize ? CookedVertexFormat::Quantized : CookedVertexFormat::Float);
+        h.vertexCount = static_cast<uint32_t>(vertices.size());
+        h.indexCount = static_cast<uint32_t>(indices.size());
+        h.indexSize = h.vertexCount <= 0xFFFFu ? 2 : 4;
+
+        glm::vec3 mn(0.f), mx(0.f);
+        if (!vertices.empty()) {
+            mn = mx = vertices[0].pos;
+            for (const Vertex& v : vertices) { mn = glm::min(mn, v.pos); mx = glm::max(mx, v.pos); }
+        }
+        for (int k = 0; k < 3; ++k) { h.boundsMin[k] = mn[k]; h.boundsMax[k] = mx[k]; }
+        const glm::vec3 extent = mx - mn;
+
+        auto decoded = std::make_shared<MeshBlob>();
+        std::vector<CookedVertex> packed;
+        if (quantize) {
+            packed.resize(vertices.size());
+            decoded->vertices.resize(vertices.size());
+            for (size_t i = 0; i < packed.size(); ++i) {
+                const Vertex& v = vertices[i];
+                CookedVertex& q = packed[i];
+                for (int k = 0; k < 3; ++k) q.pos[k] = detail::QuantizeUnorm16(v.pos[k], mn[k], extent[k]);
+                q.pad = 0;
+                detail::EncodeOctNormal(v.normal, q.normal);
+                for (int k = 0; k < 3; ++k) q.color[k] = detail::QuantizeUnorm8(v.color[k]);
+                q.color[3] = 255;
+                q.texCoord[0] = v.texCoord.x;
+                q.texCoord[1] = v.texCoord.y;
+            }
+        }
+        else {
+            decoded->vertices.assign(vertices.begin(), vertices.end());
+        }
+
+        std::vector<uint16_t> indices16;
+        if (h.indexSize == 2) indices16.assign(indices.begin(), indices.end());
+        decoded->indices.assign(indices.begin(), indices.end());
+
+        std::vector<std::pair<const void*, size_t>> parts;
+        parts.emplace_back(&h, sizeof(h)); // contentHash is filled in below, before the write
+        if (quantize) parts.emplace_back(packed.data(), packed.size() * sizeof(CookedVertex));
+        else parts.emplace_back(vertices.data(), vertices.size() * sizeof(Vertex));
+        if (h.indexSize == 2) parts.emplace_back(indices16.data(), indices16.size() * sizeof(uint16_t));
+        else parts.emplace_back(indices.data(), indices.size() * sizeof(uint32_t));
+
+        // Hash what the runtime will actually see after dequantization
+        if (quantize) {
+            for (size_t i = 0; i < packed.size(); ++i)
+                decoded->vertices[i] = detail::DecodeCookedVertex(packed[i], mn, extent);
+        }
+        decoded->contentHash = Hash::Geometry(decoded->vertices, decoded->indices);
+        decoded->hasBounds = true;
+        decoded->boundsMin = mn;
+        decoded->boundsMax = mx;
+        h.contentHash = decoded->contentHash;
+
+        if (!detail::WriteFileAtomic(outPath, parts)) return nullptr;
+        return decoded;
+    }
+
+    // Runtime side: the cooked import of 'sourcePath' if it exists and was cooked with 'importFlags'
+    inline std::shared_ptr<MeshBlob> LoadCookedMesh(const char* sourcePath, uint64_t importFlags) {
+        if (!sourcePath) return nullptr;
+        const std::string path = detail::CookedPath(GetCookedAssetDir(), sourcePath, ".vmesh");
+        if (path.empty()) return nullptr;
+
+        const AssetData file = AssetArchive::Open(path);
+        if (!file || file.size < sizeof(CookedMeshHeader)) return nullptr;
+
+        CookedMeshHeader h;
+        std::memcpy(&h, file.data, sizeof(h));
+        if (std::memcmp(h.magic, kCookedMeshMagic, 4) != 0 ||
+            h.version != kCookedMeshVersion ||
+            h.importFlags != importFlags ||
+            (h.indexSize != 2 && h.indexSize != 4) ||
+            !detail::SourceStillMatches(sourcePath, h.sourceSize)) {
+            return nullptr;
+        }
+
+        const bool quantized = h.vertexFormat == static_cast<uint32_t>(CookedVertexFormat::Quantized);
+        const size_t vBytes = size_t(h.vertexCount) * (quantized ? sizeof(CookedVertex) : sizeof(Vertex));
+        const size_t iBytes = size_t(h.indexCount) * h.indexSize;
+        if (file.size != sizeof(CookedMeshHeader) + vBytes + iBytes) return nullptr;
+
+        auto blob = std::make_shared<MeshBlob>();
+        const uint8_t* p = file.data + sizeof(CookedMeshHeader);
+        blob->vertices.resize(h.vertexCount);
+        if (quantized) {
+            const glm::vec3 mn(h.boundsMin[0], h.boundsMin[1], h.boundsMin[2]);
+            const glm::vec3 extent = glm::vec3(h.boundsMax[0], h.boundsMax[1], h.boundsMax[2]) - mn;
+            for (uint32_t i = 0; i < h.vertexCount; ++i) {
+                CookedVertex q;
+                std::memcpy(&q, p + size_t(i) * sizeof(CookedVertex), sizeof(q));
+                blob->vertices[i] = detail::DecodeCookedVertex(q, mn, extent);
+            }
+        }
+        else if (vBytes) {
+            std::memcpy(blob->vertices.data(), p, vBytes);
+        }
+
+        p += vBytes;
+        blob->indices.resize(h.indexCount);
+        if (h.indexSize == 4) {
+            if (iBytes) std::memcpy(blob->indices.data(), p, iBytes);
+        }
+        else {
+            for (uint32_t i = 0; i < h.indexCount; ++i) {
+                uint16_t idx;
+                std::memcpy(&idx, p + size_t(i) * 2, 2);
+                blob->indices[i] = idx;
+            }
+        }
+
+        blob->contentHash = h.contentHash;
+        blob->hasBounds = true;
+        blob->boundsMin = glm::vec3(h.boundsMin[0], h.boundsMin[1], h.boundsMin[2]);
+        blob->boundsMax = glm::vec3(h.boundsMax[0], h.boundsMax[1], h.boundsMax[2]);
+        return blob;
+    }
+
+    // 'mips' holds the levels back to back, starting at width x height
+    inline bool WriteCookedTexture(const std::string& outPath, uint64_t sourceHash, uint64_t sourceSize, TextureRole role,
+        Ktx2Format format, uint32_t width, uint32_t height, uint32_t mipLevels, const std::vector<uint8_t>& mips)
+    {
+        char hash[17];
+        std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(sourceHash));
+        const std::vector<uint8_t> file = EncodeKTX2(format, width, height, mipLevels, mips, {
+            { "KTXwriter", "VulkanRenderer AssetCooker" },
+            { "VRcookVersion", std::to_string(kCookedTextureVersion) },
+            { "VRsourceHash", hash },
+            { "VRsourceSize", std::to_string(sourceSize) },
+            { "VRrole", TextureRoleName(role) } });
+        if (file.empty()) return false;
+        return detail::WriteFileAtomic(outPath, { { file.data(), file.size() } });
+    }
+
+    // Runtime side: maps the package (or views it inside the archive), pixel data is not copied.
+    // A package cooked for another role is ignored, so the source decodes in the right color space.
+    inline bool LoadCookedTexture(const std::string& sourcePath, TextureRole role, Ktx2Texture& out) {
+        const std::string path = detail::CookedPath(GetCookedAssetDir(), sourcePath, ".ktx2");
+        if (path.empty()) return false;
+
+        AssetData file = AssetArchive::Open(path);
+        if (!file || !ParseKTX2(file, out, path)) return false;
+
+        auto value = [&out](const char* key) {
+            auto it = out.keyValues.find(key);
+            return it != out.keyValues.end() ? it->second : std::string();
+            };
+        if (value("VRcookVersion") != std::to_string(kCookedTextureVersion)) return false;
+        if (value("VRrole") != TextureRoleName(role)) return false;
+        const std::string size = value("VRsourceSize");
+        if (size.empty() || !detail::SourceStillMatches(sourcePath, std::strtoull(size.c_str(), nullptr, 10))) return false;
+        return !out.levels.empty();
+    }
+
+} // namespace ObjUtils
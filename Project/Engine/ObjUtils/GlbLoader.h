@@ -0,0 +1,482 @@
+// GlbLoader.h
+#pragma once
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <nlohmann/json.hpp>
+#include <Engine/Graphics/Vertex.h>
+#include <Engine/Graphics/MeshBlob.h>
+#include <Engine/Core/AssetArchive.h>
+#include <Engine/Core/Hash.h>
+#include <Engine/ObjUtils/MeshOptimizer.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ObjUtils {
+
+    // --------------- glTF 2.0 binary (.glb) ----------------
+    // LoadGLB maps the file (or views it inside the mounted AssetArchive) and parses the JSON chunk
+    // only; buffer views are read in place from the mapping. Geometry is decoded per primitive on demand (DecodeGlbPrimitive), so spawning
+    // an asset whose meshes are already live costs the JSON parse and nothing else.
+    // Supported: triangle primitives, embedded or external images, node hierarchies and
+    // EXT_mesh_gpu_instancing. Not supported: sparse accessors, compressed geometry/textures.
+
+    struct GlbImage {
+        const uint8_t* data = nullptr; // encoded PNG/JPEG inside the mapping
+        size_t size = 0;
+        std::string uri;               // external file (already resolved against the .glb folder) when data is null
+    };
+
+    struct GlbMaterial {
+        int baseColorImage = -1;          // indices into GlbAsset::images, -1 = none
+        int normalImage = -1;
+        int metallicRoughnessImage = -1;  // glTF packing: roughness in G, metalness in B
+    };
+
+    struct GlbPrimitive {
+        int material = -1;
+        int indices = -1;                 // accessor indices, -1 = absent
+        int position = -1, normal = -1, color = -1, texCoord = -1;
+    };
+
+    struct GlbMesh {
+        std::vector<GlbPrimitive> primitives;
+    };
+
+    // One placement of a mesh: per node, and per instance for EXT_mesh_gpu_instancing
+    struct GlbDraw {
+        uint32_t mesh = 0;
+        glm::mat4 transform{ 1.f };       // relative to the asset root
+    };
+
+    struct GlbAsset {
+        std::string path;
+        std::shared_ptr<const void> file; // bin and image data point into this file (mapping or archive entry)
+        const uint8_t* bin = nullptr;
+        size_t binSize = 0;
+        nlohmann::json json;
+        std::vector<GlbMesh> meshes;
+        std::vector<GlbMaterial> materials;
+        std::vector<GlbImage> images;
+        std::vector<GlbDraw> draws;
+    };
+
+    // MeshManager asset key of one primitive
+    inline uint64_t MakeGlbAssetId(const std::string& path, uint32_t mesh, uint32_t primitive, bool optimize = false) {
+        const uint64_t file = Hash::Combine(Hash::Path(path), optimize ? 0x676C6231ull : 0x676C6230ull); // "glb1"/"glb0"
+        return Hash::Combine(file, (uint64_t(mesh) << 32) | primitive);
+    }
+
+    namespace detail {
+        constexpr uint32_t kGlbMagic = 0x46546C67;     // "glTF"
+        constexpr uint32_t kGlbChunkJson = 0x4E4F534A; // "JSON"
+        constexpr uint32_t kGlbChunkBin = 0x004E4942;  // "BIN\0"
+
+        enum GlbComponent : int {
+            kGlbByte = 5120, kGlbUByte = 5121, kGlbShort = 5122,
+            kGlbUShort = 5123, kGlbUInt = 5125, kGlbFloat = 5126
+        };
+
+        // Resolved accessor: element i starts at data + i * stride
+        struct GlbAccessor {
+            const uint8_t* data = nullptr;
+            size_t count = 0;
+            size_t stride = 0;
+            int componentType = 0;
+            int components = 0;
+            bool normalized = false;
+        };
+
+        inline uint32_t ReadU32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, sizeof(v)); return v; }
+
+        inline int GlbComponentCount(const std::string& type) {
+            if (type == "SCALAR") return 1;
+            if (type == "VEC2") return 2;
+            if (type == "VEC3") return 3;
+            if (type == "VEC4") return 4;
+            if (type == "MAT4") return 16;
+            return 0;
+        }
+
+        inline size_t GlbComponentSize(int componentType) {
+            switch (componentType) {
+            case kGlbByte: case kGlbUByte: return 1;
+            case kGlbShort: case kGlbUShort: return 2;
+            case kGlbUInt: case kGlbFloat: return 4;
+            default: return 0;
+            }
+        }
+
+        // Throws std::runtime_error for anything that would read outside the BIN chunk
+        inline GlbAccessor GetGlbAccessor(const GlbAsset& asset, int index) {
+            const auto& accessors = asset.json.at("accessors");
+            if (index < 0 || index >= (int)accessors.size()) throw std::runtime_error("accessor index out of range");
+            const auto& a = accessors[index];
+            if (a.contains("sparse")) throw std::runtime_error("sparse accessors are not supported");
+            if (!a.contains("bufferView")) throw std::runtime_error("accessor without bufferView");
+
+            GlbAccessor acc{};
+            acc.count = a.at("count").get<size_t>();
+            acc.componentType = a.at("componentType").get<int>();
+            acc.components = GlbComponentCount(a.at("type").get<std::string>());
+            acc.normalized = a.value("normalized", false);
+            const size_t elemSize = GlbComponentSize(acc.componentType) * acc.components;
+            if (elemSize == 0) throw std::runtime_error("unsupported accessor type");
+
+            const auto& view = asset.json.at("bufferViews").at(a.at("bufferView").get<size_t>());
+            if (view.value("buffer", 0) != 0) throw std::runtime_error("only the embedded BIN buffer is supported");
+            const size_t viewOffset = view.value("byteOffset", size_t(0));
+            const size_t viewLength = view.at("byteLength").get<size_t>();
+            const size_t offset = a.value("byteOffset", size_t(0));
+            acc.stride = view.value("byteStride", size_t(0));
+            if (acc.stride == 0) acc.stride = elemSize;
+
+            if (viewOffset + viewLength > asset.binSize) throw std::runtime_error("bufferView outside BIN chunk");
+            if (acc.count > 0 && offset + (acc.count - 1) * acc.stride + elemSize > viewLength)
+                throw std::runtime_error("accessor outside its bufferView");
+            acc.data = asset.bin + viewOffset + offset;
+            return acc;
+        }
+
+        inline float ReadGlbComponent(const uint8_t* p, int componentType, bool normalized) {
+            switch (componentType) {
+            case kGlbFloat: { float v; std::memcpy(&v, p, 4); return v; }
+            case kGlbByte: { int8_t v = (int8_t)*p; return normalized ? std::max(v / 127.f, -1.f) : float(v); }
+            case kGlbUByte: return normalized ? *p / 255.f : float(*p);
+            case kGlbShort: { int16_t v; std::memcpy(&v, p, 2); return normalized ? std::max(v / 32767.f, -1.f) : float(v); }
+            case kGlbUShort: { uint16_t v; std::memcpy(&v, p, 2); return normalized ? v / 65535.f : float(v); }
+            case kGlbUInt: { uint32_t v; std::memcpy(&v, p, 4); return float(v); }
+            default: return 0.f;
+            }
+        }
+
+        // Reads up to n components of element i; missing ones keep their value in 'out'
+        inline void ReadGlbFloats(const GlbAccessor& acc, size_t i, float* out, int n) {
+            const uint8_t* p = acc.data + i * acc.stride;
+            const size_t cs = GlbComponentSize(acc.componentType);
+            const int m = std::min(n, acc.components);
+            for (int c = 0; c < m; ++c) out[c] = ReadGlbComponent(p + c * cs, acc.componentType, acc.normalized);
+        }
+
+        inline bool IsTightFloat(const GlbAccessor& acc, int components) {
+            return acc.componentType == kGlbFloat && acc.components == components;
+        }
+
+        inline glm::mat4 GlbNodeMatrix(const nlohmann::json& node) {
+            if (node.contains("matrix")) {
+                float m[16];
+                for (int i = 0; i < 16; ++i) m[i] = node["matrix"][i].get<float>();
+                return glm::make_mat4(m); // glTF is column-major, like glm
+            }
+            glm::vec3 t(0.f), s(1.f);
+            glm::quat r(1.f, 0.f, 0.f, 0.f);
+            if (node.contains("translation")) t = { node["translation"][0].get<float>(), node["translation"][1].get<float>(), node["translation"][2].get<float>() };
+            if (node.contains("rotation"))    r = glm::quat(node["rotation"][3].get<float>(), node["rotation"][0].get<float>(), node["rotation"][1].get<float>(), node["rotation"][2].get<float>());
+            if (node.contains("scale"))       s = { node["scale"][0].get<float>(), node["scale"][1].get<float>(), node["scale"][2].get<float>() };
+            return glm::translate(glm::mat4(1.f), t) * glm::toMat4(r) * glm::scale(glm::mat4(1.f), s);
+        }
+
+        inline void VisitGlbNode(GlbAsset& asset, size_t nodeIndex, const glm::mat4& parent, int depth) {
+            const auto& nodes = asset.json.at("nodes");
+            if (nodeIndex >= nodes.size() || depth > 64) return; // depth guard against cyclic files
+            const auto& node = nodes[nodeIndex];
+            const glm::mat4 world = parent * GlbNodeMatrix(node);
+
+            if (node.contains("mesh")) {
+                const uint32_t mesh = node["mesh"].get<uint32_t>();
+                const nlohmann::json* inst = nullptr;
+                if (node.contains("extensions") && node["extensions"].contains("EXT_mesh_gpu_instancing"))
+                    inst = &node["extensions"]["EXT_mesh_gpu_instancing"].at("attributes");
+
+                if (!inst) {
+                    asset.draws.push_back({ mesh, world });
+                }
+                else {
+                    // Per-instance TRS; the node's own transform applies on top
+                    GlbAccessor t{}, r{}, s{};
+                    size_t count = 0;
+                    if (inst->contains("TRANSLATION")) { t = GetGlbAccessor(asset, (*inst)["TRANSLATION"].get<int>()); count = t.count; }
+                    if (inst->contains("ROTATION"))    { r = GetGlbAccessor(asset, (*inst)["ROTATION"].get<int>());    count = r.count; }
+                    if (inst->contains("SCALE"))       { s = GetGlbAccessor(asset, (*inst)["SCALE"].get<int>());       count = s.count; }
+                    asset.draws.reserve(asset.draws.size() + count);
+                    for (size_t i = 0; i < count; ++i) {
+                        glm::vec3 tv(0.f), sv(1.f);
+                        glm::vec4 rv(0.f, 0.f, 0.f, 1.f);
+                        if (t.data && i < t.count) ReadGlbFloats(t, i, &tv.x, 3);
+                        if (r.data && i < r.count) ReadGlbFloats(r, i, &rv.x, 4);
+                        if (s.data && i < s.count) ReadGlbFloats(s, i, &sv.x, 3);
+                        const glm::mat4 local = glm::translate(glm::mat4(1.f), tv)
+                            * glm::toMat4(glm::quat(rv.w, rv.x, rv.y, rv.z))
+                            * glm::scale(glm::mat4(1.f), sv);
+                        asset.draws.push_back({ mesh, world * local });
+                    }
+                }
+            }
+
+            if (node.contains("children"))
+                for (const auto& child : node["children"])
+                    VisitGlbNode(asset, child.get<size_t>(), world, depth + 1);
+        }
+
+        inline int GlbTextureImage(const nlohmann::json& json, const nlohmann::json& textureInfo) {
+            const size_t tex = textureInfo.at("index").get<size_t>();
+            const auto& t = json.at("textures").at(tex);
+            return t.contains("source") ? t["source"].get<int>() : -1;
+        }
+
+        inline bool LoadGLBImpl(const std::string& path, GlbAsset& out) {
+            AssetData file = AssetArchive::Open(path);
+            if (!file) {
+                std::cerr << "[LoadGLB] cannot open \"" << path << "\"\n";
+                return false;
+            }
+            const uint8_t* p = file.data;
+            const size_t size = file.size;
+            if (size < 20 || ReadU32(p) != kGlbMagic || ReadU32(p + 4) != 2) {
+                std::cerr << "[LoadGLB] \"" << path << "\" is not a glTF 2.0 binary\n";
+                return false;
+            }
+
+            out = GlbAsset{};
+            out.path = path;
+
+            // ---- chunks: JSON first, optional BIN second ----
+            const size_t total = std::min<size_t>(ReadU32(p + 8), size);
+            const char* jsonBegin = nullptr;
+            size_t jsonSize = 0;
+            for (size_t off = 12; off + 8 <= total;) {
+                const size_t len = ReadU32(p + off);
+                const uint32_t type = ReadU32(p + off + 4);
+                if (off + 8 + len > total) break;
+                if (type == kGlbChunkJson && !jsonBegin) { jsonBegin = reinterpret_cast<const char*>(p + off + 8); jsonSize = len; }
+                else if (type == kGlbChunkBin && !out.bin) { out.bin = p + off + 8; out.binSize = len; }
+                off += 8 + ((len + 3) & ~size_t(3));
+            }
+            if (!jsonBegin) {
+                std::cerr << "[LoadGLB] \"" << path << "\" has no JSON chunk\n";
+                return false;
+            }
+            out.json = nlohmann::json::parse(jsonBegin, jsonBegin + jsonSize);
+            out.file = std::move(file.owner);
+            const auto& json = out.json;
+
+            if (json.contains("extensionsRequired")) {
+                for (const auto& ext : json["extensionsRequired"]) {
+                    if (ext.get<std::string>() != "EXT_mesh_gpu_instancing") {
+                        std::cerr << "[LoadGLB] \"" << path << "\" requires unsupported extension " << ext.get<std::string>() << "\n";
+                        return false;
+                    }
+                }
+            }
+
+            // ---- images (embedded views stay in the mapping) ----
+            if (json.contains("images")) {
+                for (const auto& img : json["images"]) {
+                    GlbImage image{};
+                    if (img.contains("bufferView")) {
+                        const auto& view = json.at("bufferViews").at(img["bufferView"].get<size_t>());
+                        const size_t off = view.value("byteOffset", size_t(0));
+                        const size_t len = view.at("byteLength").get<size_t>();
+                        if (off + len <= out.binSize) { image.data = out.bin + off; image.size = len; }
+                    }
+                    else if (img.contains("uri")) {
+                        const std::string uri = img["uri"].get<std::string>();
+                        if (uri.rfind("data:", 0) != 0) {
+                            const size_t slash = path.find_last_of("/\\");
+                            image.uri = (slash == std::string::npos ? std::string() : path.substr(0, slash + 1)) + uri;
+                        }
+                    }
+                    out.images.push_back(std::move(image));
+                }
+            }
+
+            // ---- materials (metallic-roughness) ----
+            if (json.contains("materials")) {
+                for (const auto& m : json["materials"]) {
+                    GlbMaterial mat{};
+                    if (m.contains("pbrMetallicRoughness")) {
+                        const auto& pbr = m["pbrMetallicRoughness"];
+                        if (pbr.contains("baseColorTexture")) mat.baseColorImage = GlbTextureImage(json, pbr["baseColorTexture"]);
+                        if (pbr.contains("metallicRoughnessTexture")) mat.metallicRoughnessImage = GlbTextureImage(json, pbr["metallicRoughnessTexture"]);
+                    }
+                    if (m.contains("normalTexture")) mat.normalImage = GlbTextureImage(json, m["normalTexture"]);
+                    out.materials.push_back(mat);
+                }
+            }
+
+            // ---- meshes (accessor indices only, decoded later) ----
+            if (json.contains("meshes")) {
+                for (const auto& m : json["meshes"]) {
+                    GlbMesh mesh{};
+                    for (const auto& prim : m.at("primitives")) {
+                        GlbPrimitive gp{};
+                        if (prim.value("mode", 4) != 4) {
+                            std::cerr << "[LoadGLB] \"" << path << "\": skipping non-triangle primitive\n";
+                        }
+                        else {
+                            const auto& attr = prim.at("attributes");
+                            gp.position = attr.value("POSITION", -1);
+                            gp.normal = attr.value("NORMAL", -1);
+                            gp.color = attr.value("COLOR_0", -1);
+                            gp.texCoord = attr.value("TEXCOORD_0", -1);
+                            gp.indices = prim.value("indices", -1);
+                            gp.material = prim.value("material", -1);
+                        }
+                        mesh.primitives.push_back(gp); // keep indices stable for MakeGlbAssetId
+                    }
+                    out.meshes.push_back(std::move(mesh));
+                }
+            }
+
+            // ---- placements ----
+            if (json.contains("nodes")) {
+                std::vector<size_t> roots;
+                if (json.contains("scenes") && !json["scenes"].empty()) {
+                    const size_t scene = json.value("scene", size_t(0));
+                    for (const auto& n : json["scenes"].at(scene).value("nodes", nlohmann::json::array()))
+                        roots.push_back(n.get<size_t>());
+                }
+                else {
+                    // No scene list: every node that is nobody's child is a root
+                    std::vector<bool> isChild(json["nodes"].size(), false);
+                    for (const auto& n : json["nodes"])
+                        for (const auto& c : n.value("children", nlohmann::json::array()))
+                            if (c.get<size_t>() < isChild.size()) isChild[c.get<size_t>()] = true;
+                    for (size_t i = 0; i < isChild.size(); ++i) if (!isChild[i]) roots.push_back(i);
+                }
+                for (size_t r : roots) VisitGlbNode(out, r, glm::mat4(1.f), 0);
+            }
+            return true;
+        }
+    }
+
+    inline bool LoadGLB(const std::string& path, GlbAsset& out) {
+        try {
+            return detail::LoadGLBImpl(path, out);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "[LoadGLB] \"" << path << "\": " << e.what() << "\n";
+            return false;
+        }
+    }
+
+    // Vertex/index data of one primitive, nullptr if it can't be decoded.
+    // When the file already stores Vertex-interleaved floats (and 32-bit indices) the blob points
+    // at those buffer views and holds the file (MeshBlob::mapping); only other layouts, and
+    // 'optimize', which reorders the data, are converted into the blob's own arrays.
+    inline MeshBlobPtr DecodeGlbPrimitive(const GlbAsset& asset, uint32_t meshIndex, uint32_t primIndex, bool optimize = false) {
+        using namespace detail;
+        try {
+            if (meshIndex >= asset.meshes.size() || primIndex >= asset.meshes[meshIndex].primitives.size()) return nullptr;
+            const GlbPrimitive& prim = asset.meshes[meshIndex].primitives[primIndex];
+            if (prim.position < 0) return nullptr;
+
+            auto blob = std::make_shared<MeshBlob>();
+            const GlbAccessor pos = GetGlbAccessor(asset, prim.position);
+            const size_t count = pos.count;
+
+            GlbAccessor nrm{}, col{}, uv{};
+            if (prim.normal >= 0) nrm = GetGlbAccessor(asset, prim.normal);
+            if (prim.color >= 0) col = GetGlbAccessor(asset, prim.color);
+            if (prim.texCoord >= 0) uv = GetGlbAccessor(asset, prim.texCoord);
+
+            // Same view, same stride and the field offsets of Vertex -> the bytes already are Vertex[]
+            auto at = [&](const GlbAccessor& a, size_t field) {
+                return a.data - pos.data == std::ptrdiff_t(field) - std::ptrdiff_t(offsetof(Vertex, pos));
+                };
+            const bool interleaved = offsetof(Vertex, pos) == 0 && nrm.data && col.data && uv.data &&
+                reinterpret_cast<uintptr_t>(pos.data) % alignof(Vertex) == 0 &&
+                pos.stride == sizeof(Vertex) && nrm.stride == sizeof(Vertex) &&
+                col.stride == sizeof(Vertex) && uv.stride == sizeof(Vertex) &&
+                IsTightFloat(pos, 3) && IsTightFloat(nrm, 3) && IsTightFloat(col, 3) && IsTightFloat(uv, 2) &&
+                at(nrm, offsetof(Vertex, normal)) && at(col, offsetof(Vertex, color)) && at(uv, offsetof(Vertex, texCoord)) &&
+                nrm.count == count && col.count == count && uv.count == count;
+
+            if (interleaved && !optimize) {
+                blob->mappedVertices = ArrayView<Vertex>(reinterpret_cast<const Vertex*>(pos.data), count);
+            }
+            else if (interleaved) {
+                blob->vertices.assign(reinterpret_cast<const Vertex*>(pos.data), reinterpret_cast<const Vertex*>(pos.data) + count);
+            }
+            else {
+                blob->vertices.resize(count);
+                for (size_t i = 0; i < count; ++i) {
+                    Vertex& v = blob->vertices[i];
+                    v.color = glm::vec3(1.f);
+                    ReadGlbFloats(pos, i, &v.pos.x, 3);
+                    if (nrm.data && i < nrm.count) ReadGlbFloats(nrm, i, &v.normal.x, 3);
+                    if (col.data && i < col.count) ReadGlbFloats(col, i, &v.color.x, 3);
+                    if (uv.data && i < uv.count) ReadGlbFloats(uv, i, &v.texCoord.x, 2);
+                }
+            }
+
+            if (prim.indices >= 0) {
+                const GlbAccessor idx = GetGlbAccessor(asset, prim.indices);
+                const bool direct = idx.componentType == kGlbUInt && idx.stride == 4 &&
+                    reinterpret_cast<uintptr_t>(idx.data) % alignof(uint32_t) == 0;
+                if (direct && !optimize) {
+                    blob->mappedIndices = ArrayView<uint32_t>(reinterpret_cast<const uint32_t*>(idx.data), idx.count - idx.count % 3);
+                }
+                else {
+                    blob->indices.resize(idx.count);
+                    for (size_t i = 0; i < idx.count; ++i) {
+                        const uint8_t* p = idx.data + i * idx.stride;
+                        if (idx.componentType == kGlbUByte) blob->indices[i] = *p;
+                        else if (idx.componentType == kGlbUShort) { uint16_t v; std::memcpy(&v, p, 2); blob->indices[i] = v; }
+                        else { uint32_t v; std::memcpy(&v, p, 4); blob->indices[i] = v; }
+                    }
+                }
+                for (uint32_t i : blob->indexData())
+                    if (i >= count) throw std::runtime_error("index out of range");
+            }
+            else {
+                blob->indices.resize(count);
+                for (uint32_t i = 0; i < (uint32_t)count; ++i) blob->indices[i] = i;
+            }
+            blob->indices.resize(blob->indices.size() - blob->indices.size() % 3);
+
+            // No NORMAL: the spec asks for flat normals, so every triangle gets its own 3 vertices
+            if (!nrm.data) {
+                const ArrayView<uint32_t> tris = blob->indexData();
+                std::vector<Vertex> flat;
+                flat.reserve(tris.size());
+                for (size_t t = 0; t < tris.size(); t += 3) {
+                    Vertex a = blob->vertices[tris[t]];
+                    Vertex b = blob->vertices[tris[t + 1]];
+                    Vertex c = blob->vertices[tris[t + 2]];
+                    const glm::vec3 n = glm::cross(b.pos - a.pos, c.pos - a.pos);
+                    const float len = glm::length(n);
+                    a.normal = b.normal = c.normal = len > 0.f ? n / len : glm::vec3(0.f, 1.f, 0.f);
+                    flat.push_back(a); flat.push_back(b); flat.push_back(c);
+                }
+                blob->vertices = std::move(flat);
+                blob->mappedIndices = {};
+                blob->indices.resize(blob->vertices.size());
+                for (uint32_t i = 0; i < (uint32_t)blob->indices.size(); ++i) blob->indices[i] = i;
+            }
+            if (blob->mappedVertices.data() || blob->mappedIndices.data()) blob->mapping = asset.file;
+
+            if (optimize && !blob->indices.empty()) OptimizeMesh(blob->vertices, blob->indices);
+            const ArrayView<Vertex> vertices = blob->vertexData();
+            const ArrayView<uint32_t> indices = blob->indexData();
+            blob->contentHash = Hash::Geometry(vertices.data(), vertices.size(), indices.data(), indices.size());
+            return blob;
+        }
+        catch (const std::exception& e) {
+            std::cerr << "[LoadGLB] \"" << asset.path << "\" mesh " << meshIndex << "/" << primIndex << ": " << e.what() << "\n";
+            return nullptr;
+        }
+    }
+
+} // namespace ObjUtils
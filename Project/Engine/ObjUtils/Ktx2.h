@@ -0,0 +1,318 @@
+// Ktx2.h
+#pragma once
+
+#include <Engine/Core/AssetArchive.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// KTX 2.0 containers (Khronos), the texture format shared by the AssetCooker, files made with
+// external tools (toktx, Compressonator, basisu) and the runtime. Only what the engine samples is
+// supported: 2D, one layer, one face, no zstd/zlib supercompression. Basis Universal payloads
+// (vkFormat UNDEFINED) are parsed too; Texture transcodes them when built with VR_BASISU.
+//   Ktx2Header | level index | DFD | key/value data | levels, smallest first
+namespace ObjUtils {
+
+    // Values are the VkFormat ones (KTX2 stores the VkFormat itself), so no Vulkan include here
+    enum class Ktx2Format : uint32_t {
+        Undefined = 0,      // Basis Universal (ETC1S / UASTC)
+        RGBA8_UNORM = 37,
+        RGBA8_SRGB = 43,
+        BC1_UNORM = 133,    // BC1_RGBA
+        BC1_SRGB = 134,
+        BC3_UNORM = 137,
+        BC3_SRGB = 138,
+        BC4_UNORM = 139,    // one channel: roughness, metalness, height
+        BC5_UNORM = 141,    // two channels: tangent-space normal XY
+        BC7_UNORM = 145,
+        BC7_SRGB = 146,     // albedo
+    };
+
+    enum class Ktx2Supercompression : uint32_t { None = 0, BasisLZ = 1, Zstd = 2, Zlib = 3 };
+
+    inline bool Ktx2KnownFormat(uint32_t format) {
+        switch (static_cast<Ktx2Format>(format)) {
+        case Ktx2Format::Undefined:
+        case Ktx2Format::RGBA8_UNORM: case Ktx2Format::RGBA8_SRGB:
+        case Ktx2Format::BC1_UNORM: case Ktx2Format::BC1_SRGB:
+        case Ktx2Format::BC3_UNORM: case Ktx2Format::BC3_SRGB:
+        case Ktx2Format::BC4_UNORM: case Ktx2Format::BC5_UNORM:
+        case Ktx2Format::BC7_UNORM: case Ktx2Format::BC7_SRGB:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    inline bool Ktx2IsBlockCompressed(Ktx2Format format) {
+        return format != Ktx2Format::Undefined && format != Ktx2Format::RGBA8_UNORM && format != Ktx2Format::RGBA8_SRGB;
+    }
+
+    inline bool Ktx2IsSrgb(Ktx2Format format) {
+        return format == Ktx2Format::RGBA8_SRGB || format == Ktx2Format::BC1_SRGB ||
+            format == Ktx2Format::BC3_SRGB || format == Ktx2Format::BC7_SRGB;
+    }
+
+    // Bytes per 4x4 block (BC) or per texel (RGBA8)
+    inline size_t Ktx2BlockBytes(Ktx2Format format) {
+        switch (format) {
+        case Ktx2Format::BC1_UNORM: case Ktx2Format::BC1_SRGB: case Ktx2Format::BC4_UNORM: return 8;
+        case Ktx2Format::BC3_UNORM: case Ktx2Format::BC3_SRGB: case Ktx2Format::BC5_UNORM:
+        case Ktx2Format::BC7_UNORM: case Ktx2Format::BC7_SRGB: return 16;
+        default: return 4;
+        }
+    }
+
+    // Bytes of one mip level
+    inline size_t Ktx2LevelSize(Ktx2Format format, uint32_t width, uint32_t height) {
+        width = std::max(width, 1u);
+        height = std::max(height, 1u);
+        if (!Ktx2IsBlockCompressed(format)) return size_t(width) * height * Ktx2BlockBytes(format);
+        return size_t((width + 3) / 4) * ((height + 3) / 4) * Ktx2BlockBytes(format);
+    }
+
+    struct Ktx2Level {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+    };
+
+    // Parsed container; level views point into 'file' and stay valid while it (or a copy) lives
+    struct Ktx2Texture {
+        AssetData file;
+        Ktx2Format format = Ktx2Format::Undefined;
+        Ktx2Supercompression supercompression = Ktx2Supercompression::None;
+        uint32_t width = 0, height = 0;
+        bool generateMips = false;                     // levelCount 0: the file asks for runtime mips
+        std::vector<Ktx2Level> levels;                 // [0] = full size
+        std::map<std::string, std::string> keyValues;  // string values, trailing NUL stripped
+    };
+
+    namespace detail {
+        constexpr uint8_t kKtx2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+        struct Ktx2Header {
+            uint8_t  identifier[12];
+            uint32_t vkFormat;
+            uint32_t typeSize;
+            uint32_t pixelWidth;
+            uint32_t pixelHeight;
+            uint32_t pixelDepth;
+            uint32_t layerCount;
+            uint32_t faceCount;
+            uint32_t levelCount;
+            uint32_t supercompressionScheme;
+            uint32_t dfdByteOffset;
+            uint32_t dfdByteLength;
+            uint32_t kvdByteOffset;
+            uint32_t kvdByteLength;
+            uint64_t sgdByteOffset;
+            uint64_t sgdByteLength;
+        };
+        static_assert(sizeof(Ktx2Header) == 80, "Ktx2Header must match the KTX2 file layout");
+
+        struct Ktx2LevelIndex {
+            uint64_t byteOffset;
+            uint64_t byteLength;
+            uint64_t uncompressedByteLength;
+        };
+        static_assert(sizeof(Ktx2LevelIndex) == 24, "Ktx2LevelIndex must match the KTX2 file layout");
+
+        inline size_t AlignUp(size_t v, size_t alignment) { return (v + alignment - 1) / alignment * alignment; }
+
+        inline void PutU32(std::vector<uint8_t>& out, uint32_t v) {
+            const size_t at = out.size();
+            out.resize(at + 4);
+            std::memcpy(&out[at], &v, 4);
+        }
+
+        // Basic data format descriptor (KDFD 1.3). The runtime goes by vkFormat only, but tools
+        // like ktx info and validators expect a DFD that matches it.
+        inline std::vector<uint8_t> Ktx2BasicDfd(Ktx2Format format) {
+            struct Sample { uint32_t bitOffset, bitLength, channel; bool linearAlpha; };
+            const bool srgb = Ktx2IsSrgb(format);
+            const bool bc = Ktx2IsBlockCompressed(format);
+            const uint32_t upper = bc ? 0xFFFFFFFFu : 255u;
+
+            uint32_t colorModel = 1;   // KHR_DF_MODEL_RGBSDA
+            std::vector<Sample> samples;
+            switch (format) {
+            case Ktx2Format::BC1_UNORM: case Ktx2Format::BC1_SRGB:
+                colorModel = 128; samples = { { 0, 64, 1, false } }; break;                     // BC1A, ALPHAPRESENT
+            case Ktx2Format::BC3_UNORM: case Ktx2Format::BC3_SRGB:
+                colorModel = 130; samples = { { 0, 64, 15, srgb }, { 64, 64, 0, false } }; break; // alpha, color
+            case Ktx2Format::BC4_UNORM:
+                colorModel = 131; samples = { { 0, 64, 0, false } }; break;
+            case Ktx2Format::BC5_UNORM:
+                colorModel = 132; samples = { { 0, 64, 0, false }, { 64, 64, 1, false } }; break; // red, green
+            case Ktx2Format::BC7_UNORM: case Ktx2Format::BC7_SRGB:
+                colorModel = 134; samples = { { 0, 128, 0, false } }; break;
+            default:
+                samples = { { 0, 8, 0, false }, { 8, 8, 1, false }, { 16, 8, 2, false }, { 24, 8, 15, srgb } };
+                break;
+            }
+
+            std::vector<uint8_t> dfd;
+            const uint32_t blockSize = 24 + 16 * uint32_t(samples.size());
+            PutU32(dfd, 4 + blockSize);                                        // dfdTotalSize
+            PutU32(dfd, 0);                                                    // vendorId, descriptorType
+            PutU32(dfd, 2u | (blockSize << 16));                               // versionNumber, descriptorBlockSize
+            PutU32(dfd, colorModel | (1u << 8) | ((srgb ? 2u : 1u) << 16));    // BT709 primaries, sRGB/linear
+            PutU32(dfd, bc ? 0x00000303u : 0u);                                // texelBlockDimension - 1
+            PutU32(dfd, uint32_t(Ktx2BlockBytes(format)));                     // bytesPlane0
+            PutU32(dfd, 0);                                                    // bytesPlane4..7
+            for (const Sample& s : samples) {
+                const uint32_t channelType = s.channel | (s.linearAlpha ? 0x10u : 0u);
+                PutU32(dfd, s.bitOffset | ((s.bitLength - 1) << 16) | (channelType << 24));
+                PutU32(dfd, 0);                                                // samplePosition
+                PutU32(dfd, 0);                                                // sampleLower
+                PutU32(dfd, upper);                                            // sampleUpper
+            }
+            return dfd;
+        }
+    }
+
+    inline bool IsKTX2(const uint8_t* data, size_t size) {
+        return data && size >= sizeof(detail::kKtx2Identifier) &&
+            std::memcmp(data, detail::kKtx2Identifier, sizeof(detail::kKtx2Identifier)) == 0;
+    }
+
+    // 'name' is only used for log messages
+    inline bool ParseKTX2(const AssetData& file, Ktx2Texture& out, const std::string& name) {
+        auto fail = [&name](const char* why) {
+            std::cerr << "[KTX2] \"" << name << "\": " << why << "\n";
+            return false;
+        };
+        if (!IsKTX2(file.data, file.size) || file.size < sizeof(detail::Ktx2Header)) return fail("not a KTX2 file");
+
+        detail::Ktx2Header h;
+        std::memcpy(&h, file.data, sizeof(h));
+        if (!Ktx2KnownFormat(h.vkFormat)) return fail("unsupported vkFormat");
+        if (h.pixelWidth == 0 || h.pixelHeight == 0 || h.pixelDepth != 0 || h.layerCount > 1 || h.faceCount != 1)
+            return fail("only single 2D images are supported");
+
+        out.format = static_cast<Ktx2Format>(h.vkFormat);
+        out.supercompression = static_cast<Ktx2Supercompression>(h.supercompressionScheme);
+        const bool basis = out.format == Ktx2Format::Undefined;
+        if (out.supercompression != Ktx2Supercompression::None &&
+            !(basis && (out.supercompression == Ktx2Supercompression::BasisLZ || out.supercompression == Ktx2Supercompression::Zstd)))
+            return fail("unsupported supercompression");
+
+        uint32_t fullChain = 1;
+        for (uint32_t s = std::max(h.pixelWidth, h.pixelHeight); s > 1; s >>= 1) ++fullChain;
+        const uint32_t levelCount = std::max(h.levelCount, 1u);
+        if (levelCount > fullChain) return fail("too many mip levels");
+
+        const size_t indexEnd = sizeof(h) + size_t(levelCount) * sizeof(detail::Ktx2LevelIndex);
+        if (indexEnd > file.size) return fail("truncated level index");
+
+        out.file = file;
+        out.width = h.pixelWidth;
+        out.height = h.pixelHeight;
+        out.generateMips = h.levelCount == 0;
+        out.levels.assign(levelCount, {});
+        for (uint32_t level = 0; level < levelCount; ++level) {
+            detail::Ktx2LevelIndex li;
+            std::memcpy(&li, file.data + sizeof(h) + level * sizeof(li), sizeof(li));
+            if (li.byteOffset > file.size || li.byteLength > file.size - li.byteOffset) return fail("level outside the file");
+            // Basis payloads are sized by the transcoder; everything else has to match exactly
+            if (!basis && li.byteLength != Ktx2LevelSize(out.format, h.pixelWidth >> level, h.pixelHeight >> level))
+                return fail("level size doesn't match its format");
+            out.levels[level] = { file.data + li.byteOffset, static_cast<size_t>(li.byteLength) };
+        }
+
+        out.keyValues.clear();
+        if (h.kvdByteLength) {
+            if (uint64_t(h.kvdByteOffset) + h.kvdByteLength > file.size) return fail("key/value data outside the file");
+            const uint8_t* p = file.data + h.kvdByteOffset;
+            const uint8_t* end = p + h.kvdByteLength;
+            while (end - p >= 4) {
+                uint32_t length;
+                std::memcpy(&length, p, 4);
+                p += 4;
+                if (length > size_t(end - p)) break;
+                const char* kv = reinterpret_cast<const char*>(p);
+                const size_t keyLength = size_t(std::find(kv, kv + length, '\0') - kv);
+                if (keyLength < length) {
+                    std::string value(kv + keyLength + 1, length - keyLength - 1);
+                    if (!value.empty() && value.back() == '\0') value.pop_back();
+                    out.keyValues[std::string(kv, keyLength)] = std::move(value);
+                }
+                p += detail::AlignUp(length, 4);
+            }
+        }
+        return true;
+    }
+
+    // From the archive or the loose file
+    inline bool LoadKTX2(const std::string& path, Ktx2Texture& out) {
+        AssetData file = AssetArchive::Open(path);
+        if (!file) return false;
+        return ParseKTX2(file, out, path);
+    }
+
+    // 'mips' holds 'levelCount' levels back to back, starting at width x height. Key/values are
+    // written as NUL-terminated strings, sorted by key as the spec asks.
+    inline std::vector<uint8_t> EncodeKTX2(Ktx2Format format, uint32_t width, uint32_t height, uint32_t levelCount,
+        const std::vector<uint8_t>& mips, const std::map<std::string, std::string>& keyValues = {})
+    {
+        std::vector<uint8_t> out;
+        if (format == Ktx2Format::Undefined || width == 0 || height == 0 || levelCount == 0) return out;
+
+        std::vector<size_t> srcOffsets(levelCount), sizes(levelCount);
+        size_t total = 0;
+        for (uint32_t level = 0; level < levelCount; ++level) {
+            srcOffsets[level] = total;
+            sizes[level] = Ktx2LevelSize(format, width >> level, height >> level);
+            total += sizes[level];
+        }
+        if (total != mips.size()) return out;
+
+        const std::vector<uint8_t> dfd = detail::Ktx2BasicDfd(format);
+        std::vector<uint8_t> kvd;
+        for (const auto& [key, value] : keyValues) {
+            detail::PutU32(kvd, uint32_t(key.size() + 1 + value.size() + 1));
+            kvd.insert(kvd.end(), key.begin(), key.end());
+            kvd.push_back(0);
+            kvd.insert(kvd.end(), value.begin(), value.end());
+            kvd.push_back(0);
+            kvd.resize(detail::AlignUp(kvd.size(), 4), 0);
+        }
+
+        detail::Ktx2Header h{};
+        std::memcpy(h.identifier, detail::kKtx2Identifier, sizeof(h.identifier));
+        h.vkFormat = static_cast<uint32_t>(format);
+        h.typeSize = 1;
+        h.pixelWidth = width;
+        h.pixelHeight = height;
+        h.faceCount = 1;
+        h.levelCount = levelCount;
+        h.dfdByteOffset = uint32_t(sizeof(h) + levelCount * sizeof(detail::Ktx2LevelIndex));
+        h.dfdByteLength = uint32_t(dfd.size());
+        h.kvdByteOffset = kvd.empty() ? 0 : h.dfdByteOffset + h.dfdByteLength;
+        h.kvdByteLength = uint32_t(kvd.size());
+
+        // Levels smallest first, each aligned to lcm(block size, 4)
+        const size_t alignment = std::max<size_t>(Ktx2BlockBytes(format), 4);
+        std::vector<detail::Ktx2LevelIndex> index(levelCount);
+        size_t offset = size_t(h.dfdByteOffset) + dfd.size() + kvd.size();
+        for (uint32_t level = levelCount; level-- > 0;) {
+            offset = detail::AlignUp(offset, alignment);
+            index[level] = { offset, sizes[level], sizes[level] };
+            offset += sizes[level];
+        }
+
+        out.resize(offset, 0);
+        std::memcpy(out.data(), &h, sizeof(h));
+        std::memcpy(out.data() + sizeof(h), index.data(), index.size() * sizeof(detail::Ktx2LevelIndex));
+        std::memcpy(out.data() + h.dfdByteOffset, dfd.data(), dfd.size());
+        if (!kvd.empty()) std::memcpy(out.data() + h.kvdByteOffset, kvd.data(), kvd.size());
+        for (uint32_t level = 0; level < levelCount; ++level)
+            std::memcpy(out.data() + index[level].byteOffset, mips.data() + srcOffsets[level], sizes[level]);
+        return out;
+    }
+
+} // namespace ObjUtils
@@ -0,0 +1,200 @@
+// MeshCache.h
+#pragma once
+
+#include <glm/glm.hpp>
+#include <Engine/Graphics/Vertex.h>
+#include <Engine/Graphics/MeshBlob.h>
+#include <Engine/Core/MappedFile.h>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <system_error>
+#include <atomic>
+#include <thread>
+#include <functional>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+// Binary mesh cache (".meshbin") for imported models.
+// Layout: MeshCacheHeader | Vertex[vertexCount] | uint32_t[indexCount], little endian. A hit is
+// not parsed or copied: the blob views the mapped file, and Mesh stages its upload from there. An entry is valid while magic/version/vertex stride,
+// the asset ID (path + import flags) and the source file's size and mtime all match.
+namespace ObjUtils {
+
+    // Bump whenever the importer output changes (Vertex layout, optimizer, ...)
+    constexpr uint32_t kMeshCacheVersion = 1;
+    constexpr char kMeshCacheMagic[4] = { 'V', 'R', 'M', 'B' };
+
+    struct MeshCacheHeader {
+        char     magic[4];
+        uint32_t version;
+        uint64_t assetId;        // MakeAssetId(path, flags)
+        uint64_t sourceSize;
+        int64_t  sourceMtime;    // filesystem clock ticks
+        uint64_t contentHash;    // Hash::Geometry of the blobs
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t vertexStride;   // sizeof(Vertex) when written
+        uint32_t reserved;
+        float    boundsMin[3];
+        float    boundsMax[3];
+    };
+    static_assert(sizeof(MeshCacheHeader) == 80, "MeshCacheHeader layout changed; bump kMeshCacheVersion");
+
+    namespace detail {
+        struct MeshCacheConfig {
+            std::mutex mtx;
+            std::string dir;     // empty = disabled
+        };
+        inline MeshCacheConfig& MeshCacheSettings() {
+            static MeshCacheConfig c;
+            return c;
+        }
+
+        inline bool SourceStamp(const char* path, uint64_t& size, int64_t& mtime) {
+            std::error_code ec;
+            const auto fsize = std::filesystem::file_size(path, ec);
+            if (ec) return false;
+            const auto ftime = std::filesystem::last_write_time(path, ec);
+            if (ec) return false;
+            size = static_cast<uint64_t>(fsize);
+            mtime = static_cast<int64_t>(ftime.time_since_epoch().count());
+            return true;
+        }
+
+        inline std::string MeshCachePath(const std::string& dir, uint64_t assetId) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%016llx.meshbin", static_cast<unsigned long long>(assetId));
+            return (std::filesystem::path(dir) / name).string();
+        }
+
+        // Temp file next to 'finalPath' that no other writer uses: process, thread and a counter.
+        // Engine and cooker (or two threads) may write the same entry; the last rename wins.
+        inline std::string MeshCacheTempPath(const std::string& finalPath) {
+            static std::atomic<uint32_t> counter{ 0 };
+#ifdef _WIN32
+            const unsigned long pid = static_cast<unsigned long>(_getpid());
+#else
+            const unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+            char suffix[64];
+            std::snprintf(suffix, sizeof(suffix), ".%lu.%zx.%u.tmp", pid,
+                std::hash<std::thread::id>{}(std::this_thread::get_id()), counter.fetch_add(1));
+            return finalPath + suffix;
+        }
+    }
+
+    // Directory for .meshbin files; empty disables the disk cache
+    inline void SetMeshCacheDir(const std::string& dir) {
+        auto& c = detail::MeshCacheSettings();
+        std::lock_guard<std::mutex> lock(c.mtx);
+        c.dir = dir;
+    }
+
+    inline std::string GetMeshCacheDir() {
+        auto& c = detail::MeshCacheSettings();
+        std::lock_guard<std::mutex> lock(c.mtx);
+        return c.dir;
+    }
+
+    // The cached import of 'sourcePath' if it is still valid (nullptr otherwise). The blob keeps
+    // the file mapped for as long as it lives; contentHash and bounds come from the header.
+    inline std::shared_ptr<MeshBlob> LoadMeshCache(const char* sourcePath, uint64_t assetId)
+    {
+        const std::string dir = GetMeshCacheDir();
+        if (dir.empty() || !sourcePath) return nullptr;
+
+        uint64_t srcSize = 0;
+        int64_t srcMtime = 0;
+        if (!detail::SourceStamp(sourcePath, srcSize, srcMtime)) return nullptr;
+
+        auto file = std::make_shared<MappedFile>();
+        if (!file->open(detail::MeshCachePath(dir, assetId))) return nullptr;
+        if (file->size() < sizeof(MeshCacheHeader)) return nullptr;
+
+        MeshCacheHeader h;
+        std::memcpy(&h, file->data(), sizeof(h));
+        if (std::memcmp(h.magic, kMeshCacheMagic, 4) != 0 ||
+            h.version != kMeshCacheVersion ||
+            h.vertexStride != sizeof(Vertex) ||
+            h.assetId != assetId ||
+            h.sourceSize != srcSize ||
+            h.sourceMtime != srcMtime) {
+            return nullptr;
+        }
+
+        const size_t vBytes = size_t(h.vertexCount) * sizeof(Vertex);
+        const size_t iBytes = size_t(h.indexCount) * sizeof(uint32_t);
+        if (file->size() != sizeof(MeshCacheHeader) + vBytes + iBytes) return nullptr;
+
+        // Header is 80 bytes and Vertex is all floats, so both arrays are suitably aligned in place
+        const uint8_t* p = file->data() + sizeof(MeshCacheHeader);
+        auto blob = std::make_shared<MeshBlob>();
+        blob->mappedVertices = ArrayView<Vertex>(reinterpret_cast<const Vertex*>(p), h.vertexCount);
+        blob->mappedIndices = ArrayView<uint32_t>(reinterpret_cast<const uint32_t*>(p + vBytes), h.indexCount);
+        blob->mapping = std::move(file);
+        blob->contentHash = h.contentHash;
+        blob->hasBounds = true;
+        blob->boundsMin = glm::vec3(h.boundsMin[0], h.boundsMin[1], h.boundsMin[2]);
+        blob->boundsMax = glm::vec3(h.boundsMax[0], h.boundsMax[1], h.boundsMax[2]);
+        return blob;
+    }
+
+    // Writes (or replaces) the cache entry; goes through a temp file so readers never see half a file
+    inline bool WriteMeshCache(const char* sourcePath, uint64_t assetId, uint64_t contentHash,
+        const std::vector<Vertex>& vertices,
+        const std::vector<uint32_t>& indices)
+    {
+        const std::string dir = GetMeshCacheDir();
+        if (dir.empty() || !sourcePath) return false;
+
+        MeshCacheHeader h{};
+        std::memcpy(h.magic, kMeshCacheMagic, 4);
+        h.version = kMeshCacheVersion;
+        h.assetId = assetId;
+        if (!detail::SourceStamp(sourcePath, h.sourceSize, h.sourceMtime)) return false;
+        h.contentHash = contentHash;
+        h.vertexCount = static_cast<uint32_t>(vertices.size());
+        h.indexCount = static_cast<uint32_t>(indices.size());
+        h.vertexStride = sizeof(Vertex);
+
+        glm::vec3 mn(0.f), mx(0.f);
+        if (!vertices.empty()) {
+            mn = mx = vertices[0].pos;
+            for (const Vertex& v : vertices) { mn = glm::min(mn, v.pos); mx = glm::max(mx, v.pos); }
+        }
+        for (int k = 0; k < 3; ++k) { h.boundsMin[k] = mn[k]; h.boundsMax[k] = mx[k]; }
+
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+
+        const std::string finalPath = detail::MeshCachePath(dir, assetId);
+        const std::string tmpPath = detail::MeshCacheTempPath(finalPath);
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out) return false;
+            out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+            out.write(reinterpret_cast<const char*>(vertices.data()), std::streamsize(vertices.size() * sizeof(Vertex)));
+            out.write(reinterpret_cast<const char*>(indices.data()), std::streamsize(indices.size() * sizeof(uint32_t)));
+            if (!out) { out.close(); std::filesystem::remove(tmpPath, ec); return false; }
+        }
+
+        std::filesystem::rename(tmpPath, finalPath, ec);
+        if (ec) {
+            std::cerr << "[MeshCache] failed to write \"" << finalPath << "\": " << ec.message() << "\n";
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+} // namespace ObjUtils
@@ -0,0 +1,337 @@
+// MeshOptimizer.h
+#pragma once
+
+#include <glm/glm.hpp>
+#include <Engine/Graphics/Vertex.h>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+// Import-time index/vertex reordering (runs once per mesh, free at runtime):
+//  1) post-transform vertex cache order (Forsyth, "Linear-Speed Vertex Cache Optimisation")
+//  2) overdraw-aware cluster ordering (Sander et al., "Fast Triangle Reordering")
+//  3) vertex fetch order (vertices renumbered by first use)
+namespace ObjUtils {
+
+    struct MeshOptimizeStats {
+        float acmrBefore = 0.f;   // average cache misses per triangle (0.5 .. 3.0, lower is better)
+        float acmrAfter = 0.f;
+        float atvrBefore = 0.f;   // average transforms per unique vertex (1.0 is ideal)
+        float atvrAfter = 0.f;
+        uint32_t cacheSize = 0;   // FIFO size used for the statistics
+    };
+
+    // ---------------- statistics ----------------
+    // FIFO simulation; 16 entries is a reasonable stand-in for current hardware.
+    inline uint32_t CountCacheMisses(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = 16)
+    {
+        std::vector<uint32_t> stamp(vertexCount, 0);
+        uint32_t timestamp = cacheSize + 1;
+        uint32_t misses = 0;
+        for (uint32_t v : indices) {
+            if (v >= vertexCount) continue;
+            if (timestamp - stamp[v] > cacheSize) {
+                stamp[v] = timestamp++;
+                ++misses;
+            }
+        }
+        return misses;
+    }
+
+    inline float ComputeACMR(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = 16)
+    {
+        const size_t triCount = indices.size() / 3;
+        if (triCount == 0) return 0.f;
+        return float(CountCacheMisses(indices, vertexCount, cacheSize)) / float(triCount);
+    }
+
+    inline float ComputeATVR(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = 16)
+    {
+        std::vector<uint8_t> used(vertexCount, 0);
+        size_t unique = 0;
+        for (uint32_t v : indices) {
+            if (v < vertexCount && !used[v]) { used[v] = 1; ++unique; }
+        }
+        if (unique == 0) return 0.f;
+        return float(CountCacheMisses(indices, vertexCount, cacheSize)) / float(unique);
+    }
+
+    // ---------------- 1) vertex cache (Forsyth) ----------------
+    namespace detail {
+        constexpr int   kForsythCacheSize = 32;
+        constexpr float kCacheDecayPower = 1.5f;
+        constexpr float kLastTriScore = 0.75f;
+        constexpr float kValenceBoostScale = 2.0f;
+        constexpr float kValenceBoostPower = 0.5f;
+
+        inline float ForsythVertexScore(int cachePos, uint32_t remainingTris)
+        {
+            if (remainingTris == 0) return -1.f; // no longer needed
+
+            float score = 0.f;
+            if (cachePos >= 0) {
+                if (cachePos < 3) {
+                    // the three vertices of the last triangle are scored the same on purpose,
+                    // otherwise the next triangle would be biased towards one of its edges
+                    score = kLastTriScore;
+                }
+                else {
+                    const float scaler = 1.f / float(kForsythCacheSize - 3);
+                    score = std::pow(1.f - float(cachePos - 3) * scaler, kCacheDecayPower);
+                }
+            }
+            // bonus for vertices with few triangles left, so we finish them off and avoid lone stragglers
+            score += kValenceBoostScale * std::pow(float(remainingTris), -kValenceBoostPower);
+            return score;
+        }
+    }
+
+    inline void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+    {
+        using namespace detail;
+        const size_t triCount = indices.size() / 3;
+        if (triCount == 0 || vertexCount == 0) return;
+
+        // vertex -> triangle adjacency (CSR)
+        std::vector<uint32_t> triOffset(vertexCount + 1, 0);
+        for (uint32_t v : indices) triOffset[v + 1]++;
+        for (size_t v = 0; v < vertexCount; ++v) triOffset[v + 1] += triOffset[v];
+
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<uint32_t> fill(triOffset.begin(), triOffset.end() - 1);
+            for (size_t t = 0; t < triCount; ++t)
+                for (int k = 0; k < 3; ++k) adjacency[fill[indices[3 * t + k]]++] = uint32_t(t);
+        }
+
+        std::vector<uint32_t> remaining(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) remaining[v] = triOffset[v + 1] - triOffset[v];
+
+        std::vector<int>   cachePos(vertexCount, -1);
+        std::vector<float> vertexScore(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) vertexScore[v] = ForsythVertexScore(-1, remaining[v]);
+
+        std::vector<float> triScore(triCount);
+        for (size_t t = 0; t < triCount; ++t)
+            triScore[t] = vertexScore[indices[3 * t]] + vertexScore[indices[3 * t + 1]] + vertexScore[indices[3 * t + 2]];
+
+        std::vector<uint8_t>  emitted(triCount, 0);
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+
+        // LRU cache; +3 slack while the new triangle is pushed to the front
+        uint32_t cache[kForsythCacheSize + 3];
+        int cacheCount = 0;
+
+        size_t scanCursor = 0;
+        int64_t bestTri = -1;
+
+        for (size_t emittedCount = 0; emittedCount < triCount; ++emittedCount) {
+            if (bestTri < 0) {
+                // cache went cold: restart from the next unemitted triangle in input order
+                while (scanCursor < triCount && emitted[scanCursor]) ++scanCursor;
+                if (scanCursor == triCount) break;
+                bestTri = int64_t(scanCursor);
+            }
+
+            const uint32_t t = uint32_t(bestTri);
+            const uint32_t tv[3] = { indices[3 * t], indices[3 * t + 1], indices[3 * t + 2] };
+            result.insert(result.end(), tv, tv + 3);
+            emitted[t] = 1;
+
+            // remove triangle from its vertices' adjacency
+            for (uint32_t v : tv) {
+                uint32_t* begin = &adjacency[triOffset[v]];
+                uint32_t* end = begin + remaining[v];
+                uint32_t* it = std::find(begin, end, t);
+                if (it != end) { std::swap(*it, *(end - 1)); --remaining[v]; }
+            }
+
+            // push triangle vertices to the front of the LRU cache
+            uint32_t newCache[kForsythCacheSize + 3];
+            int newCount = 0;
+            for (uint32_t v : tv) newCache[newCount++] = v;
+            for (int i = 0; i < cacheCount; ++i) {
+                const uint32_t v = cache[i];
+                if (v != tv[0] && v != tv[1] && v != tv[2]) newCache[newCount++] = v;
+            }
+
+            // vertices falling out of the cache
+            for (int i = kForsythCacheSize; i < newCount; ++i) cachePos[newCache[i]] = -1;
+            cacheCount = std::min(newCount, kForsythCacheSize);
+            std::copy(newCache, newCache + cacheCount, cache);
+
+            // rescore cached vertices and their triangles, pick the best one
+            for (int i = 0; i < cacheCount; ++i) {
+                const uint32_t v = cache[i];
+                cachePos[v] = i;
+                const float newScore = ForsythVertexScore(i, remaining[v]);
+                const float delta = newScore - vertexScore[v];
+                vertexScore[v] = newScore;
+                for (uint32_t a = 0; a < remaining[v]; ++a) triScore[adjacency[triOffset[v] + a]] += delta;
+            }
+            for (int i = kForsythCacheSize; i < newCount; ++i) {
+                const uint32_t v = newCache[i];
+                const float newScore = ForsythVertexScore(-1, remaining[v]);
+                const float delta = newScore - vertexScore[v];
+                vertexScore[v] = newScore;
+                for (uint32_t a = 0; a < remaining[v]; ++a) triScore[adjacency[triOffset[v] + a]] += delta;
+            }
+
+            bestTri = -1;
+            float bestScore = -1.f;
+            for (int i = 0; i < cacheCount; ++i) {
+                const uint32_t v = cache[i];
+                for (uint32_t a = 0; a < remaining[v]; ++a) {
+                    const uint32_t cand = adjacency[triOffset[v] + a];
+                    if (triScore[cand] > bestScore) { bestScore = triScore[cand]; bestTri = int64_t(cand); }
+                }
+            }
+        }
+
+        indices.swap(result);
+    }
+
+    // ---------------- 2) overdraw ----------------
+    // Splits the cache-optimized order into clusters and sorts them front-facing-outwards, so the
+    // outer shell of the mesh tends to be drawn first and early-z rejects more of the inside.
+    // threshold: how much ACMR we may lose (1.05 = 5%) to get smaller, better sortable clusters.
+    inline void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+        float threshold = 1.05f, uint32_t cacheSize = 16)
+    {
+        const size_t triCount = indices.size() / 3;
+        const size_t vertexCount = vertices.size();
+        if (triCount < 2 || vertexCount == 0) return;
+
+        // Hard boundaries: triangles whose three vertices all miss the cache (the cache "restarted")
+        std::vector<uint32_t> clusterStart;
+        {
+            std::vector<uint32_t> stamp(vertexCount, 0);
+            uint32_t timestamp = cacheSize + 1;
+            for (size_t t = 0; t < triCount; ++t) {
+                uint32_t misses = 0;
+                for (int k = 0; k < 3; ++k) {
+                    const uint32_t v = indices[3 * t + k];
+                    if (timestamp - stamp[v] > cacheSize) { stamp[v] = timestamp++; ++misses; }
+                }
+                if (t == 0 || misses == 3) clusterStart.push_back(uint32_t(t));
+            }
+        }
+
+        // Soft boundaries: split hard clusters wherever restarting the cache costs little
+        const float totalAcmr = ComputeACMR(indices, vertexCount, cacheSize);
+        std::vector<uint32_t> clusters;
+        {
+            std::vector<uint32_t> stamp(vertexCount, 0);
+            uint32_t timestamp = 0;
+            for (size_t c = 0; c < clusterStart.size(); ++c) {
+                const uint32_t begin = clusterStart[c];
+                const uint32_t end = (c + 1 < clusterStart.size()) ? clusterStart[c + 1] : uint32_t(triCount);
+
+                clusters.push_back(begin);
+                timestamp += cacheSize + 1; // flush
+                uint32_t misses = 0, tris = 0;
+                for (uint32_t t = begin; t < end; ++t) {
+                    for (int k = 0; k < 3; ++k) {
+                        const uint32_t v = indices[3 * t + k];
+                        if (timestamp - stamp[v] > cacheSize) { stamp[v] = timestamp++; ++misses; }
+                    }
+                    ++tris;
+                    if (t + 1 < end && float(misses) / float(tris) <= totalAcmr * threshold) {
+                        clusters.push_back(t + 1);
+                        timestamp += cacheSize + 1;
+                        misses = 0; tris = 0;
+                    }
+                }
+            }
+        }
+        if (clusters.size() < 2) return;
+
+        // Sort key per cluster: how much the cluster faces away from the mesh centre
+        glm::vec3 meshCentroid(0.f);
+        double meshArea = 0.0;
+        std::vector<glm::vec3> clusterCentroid(clusters.size(), glm::vec3(0.f));
+        std::vector<glm::vec3> clusterNormal(clusters.size(), glm::vec3(0.f));
+        for (size_t c = 0; c < clusters.size(); ++c) {
+            const uint32_t begin = clusters[c];
+            const uint32_t end = (c + 1 < clusters.size()) ? clusters[c + 1] : uint32_t(triCount);
+            float clusterArea = 0.f;
+            for (uint32_t t = begin; t < end; ++t) {
+                const glm::vec3& a = vertices[indices[3 * t + 0]].pos;
+                const glm::vec3& b = vertices[indices[3 * t + 1]].pos;
+                const glm::vec3& cpos = vertices[indices[3 * t + 2]].pos;
+                const glm::vec3 n = glm::cross(b - a, cpos - a); // |n| = 2 * area
+                const float area = glm::length(n);
+                const glm::vec3 centre = (a + b + cpos) / 3.f;
+                clusterCentroid[c] += centre * area;
+                clusterNormal[c] += n;
+                clusterArea += area;
+            }
+            meshCentroid += clusterCentroid[c];
+            meshArea += clusterArea;
+            clusterCentroid[c] = clusterArea > 0.f ? clusterCentroid[c] / clusterArea : clusterCentroid[c];
+            const float nl = glm::length(clusterNormal[c]);
+            clusterNormal[c] = nl > 0.f ? clusterNormal[c] / nl : glm::vec3(0.f);
+        }
+        if (meshArea > 0.0) meshCentroid /= float(meshArea);
+
+        std::vector<float> sortKey(clusters.size());
+        for (size_t c = 0; c < clusters.size(); ++c)
+            sortKey[c] = glm::dot(clusterCentroid[c] - meshCentroid, clusterNormal[c]);
+
+        std::vector<uint32_t> order(clusters.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(),
+            [&](uint32_t a, uint32_t b) { return sortKey[a] > sortKey[b]; });
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (uint32_t c : order) {
+            const uint32_t begin = clusters[c];
+            const uint32_t end = (c + 1 < clusters.size()) ? clusters[c + 1] : uint32_t(triCount);
+            result.insert(result.end(), indices.begin() + 3 * begin, indices.begin() + 3 * end);
+        }
+        indices.swap(result);
+    }
+
+    // ---------------- 3) vertex fetch ----------------
+    // Renumbers vertices in order of first use so fetches walk memory linearly.
+    // Unreferenced vertices are dropped.
+    inline void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+    {
+        std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+        std::vector<Vertex> reordered;
+        reordered.reserve(vertices.size());
+
+        for (uint32_t& idx : indices) {
+            uint32_t& r = remap[idx];
+            if (r == UINT32_MAX) {
+                r = static_cast<uint32_t>(reordered.size());
+                reordered.push_back(vertices[idx]);
+            }
+            idx = r;
+        }
+        vertices.swap(reordered);
+    }
+
+    // ---------------- all passes ----------------
+    inline MeshOptimizeStats OptimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+        float overdrawThreshold = 1.05f)
+    {
+        MeshOptimizeStats stats{};
+        stats.cacheSize = 16;
+        stats.acmrBefore = ComputeACMR(indices, vertices.size(), stats.cacheSize);
+        stats.atvrBefore = ComputeATVR(indices, vertices.size(), stats.cacheSize);
+
+        OptimizeVertexCache(indices, vertices.size());
+        OptimizeOverdraw(indices, vertices, overdrawThreshold, stats.cacheSize);
+        OptimizeVertexFetch(vertices, indices);
+
+        stats.acmrAfter = ComputeACMR(indices, vertices.size(), stats.cacheSize);
+        stats.atvrAfter = ComputeATVR(indices, vertices.size(), stats.cacheSize);
+        return stats;
+    }
+
+} // namespace ObjUtils
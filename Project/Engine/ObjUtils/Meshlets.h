@@ -0,0 +1,148 @@
+// Meshlets.h
+#pragma once
+
+#include <glm/glm.hpp>
+#include <Engine/Graphics/Vertex.h>
+#include <Engine/Core/ArrayView.h>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+// Splits an index buffer into small clusters ("meshlets") with bounds used for GPU culling.
+// Meshlets are contiguous index ranges, so the (already cache-optimized) index buffer is kept as is
+// and a culled draw only has to copy the surviving ranges.
+namespace ObjUtils {
+
+    constexpr uint32_t kMeshletMaxVertices = 64;
+    constexpr uint32_t kMeshletMaxTriangles = 124;
+    // Below this a mesh is cheaper to just draw than to cull per cluster. Large planes such as the
+    // ground are built as grids above it (MeshManager::GetUnitGrid).
+    constexpr uint32_t kMeshletMinTriangles = 4096;
+
+    // Matches the std430 'Meshlet' struct in shaders/meshletCull.comp (48 bytes)
+    struct Meshlet {
+        glm::vec3 center{ 0.f };      // bounding sphere (object space)
+        float     radius = 0.f;
+        glm::vec3 coneAxis{ 0.f };    // average facing of the cluster
+        float     coneCutoff = 1.f;   // sin(cone half angle); 1 = cone test disabled
+        uint32_t  firstIndex = 0;
+        uint32_t  indexCount = 0;
+        uint32_t  vertexCount = 0;
+        uint32_t  pad = 0;
+    };
+    static_assert(sizeof(Meshlet) == 48, "Meshlet must match the GPU layout");
+
+    namespace detail {
+        inline void ComputeMeshletBounds(Meshlet& m, ArrayView<Vertex> vertices, ArrayView<uint32_t> indices)
+        {
+            // Sphere: centre of the AABB, radius to the farthest vertex
+            glm::vec3 mn(std::numeric_limits<float>::max());
+            glm::vec3 mx(-std::numeric_limits<float>::max());
+            for (uint32_t i = m.firstIndex; i < m.firstIndex + m.indexCount; ++i) {
+                const glm::vec3& p = vertices[indices[i]].pos;
+                mn = glm::min(mn, p);
+                mx = glm::max(mx, p);
+            }
+            m.center = (mn + mx) * 0.5f;
+            float r2 = 0.f;
+            for (uint32_t i = m.firstIndex; i < m.firstIndex + m.indexCount; ++i) {
+                const glm::vec3 d = vertices[indices[i]].pos - m.center;
+                r2 = std::max(r2, glm::dot(d, d));
+            }
+            m.radius = std::sqrt(r2);
+
+            // Normal cone from the (area independent) triangle normals
+            std::vector<glm::vec3> normals;
+            normals.reserve(m.indexCount / 3);
+            glm::vec3 sum(0.f);
+            for (uint32_t i = m.firstIndex; i + 2 < m.firstIndex + m.indexCount; i += 3) {
+                const glm::vec3& a = vertices[indices[i + 0]].pos;
+                const glm::vec3& b = vertices[indices[i + 1]].pos;
+                const glm::vec3& c = vertices[indices[i + 2]].pos;
+                const glm::vec3 n = glm::cross(b - a, c - a);
+                const float len = glm::length(n);
+                if (len <= 1e-12f) continue;
+                normals.push_back(n / len);
+                sum += n / len;
+            }
+
+            m.coneAxis = glm::vec3(0.f, 0.f, 0.f);
+            m.coneCutoff = 1.f;
+            const float sumLen = glm::length(sum);
+            if (normals.empty() || sumLen <= 1e-6f) return;
+
+            const glm::vec3 axis = sum / sumLen;
+            float minDot = 1.f;
+            for (const glm::vec3& n : normals) minDot = std::min(minDot, glm::dot(n, axis));
+
+            // Cone wider than ~84 degrees can't be backface culled in a useful way
+            if (minDot <= 0.1f) return;
+
+            m.coneAxis = axis;
+            m.coneCutoff = std::sqrt(1.f - minDot * minDot);
+        }
+    }
+
+    // Greedy split in index order; a meshlet closes when adding the next triangle would exceed
+    // maxVertices unique vertices or maxTriangles triangles.
+    inline std::vector<Meshlet> BuildMeshlets(ArrayView<Vertex> vertices, ArrayView<uint32_t> indices,
+        uint32_t maxVertices = kMeshletMaxVertices, uint32_t maxTriangles = kMeshletMaxTriangles)
+    {
+        std::vector<Meshlet> meshlets;
+        const size_t triCount = indices.size() / 3;
+        if (triCount == 0 || vertices.empty()) return meshlets;
+
+        meshlets.reserve(triCount / maxTriangles + 1);
+
+        // stamp[v] == id -> vertex already counted for the current meshlet
+        std::vector<uint32_t> stamp(vertices.size(), 0);
+        uint32_t id = 1;
+
+        Meshlet cur{};
+        cur.firstIndex = 0;
+
+        auto close = [&](uint32_t endIndex) {
+            cur.indexCount = endIndex - cur.firstIndex;
+            if (cur.indexCount == 0) return;
+            detail::ComputeMeshletBounds(cur, vertices, indices);
+            meshlets.push_back(cur);
+            cur = Meshlet{};
+            cur.firstIndex = endIndex;
+            ++id;
+            };
+
+        for (size_t t = 0; t < triCount; ++t) {
+            const uint32_t tv[3] = { indices[3 * t], indices[3 * t + 1], indices[3 * t + 2] };
+
+            uint32_t newVerts = 0;
+            for (int k = 0; k < 3; ++k) {
+                if (stamp[tv[k]] != id) {
+                    // don't count a vertex twice inside one (degenerate) triangle
+                    bool dup = false;
+                    for (int j = 0; j < k; ++j) dup |= (tv[j] == tv[k]);
+                    if (!dup) ++newVerts;
+                }
+            }
+
+            const uint32_t triInMeshlet = (uint32_t(3 * t) - cur.firstIndex) / 3;
+            if (cur.vertexCount + newVerts > maxVertices || triInMeshlet + 1 > maxTriangles) {
+                close(uint32_t(3 * t));
+                newVerts = 0;
+                for (int k = 0; k < 3; ++k) {
+                    bool dup = false;
+                    for (int j = 0; j < k; ++j) dup |= (tv[j] == tv[k]);
+                    if (!dup) ++newVerts;
+                }
+            }
+
+            for (uint32_t v : tv) stamp[v] = id;
+            cur.vertexCount += newVerts;
+        }
+        close(uint32_t(3 * triCount));
+
+        return meshlets;
+    }
+
+} // namespace ObjUtils
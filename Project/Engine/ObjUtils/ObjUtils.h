@@ -5,12 +5,22 @@
 #include <glm/glm.hpp>
 #include "fast_obj.h"
 #include <Engine/Graphics/Vertex.h>
+#include <Engine/Graphics/MeshBlob.h>
+#include <Engine/ObjUtils/MeshOptimizer.h>
+#include <Engine/Core/Hash.h>
+#include <Engine/Core/AssetArchive.h>
+#include <Engine/ObjUtils/MeshCache.h>
+#include <Engine/ObjUtils/CookedAssets.h>
+#include <Engine/ObjUtils/ParallelObjParser.h>
+#include <Engine/Core/ThreadPool.h>
 #include <cstdint>
+#include <cstring>
 #include <vector>
 #include <unordered_map>
 #include <iostream>
 #include <algorithm>
 #include <iomanip>
+#include <sstream>
 #include <string>
 #include <mutex>
 
@@ -31,266 +41,446 @@ namespace ObjUtils {
 
     struct DebugTrip { uint32_t p, t, n; };
 
-    // --------------- OBJ loader ----------------
-    // flipV: set true if you need v = 1 - v.
-    // flipWinding: swap i1<->i2 per triangle.
-    // debug: runtime logging on/off.
-    // dropDegenerate: drop zero-area triangles if true.
-    inline bool ParseOBJ(const char* path,
-        std::vector<Vertex>& outVertices,
-        std::vector<uint32_t>& outIndices,
+    // Import options that change the resulting geometry (debug omitted on purpose)
+    inline uint64_t ImportFlags(bool flipV, bool flipWinding, bool dropDegenerate, bool optimize) {
+        return (flipV ? 1ull : 0ull) |
+            (flipWinding ? 2ull : 0ull) |
+            (dropDegenerate ? 4ull : 0ull) |
+            (optimize ? 8ull : 0ull);
+    }
+
+    // Asset ID of an OBJ import: normalized path + ImportFlags.
+    // Used as ParseOBJ cache key and MeshManager asset key.
+    inline uint64_t MakeAssetId(const char* path,
         bool flipV = false,
         bool flipWinding = false,
-        bool debug = false,
-        bool dropDegenerate = true)
+        bool dropDegenerate = true,
+        bool optimize = true)
     {
-        // ---- cache key from normalized path + flags ----
-        auto makeKey = [&](const char* p) -> uint64_t {
-            static constexpr uint64_t FNV_OFFSET = 1469598103934665603ull;
-            static constexpr uint64_t FNV_PRIME = 1099511628211ull;
-
-            // normalize to lower case so paths differing only by case share
-            std::string s = p ? std::string(p) : std::string();
-            std::transform(s.begin(), s.end(), s.begin(),
-                [](unsigned char c) { return (unsigned char)std::tolower(c); });
-
-            uint64_t h = FNV_OFFSET;
-            for (unsigned char c : s) { h ^= (uint64_t)c; h *= FNV_PRIME; }
-
-            // fold flags (debug omitted on purpose: it doesn't change geometry)
-            uint64_t flags = (flipV ? 1ull : 0ull) |
-                (flipWinding ? 2ull : 0ull) |
-                (dropDegenerate ? 4ull : 0ull);
-            // mix flags into hash
-            h ^= flags + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
-            return h;
-            };
-
-        struct CacheEntry {
-            std::vector<Vertex>   verts;
-            std::vector<uint32_t> inds;
-        };
+        return Hash::Combine(Hash::Path(path ? path : ""), ImportFlags(flipV, flipWinding, dropDegenerate, optimize));
+    }
 
+    // --------------- Parse cache ----------------
+    // Keeps every parsed OBJ as a shared MeshBlob so re-imports skip the parse. Off by default:
+    // the MeshManager asset registry already shares live meshes, so this only pays off when the
+    // same file is loaded again after all its meshes were released.
+    namespace detail {
+        struct ParseCacheState {
+            std::mutex mtx;
+            std::unordered_map<uint64_t, MeshBlobPtr> entries;
+            bool enabled = false;
+        };
         // one cache & mutex per process (function-local statics are OK in headers)
-        static std::mutex s_cacheMtx;
-        static std::unordered_map<uint64_t, CacheEntry> s_cache;
+        inline ParseCacheState& ParseCache() {
+            static ParseCacheState s;
+            return s;
+        }
+    }
 
-        const uint64_t key = makeKey(path);
+    inline void SetParseCacheEnabled(bool enabled) {
+        auto& c = detail::ParseCache();
+        std::lock_guard<std::mutex> lock(c.mtx);
+        c.enabled = enabled;
+        if (!enabled) std::unordered_map<uint64_t, MeshBlobPtr>().swap(c.entries);
+    }
 
-        // ---- cache hit? ----
-        {
-            std::lock_guard<std::mutex> lock(s_cacheMtx);
-            auto it = s_cache.find(key);
-            if (it != s_cache.end()) {
-                outVertices = it->second.verts;
-                outIndices = it->second.inds;
-                if (debug) {
-                    std::cout << "\n--- ParseOBJ: \"" << (path ? path : "")
-                        << "\" [cache hit] ---\n"
-                        << "Vertices: " << outVertices.size()
-                        << "  Indices: " << outIndices.size() << "\n";
-                }
-                return true;
-            }
+    inline void ClearParseCache() {
+        auto& c = detail::ParseCache();
+        std::lock_guard<std::mutex> lock(c.mtx);
+        std::unordered_map<uint64_t, MeshBlobPtr>().swap(c.entries);
+    }
+
+    inline size_t ParseCacheBytes() {
+        auto& c = detail::ParseCache();
+        std::lock_guard<std::mutex> lock(c.mtx);
+        size_t bytes = 0;
+        for (const auto& [key, blob] : c.entries)
+            bytes += blob->bytes();
+        return bytes;
+    }
+
+    namespace detail {
+        // fast_obj file access through AssetArchive::Open, so .obj and .mtl files resolve from the
+        // mounted archive first and from disk otherwise
+        struct FastObjStream {
+            AssetData file;
+            size_t pos = 0;
+        };
+
+        inline void* FastObjOpen(const char* path, void*) {
+            AssetData file = AssetArchive::Open(path ? path : "");
+            return file ? new FastObjStream{ std::move(file) } : nullptr;
+        }
+
+        inline void FastObjClose(void* stream, void*) {
+            delete static_cast<FastObjStream*>(stream);
         }
 
-        // ---- cache miss → load and build geometry ----
-        fastObjMesh* m = fast_obj_read(path);
-        if (!m) return false;
+        inline size_t FastObjRead(void* stream, void* dst, size_t bytes, void*) {
+            auto* s = static_cast<FastObjStream*>(stream);
+            const size_t n = std::min(bytes, s->file.size - s->pos);
+            std::memcpy(dst, s->file.data + s->pos, n);
+            s->pos += n;
+            return n;
+        }
 
-        if (debug) {
-            std::cout.setf(std::ios::fixed);
-            std::cout << std::setprecision(2)
-                << "\n--- ParseOBJ: \"" << (path ? path : "") << "\" ---\n";
+        inline unsigned long FastObjSize(void* stream, void*) {
+            return static_cast<unsigned long>(static_cast<FastObjStream*>(stream)->file.size);
         }
 
-        // Pre-pass stats
+        // Serial import through fast_obj (see ParseOBJ for the flags)
+        inline bool ParseOBJFastObj(const char* path,
+            std::vector<Vertex>& outVertices,
+            std::vector<uint32_t>& outIndices,
+            bool flipV,
+            bool flipWinding,
+            bool debug,
+            bool dropDegenerate)
         {
-            size_t triTotal = 0, idxTotal = 0, nTri = 0, nQuad = 0, nNgon = 0;
-            for (unsigned f = 0; f < m->face_count; ++f) {
-                unsigned fv = m->face_vertices[f];
-                if (fv >= 3) {
-                    triTotal += (fv - 2);
-                    idxTotal += 3 * (fv - 2);
-                    if (fv == 3) ++nTri; else if (fv == 4) ++nQuad; else if (fv > 4) ++nNgon;
-                }
-            }
+            const fastObjCallbacks callbacks{ FastObjOpen, FastObjClose, FastObjRead, FastObjSize };
+            fastObjMesh* m = fast_obj_read_with_callbacks(path, &callbacks, nullptr);
+            if (!m) return false;
+
             if (debug) {
-                std::cout << "faces=" << m->face_count
-                    << "  tris=" << triTotal
-                    << "  indices=" << idxTotal
-                    << "  (tri=" << nTri
-                    << ", quad=" << nQuad
-                    << ", ngon=" << nNgon << ")\n";
+                std::cout.setf(std::ios::fixed);
+                std::cout << std::setprecision(2)
+                    << "\n--- ParseOBJ: \"" << (path ? path : "") << "\" ---\n";
             }
-        }
 
-        outVertices.clear();
-        outIndices.clear();
-        outVertices.reserve(m->index_count); // upper bound
+            // Pre-pass stats
+            {
+                size_t triTotal = 0, idxTotal = 0, nTri = 0, nQuad = 0, nNgon = 0;
+                for (unsigned f = 0; f < m->face_count; ++f) {
+                    unsigned fv = m->face_vertices[f];
+                    if (fv >= 3) {
+                        triTotal += (fv - 2);
+                        idxTotal += 3 * (fv - 2);
+                        if (fv == 3) ++nTri; else if (fv == 4) ++nQuad; else if (fv > 4) ++nNgon;
+                    }
+                }
+                if (debug) {
+                    std::cout << "faces=" << m->face_count
+                        << "  tris=" << triTotal
+                        << "  indices=" << idxTotal
+                        << "  (tri=" << nTri
+                        << ", quad=" << nQuad
+                        << ", ngon=" << nNgon << ")\n";
+                }
+            }
 
-        std::unordered_map<Triplet, uint32_t, TripletHash> cache;
-        cache.reserve(m->index_count);
+            outVertices.clear();
+            outIndices.clear();
+            outVertices.reserve(m->index_count); // upper bound
 
-        std::vector<DebugTrip> dbgTrip;
-        if (debug) dbgTrip.reserve(m->index_count);
+            std::unordered_map<Triplet, uint32_t, TripletHash> cache;
+            cache.reserve(m->index_count);
 
-        // Emit vertex or reuse from cache
-        auto emitVertex = [&](const fastObjIndex& ix) -> uint32_t {
-            Triplet key{ ix.p, ix.t, ix.n };
-            auto it = cache.find(key);
-            if (it != cache.end()) return it->second;
+            std::vector<DebugTrip> dbgTrip;
+            if (debug) dbgTrip.reserve(m->index_count);
 
-            Vertex v{};
-            v.color = glm::vec3(1);
+            // Emit vertex or reuse from cache
+            auto emitVertex = [&](const fastObjIndex& ix) -> uint32_t {
+                Triplet key{ ix.p, ix.t, ix.n };
+                auto it = cache.find(key);
+                if (it != cache.end()) return it->second;
 
-            // Position
-            if (ix.p) {
-                const float* P = &m->positions[3 * ix.p];
-                v.pos = glm::vec3(P[0], P[1], P[2]);
-            }
-            else {
-                v.pos = glm::vec3(0);
-            }
+                Vertex v{};
+                v.color = glm::vec3(1);
 
-            // UV
-            if (ix.t) {
-                const float* T = &m->texcoords[2 * ix.t];
-                v.texCoord = glm::vec2(T[0], flipV ? (1.0f - T[1]) : T[1]);
-            }
-            else {
-                v.texCoord = glm::vec2(0);
-            }
+                // Position
+                if (ix.p) {
+                    const float* P = &m->positions[3 * ix.p];
+                    v.pos = glm::vec3(P[0], P[1], P[2]);
+                }
+                else {
+                    v.pos = glm::vec3(0);
+                }
 
-            // Normal
-            if (ix.n) {
-                const float* N = &m->normals[3 * ix.n];
-                v.normal = glm::vec3(N[0], N[1], N[2]);
-            }
-            else {
-                v.normal = glm::vec3(0, 1, 0);
+                // UV
+                if (ix.t) {
+                    const float* T = &m->texcoords[2 * ix.t];
+                    v.texCoord = glm::vec2(T[0], flipV ? (1.0f - T[1]) : T[1]);
+                }
+                else {
+                    v.texCoord = glm::vec2(0);
+                }
+
+                // Normal
+                if (ix.n) {
+                    const float* N = &m->normals[3 * ix.n];
+                    v.normal = glm::vec3(N[0], N[1], N[2]);
+                }
+                else {
+                    v.normal = glm::vec3(0, 1, 0);
+                }
+
+                uint32_t newIndex = static_cast<uint32_t>(outVertices.size());
+                outVertices.push_back(v);
+                cache.emplace(key, newIndex);
+
+                if (debug) {
+                    dbgTrip.push_back({ ix.p, ix.t, ix.n });
+                    std::cout << "  [emit] i=" << newIndex
+                        << "  p/t/n=" << ix.p << "/" << ix.t << "/" << ix.n
+                        << "  pos=(" << v.pos.x << "," << v.pos.y << "," << v.pos.z << ")"
+                        << "  uv=(" << v.texCoord.x << "," << v.texCoord.y << ")"
+                        << "  n=(" << v.normal.x << "," << v.normal.y << "," << v.normal.z << ")\n";
+                }
+                return newIndex;
+                };
+
+            // Push triangle with degeneracy check
+            auto pushTri = [&](uint32_t ia, uint32_t ib, uint32_t ic) {
+                if (ia == ib || ib == ic || ia == ic) {
+                    if (debug) std::cerr << "[degenerate] duplicate indices: "
+                        << ia << "," << ib << "," << ic << "\n";
+                    if (dropDegenerate) return;
+                }
+
+                glm::vec3 A = outVertices[ia].pos;
+                glm::vec3 B = outVertices[ib].pos;
+                glm::vec3 C = outVertices[ic].pos;
+                float area2 = glm::length(glm::cross(B - A, C - A));
+
+                if (area2 < 1e-8f) {
+                    if (debug) std::cerr << "[degenerate] zero-area tri: "
+                        << ia << "," << ib << "," << ic
+                        << "  A=(" << A.x << "," << A.y << "," << A.z << ")"
+                        << "  B=(" << B.x << "," << B.y << "," << B.z << ")"
+                        << "  C=(" << C.x << "," << C.y << "," << C.z << ")\n";
+                    if (dropDegenerate) return;
+                }
+
+                outIndices.push_back(ia);
+                outIndices.push_back(ib);
+                outIndices.push_back(ic);
+                };
+
+            // Faces
+            size_t idxCursor = 0;
+            std::vector<uint32_t> cornerIdx;   // reused across faces
+            for (unsigned f = 0; f < m->face_count; ++f) {
+                unsigned fv = m->face_vertices[f];
+                if (debug) {
+                    std::cout << "Face " << f << " (fv=" << fv << "): ";
+                    for (unsigned k = 0; k < fv; ++k) {
+                        const fastObjIndex ix = m->indices[idxCursor + k];
+                        std::cout << "(" << ix.p << "/" << ix.t << "/" << ix.n << ") ";
+                    }
+                    std::cout << "\n";
+                }
+
+                cornerIdx.clear();
+                for (unsigned k = 0; k < fv; ++k) {
+                    const fastObjIndex ix = m->indices[idxCursor + k];
+                    cornerIdx.push_back(emitVertex(ix));
+                }
+
+                // Fan triangulation
+                for (unsigned i = 1; i + 1 < fv; ++i) {
+                    uint32_t i0 = cornerIdx[0];
+                    uint32_t i1 = cornerIdx[i];
+                    uint32_t i2 = cornerIdx[i + 1];
+                    if (flipWinding) std::swap(i1, i2);
+                    pushTri(i0, i1, i2);
+                }
+
+                idxCursor += fv;
             }
 
-            uint32_t newIndex = static_cast<uint32_t>(outVertices.size());
-            outVertices.push_back(v);
-            cache.emplace(key, newIndex);
+            fast_obj_destroy(m);
 
             if (debug) {
-                dbgTrip.push_back({ ix.p, ix.t, ix.n });
-                std::cout << "  [emit] i=" << newIndex
-                    << "  p/t/n=" << ix.p << "/" << ix.t << "/" << ix.n
-                    << "  pos=(" << v.pos.x << "," << v.pos.y << "," << v.pos.z << ")"
-                    << "  uv=(" << v.texCoord.x << "," << v.texCoord.y << ")"
-                    << "  n=(" << v.normal.x << "," << v.normal.y << "," << v.normal.z << ")\n";
-            }
-            return newIndex;
-            };
-
-        // Push triangle with degeneracy check
-        auto pushTri = [&](uint32_t ia, uint32_t ib, uint32_t ic) {
-            if (ia == ib || ib == ic || ia == ic) {
-                if (debug) std::cerr << "[degenerate] duplicate indices: "
-                    << ia << "," << ib << "," << ic << "\n";
-                if (dropDegenerate) return;
-            }
+                std::cout << "Vertices: " << outVertices.size()
+                    << "  Indices: " << outIndices.size() << "\n";
+
+                if (!outVertices.empty()) {
+                    std::cout << "Last vertices:\n";
+                    size_t start = outVertices.size() > 8 ? outVertices.size() - 8 : 0;
+                    for (size_t i = start; i < outVertices.size(); ++i) {
+                        const auto& v = outVertices[i];
+                        const auto& t = dbgTrip[i];
+                        std::cout << "  VTX " << i
+                            << "  p/t/n=" << t.p << "/" << t.t << "/" << t.n
+                            << "  pos=(" << v.pos.x << "," << v.pos.y << "," << v.pos.z << ")"
+                            << "  uv=(" << v.texCoord.x << "," << v.texCoord.y << ")"
+                            << "  n=(" << v.normal.x << "," << v.normal.y << "," << v.normal.z << ")\n";
+                    }
+                }
 
-            glm::vec3 A = outVertices[ia].pos;
-            glm::vec3 B = outVertices[ib].pos;
-            glm::vec3 C = outVertices[ic].pos;
-            float area2 = glm::length(glm::cross(B - A, C - A));
-
-            if (area2 < 1e-8f) {
-                if (debug) std::cerr << "[degenerate] zero-area tri: "
-                    << ia << "," << ib << "," << ic
-                    << "  A=(" << A.x << "," << A.y << "," << A.z << ")"
-                    << "  B=(" << B.x << "," << B.y << "," << B.z << ")"
-                    << "  C=(" << C.x << "," << C.y << "," << C.z << ")\n";
-                if (dropDegenerate) return;
+                if (!outIndices.empty()) {
+                    std::cout << "Last triangles (by indices):\n";
+                    uint32_t triCount = static_cast<uint32_t>(outIndices.size() / 3);
+                    uint32_t show = std::min<uint32_t>(6, triCount);
+                    for (uint32_t t = triCount - show; t < triCount; ++t) {
+                        uint32_t ia = outIndices[3 * t + 0];
+                        uint32_t ib = outIndices[3 * t + 1];
+                        uint32_t ic = outIndices[3 * t + 2];
+                        glm::vec3 A = outVertices[ia].pos;
+                        glm::vec3 B = outVertices[ib].pos;
+                        glm::vec3 C = outVertices[ic].pos;
+                        std::cout << "  tri " << t << ": "
+                            << ia << "," << ib << "," << ic
+                            << "  A=(" << A.x << "," << A.y << "," << A.z << ")"
+                            << "  B=(" << B.x << "," << B.y << "," << B.z << ")"
+                            << "  C=(" << C.x << "," << C.y << "," << C.z << ")\n";
+                    }
+                }
             }
 
-            outIndices.push_back(ia);
-            outIndices.push_back(ib);
-            outIndices.push_back(ic);
-            };
+            return true;
+        }
+    }
 
-        // Faces
-        size_t idxCursor = 0;
-        for (unsigned f = 0; f < m->face_count; ++f) {
-            unsigned fv = m->face_vertices[f];
-            if (debug) {
-                std::cout << "Face " << f << " (fv=" << fv << "): ";
-                for (unsigned k = 0; k < fv; ++k) {
-                    const fastObjIndex ix = m->indices[idxCursor + k];
-                    std::cout << "(" << ix.p << "/" << ix.t << "/" << ix.n << ") ";
+    // --------------- OBJ loader ----------------
+    namespace detail {
+        // Disk cache or full parse; returns a fresh blob the caller owns exclusively
+        inline std::shared_ptr<MeshBlob> ImportOBJ(const char* path, uint64_t key,
+            bool flipV, bool flipWinding, bool debug, bool dropDegenerate, bool optimize)
+        {
+            // ---- package from the offline cooker (see CookedAssets.h)? ----
+            if (auto cooked = LoadCookedMesh(path, ImportFlags(flipV, flipWinding, dropDegenerate, optimize))) {
+                if (debug) {
+                    std::cout << "\n--- ParseOBJ: \"" << (path ? path : "")
+                        << "\" [cooked] ---\n"
+                        << "Vertices: " << cooked->vertices.size()
+                        << "  Indices: " << cooked->indices.size() << "\n";
                 }
-                std::cout << "\n";
+                return cooked;
             }
 
-            std::vector<uint32_t> cornerIdx;
-            cornerIdx.reserve(fv);
-            for (unsigned k = 0; k < fv; ++k) {
-                const fastObjIndex ix = m->indices[idxCursor + k];
-                cornerIdx.push_back(emitVertex(ix));
+            // ---- binary cache on disk (see MeshCache.h)? Read in place, not copied ----
+            if (auto cached = LoadMeshCache(path, key)) {
+                if (debug) {
+                    std::cout << "\n--- ParseOBJ: \"" << (path ? path : "")
+                        << "\" [meshbin] ---\n"
+                        << "Vertices: " << cached->vertexData().size()
+                        << "  Indices: " << cached->indexData().size() << "\n";
+                }
+                return cached;
             }
 
-            // Fan triangulation
-            for (unsigned i = 1; i + 1 < fv; ++i) {
-                uint32_t i0 = cornerIdx[0];
-                uint32_t i1 = cornerIdx[i];
-                uint32_t i2 = cornerIdx[i + 1];
-                if (flipWinding) std::swap(i1, i2);
-                pushTri(i0, i1, i2);
+            auto blob = std::make_shared<MeshBlob>();
+            std::vector<Vertex>& outVertices = blob->vertices;
+            std::vector<uint32_t>& outIndices = blob->indices;
+
+            // ---- cache miss → load and build geometry ----
+            // Large files go through the multi-threaded importer (identical output); debug logging
+            // needs the serial emit order, so it always uses fast_obj. On a pool worker (AssetLoader,
+            // the cooker) the other workers already fill the cores, so it stays on this thread.
+            const unsigned parseThreads = ThreadPool::OnWorkerThread() ? 1u : 0u;
+            const bool parsed = !debug && ParseOBJParallel(path, outVertices, outIndices, flipV, flipWinding, dropDegenerate, parseThreads);
+            if (!parsed && !ParseOBJFastObj(path, outVertices, outIndices, flipV, flipWinding, debug, dropDegenerate))
+                return nullptr;
+
+            if (optimize && !outIndices.empty()) {
+                const MeshOptimizeStats st = OptimizeMesh(outVertices, outIndices);
+                // Once per import (cache hits skip this). Runs on loader workers: format locally,
+                // one write, no shared stream state.
+                std::ostringstream line;
+                line << std::fixed << std::setprecision(3)
+                    << "[ParseOBJ] \"" << (path ? path : "") << "\" optimized: ACMR "
+                    << st.acmrBefore << " -> " << st.acmrAfter
+                    << ", ATVR " << st.atvrBefore << " -> " << st.atvrAfter
+                    << " (FIFO " << st.cacheSize << ", " << outIndices.size() / 3 << " tris)\n";
+                std::cout << line.str();
             }
 
-            idxCursor += fv;
+            blob->contentHash = Hash::Geometry(outVertices, outIndices);
+            WriteMeshCache(path, key, blob->contentHash, outVertices, outIndices);
+            return blob;
         }
 
-        fast_obj_destroy(m);
+        inline MeshBlobPtr FindParseCache(uint64_t key) {
+            auto& parseCache = ParseCache();
+            std::lock_guard<std::mutex> lock(parseCache.mtx);
+            auto it = parseCache.entries.find(key);
+            return it != parseCache.entries.end() ? it->second : nullptr;
+        }
 
-        if (debug) {
-            std::cout << "Vertices: " << outVertices.size()
-                << "  Indices: " << outIndices.size() << "\n";
+        // Returns true if the cache kept a reference to 'blob'
+        inline bool StoreParseCache(uint64_t key, const MeshBlobPtr& blob) {
+            auto& parseCache = ParseCache();
+            std::lock_guard<std::mutex> lock(parseCache.mtx);
+            if (!parseCache.enabled) return false;
+            parseCache.entries.emplace(key, blob);
+            return true;
+        }
+    }
 
-            if (!outVertices.empty()) {
-                std::cout << "Last vertices:\n";
-                size_t start = outVertices.size() > 8 ? outVertices.size() - 8 : 0;
-                for (size_t i = start; i < outVertices.size(); ++i) {
-                    const auto& v = outVertices[i];
-                    const auto& t = dbgTrip[i];
-                    std::cout << "  VTX " << i
-                        << "  p/t/n=" << t.p << "/" << t.t << "/" << t.n
-                        << "  pos=(" << v.pos.x << "," << v.pos.y << "," << v.pos.z << ")"
-                        << "  uv=(" << v.texCoord.x << "," << v.texCoord.y << ")"
-                        << "  n=(" << v.normal.x << "," << v.normal.y << "," << v.normal.z << ")\n";
-                }
-            }
+    // Shared import: returns the geometry as an immutable blob (nullptr on failure).
+    // Cache hits hand out the cached blob itself, so spawning the same file again costs a
+    // refcount bump instead of a copy. Flags are the same as ParseOBJ below.
+    inline MeshBlobPtr ParseOBJShared(const char* path,
+        bool flipV = false,
+        bool flipWinding = false,
+        bool debug = false,
+        bool dropDegenerate = true,
+        bool optimize = true)
+    {
+        const uint64_t key = MakeAssetId(path, flipV, flipWinding, dropDegenerate, optimize);
 
-            if (!outIndices.empty()) {
-                std::cout << "Last triangles (by indices):\n";
-                uint32_t triCount = static_cast<uint32_t>(outIndices.size() / 3);
-                uint32_t show = std::min<uint32_t>(6, triCount);
-                for (uint32_t t = triCount - show; t < triCount; ++t) {
-                    uint32_t ia = outIndices[3 * t + 0];
-                    uint32_t ib = outIndices[3 * t + 1];
-                    uint32_t ic = outIndices[3 * t + 2];
-                    glm::vec3 A = outVertices[ia].pos;
-                    glm::vec3 B = outVertices[ib].pos;
-                    glm::vec3 C = outVertices[ic].pos;
-                    std::cout << "  tri " << t << ": "
-                        << ia << "," << ib << "," << ic
-                        << "  A=(" << A.x << "," << A.y << "," << A.z << ")"
-                        << "  B=(" << B.x << "," << B.y << "," << B.z << ")"
-                        << "  C=(" << C.x << "," << C.y << "," << C.z << ")\n";
-                }
+        if (MeshBlobPtr hit = detail::FindParseCache(key)) {
+            if (debug) {
+                std::cout << "\n--- ParseOBJ: \"" << (path ? path : "")
+                    << "\" [cache hit] ---\n"
+                    << "Vertices: " << hit->vertexData().size()
+                    << "  Indices: " << hit->indexData().size() << "\n";
             }
+            return hit;
         }
 
-        // ---- store in cache ----
-        {
-            std::lock_guard<std::mutex> lock(s_cacheMtx);
-            s_cache.emplace(key, CacheEntry{ outVertices, outIndices });
+        MeshBlobPtr blob = detail::ImportOBJ(path, key, flipV, flipWinding, debug, dropDegenerate, optimize);
+        if (blob) detail::StoreParseCache(key, blob);
+        return blob;
+    }
+
+    // flipV: set true if you need v = 1 - v.
+    // flipWinding: swap i1<->i2 per triangle.
+    // debug: runtime logging on/off.
+    // dropDegenerate: drop zero-area triangles if true.
+    // optimize: reorder for vertex cache / overdraw / vertex fetch (see MeshOptimizer.h).
+    // outContentHash: optional, receives Hash::Geometry of the result (computed once per import).
+    // Results are also written to / read from the binary mesh cache when enabled (MeshCache.h).
+    // Copies into the out-params on a parse cache hit; prefer ParseOBJShared.
+    inline bool ParseOBJ(const char* path,
+        std::vector<Vertex>& outVertices,
+        std::vector<uint32_t>& outIndices,
+        bool flipV = false,
+        bool flipWinding = false,
+        bool debug = false,
+        bool dropDegenerate = true,
+        bool optimize = true,
+        uint64_t* outContentHash = nullptr)
+    {
+        const uint64_t key = MakeAssetId(path, flipV, flipWinding, dropDegenerate, optimize);
+
+        MeshBlobPtr hit = detail::FindParseCache(key);
+        if (hit) {
+            const ArrayView<Vertex> vertices = hit->vertexData();
+            const ArrayView<uint32_t> indices = hit->indexData();
+            outVertices.assign(vertices.begin(), vertices.end());
+            outIndices.assign(indices.begin(), indices.end());
+            if (outContentHash) *outContentHash = hit->contentHash;
+            return true;
         }
 
+        std::shared_ptr<MeshBlob> blob = detail::ImportOBJ(path, key, flipV, flipWinding, debug, dropDegenerate, optimize);
+        if (!blob) return false;
+        if (outContentHash) *outContentHash = blob->contentHash;
+
+        // Not cached → the blob is ours alone and its buffers can be moved out (unless it is a
+        // mapped cache entry, which has no buffers to move)
+        if (detail::StoreParseCache(key, blob) || blob->mapping) {
+            const ArrayView<Vertex> vertices = blob->vertexData();
+            const ArrayView<uint32_t> indices = blob->indexData();
+            outVertices.assign(vertices.begin(), vertices.end());
+            outIndices.assign(indices.begin(), indices.end());
+        }
+        else {
+            outVertices = std::move(blob->vertices);
+            outIndices = std::move(blob->indices);
+        }
         return true;
     }
 
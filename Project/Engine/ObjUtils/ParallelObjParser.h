@@ -0,0 +1,426 @@
+// ParallelObjParser.h
+#pragma once
+
+#include <glm/glm.hpp>
+#include <Engine/Graphics/Vertex.h>
+#include <Engine/Core/AssetArchive.h>
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <algorithm>
+
+// Multi-threaded OBJ import for large files, used by ParseOBJ in place of fast_obj.
+// Produces exactly what the fast_obj path produces (same float parsing, same first-occurrence
+// vertex order, same fan triangulation and degenerate filtering):
+//   1) text is split at line boundaries, each chunk counts its v/vt/vn/f records
+//   2) prefix sums give every chunk its output offsets (and the base for relative indices),
+//      then all chunks parse in parallel straight into the shared arrays
+//   3) corners are de-duplicated in hash shards, each shard owning its own map; a linear pass
+//      then hands out vertex ids in corner order, so ids match the serial emit order
+//   4) vertices and triangles are built per chunk and concatenated
+// Anything the fast path doesn't handle (line/point elements, malformed faces, out of range
+// indices) makes it return false and ParseOBJ falls back to fast_obj.
+namespace ObjUtils {
+
+    // Files smaller than this are parsed faster by fast_obj than threads can be spun up
+    constexpr size_t kParallelObjMinBytes = 8u << 20;
+
+    namespace objpar {
+
+        // ---- text primitives, kept identical to fast_obj 1.3 ----
+        constexpr int kMaxPower = 20;
+        constexpr double kPower10Pos[kMaxPower] = {
+            1.0e0,  1.0e1,  1.0e2,  1.0e3,  1.0e4,  1.0e5,  1.0e6,  1.0e7,  1.0e8,  1.0e9,
+            1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18, 1.0e19,
+        };
+        constexpr double kPower10Neg[kMaxPower] = {
+            1.0e0,   1.0e-1,  1.0e-2,  1.0e-3,  1.0e-4,  1.0e-5,  1.0e-6,  1.0e-7,  1.0e-8,  1.0e-9,
+            1.0e-10, 1.0e-11, 1.0e-12, 1.0e-13, 1.0e-14, 1.0e-15, 1.0e-16, 1.0e-17, 1.0e-18, 1.0e-19,
+        };
+
+        inline bool IsWhitespace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+        inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+        // 'end' acts as the terminating newline, so chunks need no sentinel
+        struct Cursor {
+            const char* p;
+            const char* end;
+            char peek() const { return p < end ? *p : '\n'; }
+            bool atNewline() const { return peek() == '\n'; }
+            void skipWhitespace() { while (p < end && IsWhitespace(*p)) ++p; }
+            void skipLine() { while (p < end && *p != '\n') ++p; if (p < end) ++p; }
+        };
+
+        inline float ParseFloat(Cursor& c) {
+            c.skipWhitespace();
+
+            double sign = 1.0;
+            if (c.peek() == '+') { ++c.p; }
+            else if (c.peek() == '-') { sign = -1.0; ++c.p; }
+
+            double num = 0.0;
+            while (IsDigit(c.peek())) num = 10.0 * num + (double)(*c.p++ - '0');
+
+            if (c.peek() == '.') ++c.p;
+
+            double fra = 0.0;
+            double div = 1.0;
+            while (IsDigit(c.peek())) {
+                fra = 10.0 * fra + (double)(*c.p++ - '0');
+                div *= 10.0;
+            }
+            num += fra / div;
+
+            if (c.peek() == 'e' || c.peek() == 'E') {
+                ++c.p;
+                const double* powers = kPower10Pos;
+                if (c.peek() == '+') { ++c.p; }
+                else if (c.peek() == '-') { powers = kPower10Neg; ++c.p; }
+
+                unsigned int eval = 0;
+                while (IsDigit(c.peek())) eval = 10 * eval + (*c.p++ - '0');
+
+                num *= (eval >= (unsigned)kMaxPower) ? 0.0 : powers[eval];
+            }
+            return (float)(sign * num);
+        }
+
+        inline int ParseInt(Cursor& c) {
+            int sign = 1;
+            if (c.peek() == '-') { sign = -1; ++c.p; }
+            int num = 0;
+            while (IsDigit(c.peek())) num = 10 * num + (*c.p++ - '0');
+            return sign * num;
+        }
+
+        enum class LineKind { Other, Position, TexCoord, Normal, Face, Unsupported };
+
+        // Classifies the line at c.p and leaves c.p after the keyword (fast_obj dispatch rules)
+        inline LineKind Classify(Cursor& c) {
+            c.skipWhitespace();
+            const char k = c.peek();
+            if (k == 'v') {
+                ++c.p;
+                const char n = c.peek();
+                if (n == ' ' || n == '\t') { ++c.p; return LineKind::Position; }
+                if (n == 't') { ++c.p; return LineKind::TexCoord; }
+                if (n == 'n') { ++c.p; return LineKind::Normal; }
+                return LineKind::Other;
+            }
+            if (k == 'f') {
+                ++c.p;
+                const char n = c.peek();
+                if (n == ' ' || n == '\t') { ++c.p; return LineKind::Face; }
+                return LineKind::Other;
+            }
+            if (k == 'l' || k == 'p') {
+                ++c.p;
+                const char n = c.peek();
+                if (n == ' ' || n == '\t') return LineKind::Unsupported;
+                return LineKind::Other;
+            }
+            return LineKind::Other;
+        }
+
+        struct RawCorner { int v, t, n; };
+
+        // One face corner token "v", "v/t", "v//n" or "v/t/n"; false on a token fast_obj would reject
+        inline bool ParseCorner(Cursor& c, RawCorner& out) {
+            out = { 0, 0, 0 };
+            out.v = ParseInt(c);
+            if (c.peek() == '/') {
+                ++c.p;
+                if (c.peek() != '/') out.t = ParseInt(c);
+                if (c.peek() == '/') { ++c.p; out.n = ParseInt(c); }
+            }
+            return out.v != 0;
+        }
+
+        struct ChunkCounts {
+            uint32_t positions = 0, texcoords = 0, normals = 0, faces = 0, corners = 0;
+            bool ok = true;
+        };
+
+        struct Triplet {
+            uint32_t p, t, n;
+            bool operator==(const Triplet& o) const { return p == o.p && t == o.t && n == o.n; }
+        };
+        struct TripletHash {
+            size_t operator()(const Triplet& k) const noexcept {
+                uint64_t h = (uint64_t(k.p) * 0x9E3779B185EBCA87ull) ^ (uint64_t(k.t) * 0xC2B2AE3D27D4EB4Full) ^ (uint64_t(k.n) * 0x165667B19E3779F9ull);
+                h ^= h >> 29;
+                return size_t(h);
+            }
+        };
+
+        template <typename Fn>
+        inline void ParallelFor(size_t count, Fn&& fn) {
+            std::vector<std::thread> threads;
+            threads.reserve(count);
+            for (size_t i = 1; i < count; ++i) threads.emplace_back([&fn, i] { fn(i); });
+            if (count) fn(0);
+            for (auto& t : threads) t.join();
+        }
+    }
+
+    inline bool ParseOBJParallel(const char* path,
+        std::vector<Vertex>& outVertices,
+        std::vector<uint32_t>& outIndices,
+        bool flipV,
+        bool flipWinding,
+        bool dropDegenerate,
+        unsigned threads = 0)   // 0 = hardware concurrency; 1 = don't (caller already runs in parallel)
+    {
+        using namespace objpar;
+
+        if (!path || threads == 1) return false;
+        const AssetData file = AssetArchive::Open(path);
+        if (!file || file.size < kParallelObjMinBytes) return false;
+
+        const char* text = reinterpret_cast<const char*>(file.data);
+        const size_t size = file.size;
+
+        const size_t hw = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+        const size_t chunkCount = std::max<size_t>(1, std::min<size_t>(hw, size / (1u << 20)));
+        if (chunkCount < 2) return false;
+
+        // ---- 1) chunk boundaries at line starts ----
+        std::vector<const char*> bounds(chunkCount + 1);
+        bounds[0] = text;
+        bounds[chunkCount] = text + size;
+        for (size_t i = 1; i < chunkCount; ++i) {
+            const char* p = text + (size * i) / chunkCount;
+            p = std::max(p, bounds[i - 1]);
+            while (p < text + size && *p != '\n') ++p;
+            bounds[i] = (p < text + size) ? p + 1 : p;
+        }
+
+        std::vector<ChunkCounts> counts(chunkCount);
+        ParallelFor(chunkCount, [&](size_t ci) {
+            ChunkCounts& cc = counts[ci];
+            Cursor c{ bounds[ci], bounds[ci + 1] };
+            while (c.p < c.end && cc.ok) {
+                switch (Classify(c)) {
+                case LineKind::Position: ++cc.positions; break;
+                case LineKind::TexCoord: ++cc.texcoords; break;
+                case LineKind::Normal:   ++cc.normals; break;
+                case LineKind::Face: {
+                    c.skipWhitespace();
+                    uint32_t fv = 0;
+                    RawCorner rc;
+                    while (!c.atNewline()) {
+                        if (!ParseCorner(c, rc)) { cc.ok = false; break; }
+                        ++fv;
+                        c.skipWhitespace();
+                    }
+                    ++cc.faces;
+                    cc.corners += fv;
+                    break;
+                }
+                case LineKind::Unsupported: cc.ok = false; break;
+                default: break;
+                }
+                c.skipLine();
+            }
+            });
+
+        // ---- 2) offsets, then parse into the shared arrays ----
+        std::vector<ChunkCounts> base(chunkCount);
+        ChunkCounts total{};
+        for (size_t ci = 0; ci < chunkCount; ++ci) {
+            if (!counts[ci].ok) return false;
+            base[ci] = total;
+            total.positions += counts[ci].positions;
+            total.texcoords += counts[ci].texcoords;
+            total.normals += counts[ci].normals;
+            total.faces += counts[ci].faces;
+            total.corners += counts[ci].corners;
+        }
+
+        // index 0 is the "missing" slot, like fast_obj
+        std::vector<float> positions(3 * (size_t(total.positions) + 1), 0.f);
+        std::vector<float> texcoords(2 * (size_t(total.texcoords) + 1), 0.f);
+        std::vector<float> normals(3 * (size_t(total.normals) + 1), 0.f);
+        std::vector<uint32_t> faceStart(size_t(total.faces) + 1);
+        std::vector<Triplet> corners(total.corners);
+        std::atomic<bool> ok{ true };
+
+        ParallelFor(chunkCount, [&](size_t ci) {
+            const ChunkCounts& b = base[ci];
+            uint32_t np = 0, nt = 0, nn = 0, nf = 0, nc = 0;
+            Cursor c{ bounds[ci], bounds[ci + 1] };
+            while (c.p < c.end) {
+                switch (Classify(c)) {
+                case LineKind::Position: {
+                    float* dst = &positions[3 * (size_t(b.positions) + np + 1)];
+                    for (int k = 0; k < 3; ++k) dst[k] = ParseFloat(c);
+                    ++np;
+                    break;
+                }
+                case LineKind::TexCoord: {
+                    float* dst = &texcoords[2 * (size_t(b.texcoords) + nt + 1)];
+                    for (int k = 0; k < 2; ++k) dst[k] = ParseFloat(c);
+                    ++nt;
+                    break;
+                }
+                case LineKind::Normal: {
+                    float* dst = &normals[3 * (size_t(b.normals) + nn + 1)];
+                    for (int k = 0; k < 3; ++k) dst[k] = ParseFloat(c);
+                    ++nn;
+                    break;
+                }
+                case LineKind::Face: {
+                    // relative indices count back from the records seen so far (+1: fast_obj's dummy slot)
+                    const int64_t posSoFar = int64_t(b.positions) + np + 1;
+                    const int64_t texSoFar = int64_t(b.texcoords) + nt + 1;
+                    const int64_t nrmSoFar = int64_t(b.normals) + nn + 1;
+                    faceStart[size_t(b.faces) + nf] = b.corners + nc;
+
+                    c.skipWhitespace();
+                    RawCorner rc;
+                    while (!c.atNewline()) {
+                        ParseCorner(c, rc);
+                        const int64_t p = rc.v < 0 ? posSoFar + rc.v : rc.v;
+                        const int64_t t = rc.t < 0 ? texSoFar + rc.t : rc.t;
+                        const int64_t n = rc.n < 0 ? nrmSoFar + rc.n : rc.n;
+                        if (p < 1 || p > int64_t(total.positions) ||
+                            t < 0 || t > int64_t(total.texcoords) ||
+                            n < 0 || n > int64_t(total.normals)) {
+                            ok = false;
+                        }
+                        corners[size_t(b.corners) + nc] = Triplet{ uint32_t(p), uint32_t(t), uint32_t(n) };
+                        ++nc;
+                        c.skipWhitespace();
+                    }
+                    ++nf;
+                    break;
+                }
+                default: break;
+                }
+                c.skipLine();
+            }
+            });
+        if (!ok) return false;
+        faceStart[total.faces] = total.corners;
+
+        // ---- 3) sharded de-dup: firstCorner[i] = first corner with the same triplet ----
+        const size_t shardCount = chunkCount;
+        std::vector<std::vector<std::vector<uint32_t>>> shardLists(chunkCount, std::vector<std::vector<uint32_t>>(shardCount));
+        ParallelFor(chunkCount, [&](size_t ci) {
+            const uint32_t begin = base[ci].corners;
+            const uint32_t end = begin + counts[ci].corners;
+            auto& lists = shardLists[ci];
+            for (auto& l : lists) l.reserve((end - begin) / shardCount + 16);
+            TripletHash hasher;
+            for (uint32_t i = begin; i < end; ++i)
+                lists[(hasher(corners[i]) >> 7) % shardCount].push_back(i);
+            });
+
+        std::vector<uint32_t> firstCorner(total.corners);
+        ParallelFor(shardCount, [&](size_t s) {
+            size_t n = 0;
+            for (size_t ci = 0; ci < chunkCount; ++ci) n += shardLists[ci][s].size();
+            std::unordered_map<Triplet, uint32_t, TripletHash> seen;
+            seen.reserve(n);
+            // chunks in order, corners ascending inside each list -> first insert is the first occurrence
+            for (size_t ci = 0; ci < chunkCount; ++ci)
+                for (uint32_t i : shardLists[ci][s])
+                    firstCorner[i] = seen.emplace(corners[i], i).first->second;
+            });
+        shardLists.clear();
+        shardLists.shrink_to_fit();
+
+        // linear pass: ids in order of first use, exactly like the serial emitVertex
+        std::vector<uint32_t> vertexOf(total.corners);
+        std::vector<uint32_t> vertexCorner;
+        vertexCorner.reserve(total.corners);
+        for (uint32_t i = 0; i < total.corners; ++i) {
+            if (firstCorner[i] == i) {
+                vertexOf[i] = static_cast<uint32_t>(vertexCorner.size());
+                vertexCorner.push_back(i);
+            }
+            else {
+                vertexOf[i] = vertexOf[firstCorner[i]];
+            }
+        }
+        firstCorner.clear();
+        firstCorner.shrink_to_fit();
+
+        // ---- 4) vertices, then triangles per chunk ----
+        outVertices.clear();
+        outIndices.clear();
+        outVertices.resize(vertexCorner.size());
+        const size_t vertexCount = vertexCorner.size();
+        ParallelFor(chunkCount, [&](size_t ci) {
+            const size_t begin = vertexCount * ci / chunkCount;
+            const size_t end = vertexCount * (ci + 1) / chunkCount;
+            for (size_t id = begin; id < end; ++id) {
+                const Triplet& ix = corners[vertexCorner[id]];
+                Vertex v{};
+                v.color = glm::vec3(1);
+
+                const float* P = &positions[3 * size_t(ix.p)];
+                v.pos = glm::vec3(P[0], P[1], P[2]);
+
+                if (ix.t) {
+                    const float* T = &texcoords[2 * size_t(ix.t)];
+                    v.texCoord = glm::vec2(T[0], flipV ? (1.0f - T[1]) : T[1]);
+                }
+                else {
+                    v.texCoord = glm::vec2(0);
+                }
+
+                if (ix.n) {
+                    const float* N = &normals[3 * size_t(ix.n)];
+                    v.normal = glm::vec3(N[0], N[1], N[2]);
+                }
+                else {
+                    v.normal = glm::vec3(0, 1, 0);
+                }
+                outVertices[id] = v;
+            }
+            });
+
+        std::vector<std::vector<uint32_t>> chunkIndices(chunkCount);
+        ParallelFor(chunkCount, [&](size_t ci) {
+            auto& dst = chunkIndices[ci];
+            dst.reserve(size_t(counts[ci].corners) * 3);
+            const uint32_t fBegin = base[ci].faces;
+            const uint32_t fEnd = fBegin + counts[ci].faces;
+            for (uint32_t f = fBegin; f < fEnd; ++f) {
+                const uint32_t start = faceStart[f];
+                const uint32_t fv = faceStart[f + 1] - start;
+                // fan straight off the corner ids, no per-face allocation
+                for (uint32_t i = 1; i + 1 < fv; ++i) {
+                    const uint32_t ia = vertexOf[start];
+                    uint32_t ib = vertexOf[start + i];
+                    uint32_t ic = vertexOf[start + i + 1];
+                    if (flipWinding) std::swap(ib, ic);
+
+                    if (ia == ib || ib == ic || ia == ic) {
+                        if (dropDegenerate) continue;
+                    }
+                    const glm::vec3 A = outVertices[ia].pos;
+                    const glm::vec3 B = outVertices[ib].pos;
+                    const glm::vec3 C = outVertices[ic].pos;
+                    const float area2 = glm::length(glm::cross(B - A, C - A));
+                    if (area2 < 1e-8f && dropDegenerate) continue;
+
+                    dst.push_back(ia);
+                    dst.push_back(ib);
+                    dst.push_back(ic);
+                }
+            }
+            });
+
+        size_t indexCount = 0;
+        for (const auto& ci : chunkIndices) indexCount += ci.size();
+        outIndices.reserve(indexCount);
+        for (const auto& ci : chunkIndices) outIndices.insert(outIndices.end(), ci.begin(), ci.end());
+
+        return true;
+    }
+
+} // namespace ObjUtils
@@ -0,0 +1,34 @@
+// TextureRole.h
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace ObjUtils {
+
+    // What a texture is sampled as, which decides its cooked format and color space:
+    //   Color  -> BC7 sRGB (albedo)
+    //   Normal -> BC5 linear, XY only; the shader rebuilds Z
+    //   Data   -> BC4 linear, one channel (roughness, metalness, height, AO)
+    // Whoever references the texture knows it (the material slot, the glTF material); file names
+    // don't. The cooker reads it from <sourceDir>/texture_roles.json and stamps it into the package,
+    // and the runtime only uses a package cooked for the role it asks for.
+    enum class TextureRole : uint32_t { Color = 0, Normal = 1, Data = 2 };
+
+    inline const char* TextureRoleName(TextureRole role) {
+        switch (role) {
+        case TextureRole::Normal: return "normal";
+        case TextureRole::Data: return "data";
+        default: return "color";
+        }
+    }
+
+    inline bool TextureRoleFromName(const std::string& name, TextureRole& out) {
+        if (name == "color") out = TextureRole::Color;
+        else if (name == "normal") out = TextureRole::Normal;
+        else if (name == "data") out = TextureRole::Data;
+        else return false;
+        return true;
+    }
+
+} // namespace ObjUtils
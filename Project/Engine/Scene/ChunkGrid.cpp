@@ -45,6 +45,7 @@ static std::string to_string(const MeshKey& k) {
         << ", IB=" << ptrStr((void*)k.indexBuffer)
         << "+" << k.ibOffset
         << ", idx=" << k.indexCount
+        << (k.indexType == VK_INDEX_TYPE_UINT16 ? "(u16)" : "(u32)")
         << ", pipe=" << k.pipelineIndex
         << ", group=" << k.logicalId
         << "}";
@@ -89,6 +90,28 @@ void ChunkGrid::forVisibleCells(const CellCallback& fn) const {
             emit(c, /*forceVisible*/ false);
         }
 }
+
+void ChunkGrid::forVisibleObjectDistances(const std::function<void(BaseObject*, float)>& fn) const {
+    std::unordered_map<BaseObject*, float> nearest;
+    forVisibleCells([&](const ChunkCoord& c, const glm::vec3& mn, const glm::vec3& mx) {
+        auto it = m_chunks.find(c);
+        if (it == m_chunks.end()) return;
+
+        const float dx = std::max({ mn.x - m_camPos.x, 0.0f, m_camPos.x - mx.x });
+        const float dz = std::max({ mn.z - m_camPos.z, 0.0f, m_camPos.z - mx.z });
+        const float d = std::sqrt(dx * dx + dz * dz);
+        for (const auto& kv : it->second.batches)
+            for (BaseObject* o : kv.second) {
+                auto [entry, inserted] = nearest.try_emplace(o, d);
+                if (!inserted) entry->second = std::min(entry->second, d);
+            }
+        });
+    for (const auto& kv : m_globalBatches)
+        for (BaseObject* o : kv.second) nearest[o] = 0.0f;
+
+    for (const auto& [o, d] : nearest) fn(o, d);
+}
+
 // ---------- culling config ----------
 void ChunkGrid::setCulling(const glm::vec3& camPos, float renderDistance,
     const glm::vec3& camForward,
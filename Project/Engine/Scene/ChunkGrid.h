@@ -147,6 +147,10 @@ public:
 
     void forVisibleCells(const CellCallback& fn) const;
 
+    // Every visible object once, with its XZ distance from the camera to the nearest visible chunk
+    // holding it (0 in the camera chunk and for globals). Conservative: nothing in the chunk is closer.
+    void forVisibleObjectDistances(const std::function<void(BaseObject*, float)>& fn) const;
+
 private:
     static glm::vec3 getPos(const BaseObject* obj);
 
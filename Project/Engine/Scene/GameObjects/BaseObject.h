@@ -1,5 +1,6 @@
 ﻿// BaseObject.h
 #pragma once
+#include <algorithm>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <memory>
@@ -31,7 +32,7 @@ public:
         recalcModel();
     }
 
-    void draw(VkPipelineLayout& pipelineLayout, VkCommandBuffer& buffer) {
+    void draw(VkPipelineLayout& pipelineLayout, const VkPushConstantRange& pushRange, VkCommandBuffer& buffer) {
         // Push per-object constants (model + tex IDs) before drawing the shared mesh
         struct Push {
             glm::mat4 model;
@@ -46,11 +47,12 @@ public:
         pc.RoughnessID = m ? m->getRoughnessMapID() : 0u;
         pc.HeightMapID = m ? m->getHeightMapID() : 0u;
 
-        vkCmdPushConstants(buffer, pipelineLayout,
-            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-            0, sizeof(Push), &pc);
+        if (pushRange.size > 0) {
+            vkCmdPushConstants(buffer, pipelineLayout, pushRange.stageFlags,
+                0, std::min<uint32_t>(pushRange.size, sizeof(Push)), &pc);
+        }
 
-        mesh->draw(pipelineLayout, buffer);
+        mesh->draw(pipelineLayout, pushRange, buffer);
     }
 
     // Keep the public API the same, but manage transform per-object
@@ -59,6 +61,25 @@ public:
         recalcModel();
     }
 
+    // The matrix setPosition builds: T * Rz * Ry * Rx * S
+    static glm::mat4 ComposeModel(const glm::vec3& pos, const glm::vec3& scale, const glm::vec3& rotDeg) {
+        // ZYX euler (deg) → radians
+        glm::vec3 r = glm::radians(rotDeg);
+        glm::mat4 T = glm::translate(glm::mat4(1), pos);
+        glm::mat4 R =
+            glm::rotate(glm::mat4(1), r.z, { 0,0,1 }) *
+            glm::rotate(glm::mat4(1), r.y, { 0,1,0 }) *
+            glm::rotate(glm::mat4(1), r.x, { 1,0,0 });
+        glm::mat4 S = glm::scale(glm::mat4(1), scale);
+        return T * R * S;
+    }
+
+    // Full model matrix for placements that don't round-trip through euler angles (glTF nodes)
+    void setModelMatrix(const glm::mat4& model) {
+        m_model = model;
+        m_pos = glm::vec3(model[3]);
+    }
+
     glm::vec3 getPosition() { return m_pos; }
 
     glm::mat4 getModelMatrix() const { return m_model; }
@@ -70,12 +91,20 @@ public:
 
     void destroy(VkDevice device) { if (mesh) mesh->destroyMesh(device); }
 
+    // Swap the shared geometry (e.g. placeholder -> loaded model); the owning scene has to
+    // re-register the object since batching keys on the buffers (MeshScene::replaceMesh)
+    void setMesh(std::shared_ptr<Mesh> newMesh) {
+        mesh = std::move(newMesh);
+        if (mesh && m_material) mesh->setMaterial(m_material); // legacy-only, as in the ctor
+    }
+
     // --- pass-through for batching ---
     VkBuffer getVertexBuffer() const { return mesh->getVertexBuffer(); }
     VkBuffer getIndexBuffer()  const { return mesh->getIndexBuffer(); }
     VkDeviceSize getVBOffset() const { return mesh->getVBOffset(); }
     VkDeviceSize getIBOffset() const { return mesh->getIBOffset(); }
     uint32_t getIndexCount()   const { return mesh->getIndexCount(); }
+    VkIndexType getIndexType() const { return mesh->getIndexType(); }
 
     // Per-object material (falls back to mesh default if unset)
     const std::shared_ptr<Material>& getMaterial() const {
@@ -90,19 +119,10 @@ public:
 
     Mesh* rawMesh() { return mesh.get(); }
     const Mesh* rawMesh() const { return mesh.get(); }
+    const std::shared_ptr<Mesh>& getMesh() const { return mesh; }
 
 private:
-    void recalcModel() {
-        // ZYX euler (deg) → radians
-        glm::vec3 r = glm::radians(m_rotDeg);
-        glm::mat4 T = glm::translate(glm::mat4(1), m_pos);
-        glm::mat4 R =
-            glm::rotate(glm::mat4(1), r.z, { 0,0,1 }) *
-            glm::rotate(glm::mat4(1), r.y, { 0,1,0 }) *
-            glm::rotate(glm::mat4(1), r.x, { 1,0,0 });
-        glm::mat4 S = glm::scale(glm::mat4(1), m_scale);
-        m_model = T * R * S;
-    }
+    void recalcModel() { m_model = ComposeModel(m_pos, m_scale, m_rotDeg); }
 
     // Shared geometry
     std::shared_ptr<Mesh> mesh;
@@ -6,6 +6,7 @@
 #include "Component.h"
 #include "TransformComponent.h"
 #include "ModelMeshComponent.h"
+#include "GltfModelComponent.h"
 #include "PrimitiveMeshComponent.h"
 
 class GameObject {
@@ -0,0 +1,136 @@
+#include "GltfModelComponent.h"
+#include "../SceneModelManager.h"
+#include "GameObject.h"
+#include <Engine/ObjUtils/GlbLoader.h>
+#include <Engine/Graphics/MeshManager.h>
+#include <Engine/Graphics/TextureManager.h>
+#include <Engine/Core/Hash.h>
+
+// Parts get their world matrix as is: node transforms can hold any rotation (and shear), which
+// doesn't survive a round trip through BaseObject's euler angles
+void GltfModelComponent::onTransformUpdated(const glm::vec3& pos, const glm::vec3& scale, const glm::vec3& rot)
+{
+    const glm::mat4 parentWorld = BaseObject::ComposeModel(pos, scale, rot);
+    for (const Part& part : m_parts) {
+        if (!part.base) continue;
+        SceneModelManager::getInstance().updateObjectTransform(part.base, parentWorld * part.local);
+        applyCoverage(part, parentWorld);
+    }
+}
+
+void GltfModelComponent::addModelToScene(const std::string& modelFile) {
+    auto parent = getParent();
+    if (!parent) return;
+
+    ObjUtils::GlbAsset asset;
+    if (!ObjUtils::LoadGLB(modelFile, asset)) return;
+
+    const std::vector<std::shared_ptr<Material>> materials = createMaterials(asset);
+    auto& meshManager = MeshManager::GetInstance();
+    auto& sceneManager = SceneModelManager::getInstance();
+
+    // One mesh per primitive, created on first use and shared by every draw that references it
+    std::vector<std::vector<std::shared_ptr<Mesh>>> meshes(asset.meshes.size());
+    for (uint32_t m = 0; m < asset.meshes.size(); ++m) {
+        const auto& prims = asset.meshes[m].primitives;
+        meshes[m].resize(prims.size());
+        for (uint32_t p = 0; p < prims.size(); ++p) {
+            const int matIndex = prims[p].material;
+            const std::shared_ptr<Material> mat =
+                (matIndex >= 0 && size_t(matIndex) < materials.size()) ? materials[matIndex] : nullptr;
+
+            const uint64_t assetId = ObjUtils::MakeGlbAssetId(modelFile, m, p, m_optimize);
+            std::shared_ptr<Mesh> mesh = meshManager.FindAsset(assetId);
+            if (!mesh) mesh = meshManager.GetOrCreateAsset(assetId, ObjUtils::DecodeGlbPrimitive(asset, m, p, m_optimize), mat);
+            meshes[m][p] = std::move(mesh);
+        }
+    }
+
+    const glm::vec3 pos = parent->getTransform()->position;
+    const glm::vec3 scale = parent->getTransform()->scale;
+    const glm::vec3 rot = parent->getTransform()->rotation;
+    const glm::mat4 parentWorld = BaseObject::ComposeModel(pos, scale, rot);
+
+    for (const ObjUtils::GlbDraw& draw : asset.draws) {
+        const auto& prims = asset.meshes[draw.mesh].primitives;
+        for (uint32_t p = 0; p < prims.size(); ++p) {
+            const std::shared_ptr<Mesh>& mesh = meshes[draw.mesh][p];
+            if (!mesh) continue;
+            const int matIndex = prims[p].material;
+            const std::shared_ptr<Material> mat =
+                (matIndex >= 0 && size_t(matIndex) < materials.size()) ? materials[matIndex] : nullptr;
+
+            const glm::mat4 world = parentWorld * draw.transform;
+            auto bo = sceneManager.addMeshModel(mesh, glm::vec3(world[3]), glm::vec3(1.f), glm::vec3(0.f), mat);
+            if (!bo) continue;
+            bo->setModelMatrix(world);
+
+            if (m_groupByFile) bo->setLogicalGroupId(Hash::Path(modelFile));
+
+            Part part{ bo, mesh, draw.transform };
+            applyCoverage(part, parentWorld);
+            if (m_makeGlobal) sceneManager.getMeshScene()->setObjectGlobal(bo, true);
+
+            m_parts.push_back(std::move(part));
+            m_bases.push_back(bo);
+        }
+    }
+}
+
+// Textures are cached under "<file>#image<N>" so respawning the asset reuses them. The packed
+// metallic-roughness image is split into separate maps because the shader samples each via .r.
+// All maps go through one loadMany so they decode in parallel and small ones can be packed.
+std::vector<std::shared_ptr<Material>> GltfModelComponent::createMaterials(const ObjUtils::GlbAsset& asset) const {
+    const ObjUtils::GlbAsset* source = &asset;   // loadMany waits for its decodes, so this outlives them
+    // Roles come from the material slot that references the image
+    auto decodeImage = [source](int index, ObjUtils::TextureRole role) {
+        const ObjUtils::GlbImage& image = source->images[index];
+        if (!image.data) return Texture::Decode(image.uri, role);
+        TextureImage decoded = Texture::DecodeMemory(image.data, image.size);
+        // normal and data maps hold vectors/values, not colors, so they're sampled as UNORM
+        if (role != ObjUtils::TextureRole::Color && decoded.format == VK_FORMAT_R8G8B8A8_SRGB)
+            decoded.format = VK_FORMAT_R8G8B8A8_UNORM;
+        return decoded;
+        };
+    auto imageKey = [&](int index) { return m_modelFile + "#image" + std::to_string(index); };
+
+    // 4 maps per material: base color, normal, metal, rough. Missing ones keep an empty key.
+    std::vector<std::pair<std::string, std::function<TextureImage()>>> sources;
+    sources.reserve(asset.materials.size() * 4);
+    auto addImage = [&](int index, ObjUtils::TextureRole role) {
+        if (index < 0 || size_t(index) >= asset.images.size()) { sources.emplace_back(); return; }
+        sources.emplace_back(imageKey(index), [decodeImage, index, role] { return decodeImage(index, role); });
+        };
+    auto addChannel = [&](int index, int channel, const char* suffix) {
+        if (index < 0 || size_t(index) >= asset.images.size()) { sources.emplace_back(); return; }
+        sources.emplace_back(imageKey(index) + suffix, [decodeImage, index, channel] {
+            return Texture::ExtractChannel(decodeImage(index, ObjUtils::TextureRole::Data), channel);
+            });
+        };
+    for (const ObjUtils::GlbMaterial& m : asset.materials) {
+        addImage(m.baseColorImage, ObjUtils::TextureRole::Color);
+        addImage(m.normalImage, ObjUtils::TextureRole::Normal);
+        addChannel(m.metallicRoughnessImage, 2, ":metal");
+        addChannel(m.metallicRoughnessImage, 1, ":rough");
+    }
+    const auto textures = TextureManager::GetInstance().loadMany(sources);
+
+    std::vector<std::shared_ptr<Material>> materials;
+    materials.reserve(asset.materials.size());
+    for (size_t i = 0; i < asset.materials.size(); ++i)
+        materials.push_back(Material::FromTextures(textures[i * 4], textures[i * 4 + 1], textures[i * 4 + 2], textures[i * 4 + 3]));
+    return materials;
+}
+
+// World-space coverage of one part: mesh AABB pushed through its full transform
+void GltfModelComponent::applyCoverage(const Part& part, const glm::mat4& parentWorld) {
+    const glm::mat4 world = parentWorld * part.local;
+    const glm::vec3 center = 0.5f * (part.mesh->getLocalMin() + part.mesh->getLocalMax());
+    const glm::vec3 localHalf = 0.5f * (part.mesh->getLocalMax() - part.mesh->getLocalMin());
+    const glm::mat3 m(world);
+    const glm::vec3 worldHalf(
+        std::abs(m[0].x) * localHalf.x + std::abs(m[1].x) * localHalf.y + std::abs(m[2].x) * localHalf.z,
+        std::abs(m[0].y) * localHalf.x + std::abs(m[1].y) * localHalf.y + std::abs(m[2].y) * localHalf.z,
+        std::abs(m[0].z) * localHalf.x + std::abs(m[1].z) * localHalf.y + std::abs(m[2].z) * localHalf.z);
+    SceneModelManager::getInstance().getMeshScene()->setObjectCoverageOverride(part.base, glm::vec3(world * glm::vec4(center, 1.f)), worldHalf);
+}
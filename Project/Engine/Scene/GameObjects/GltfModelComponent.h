@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Component.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <glm/glm.hpp>
+#include <Engine/Graphics/Material.h>
+#include <Engine/Scene/GameObjects/BaseObject.h>
+
+namespace ObjUtils { struct GlbAsset; }
+class Mesh;
+
+// Spawns every mesh placement of a .glb under the parent's transform. Each primitive becomes a
+// shared MeshManager asset, so nodes and EXT_mesh_gpu_instancing instances that reference the
+// same mesh end up in one MeshScene instance batch.
+class GltfModelComponent : public Component {
+public:
+    GltfModelComponent(GameObject* parent,
+        const std::string& modelFile,
+        bool makeGlobal = false,
+        bool groupByFile = true,
+        bool optimize = false)    // vertex cache/fetch reorder of each primitive (once per asset)
+        : m_modelFile(modelFile)
+        , m_makeGlobal(makeGlobal)
+        , m_groupByFile(groupByFile)
+        , m_optimize(optimize)
+    {
+        setParent(parent);
+        addModelToScene(modelFile);
+    }
+
+    void initialize() override { }
+    void update() override {  }
+    void render() override {  }
+    const std::vector<BaseObject*>& getBaseObjects() const { return m_bases; }
+    BaseObject* getFirstBase() const { return m_bases.empty() ? nullptr : m_bases[0]; }
+
+    void onTransformUpdated(const glm::vec3& pos,
+        const glm::vec3& scale,
+        const glm::vec3& rot) override;
+private:
+    struct Part {
+        BaseObject* base = nullptr;
+        std::shared_ptr<Mesh> mesh;
+        glm::mat4 local{ 1.f };   // placement inside the asset
+    };
+
+    void addModelToScene(const std::string& modelFile);
+    std::vector<std::shared_ptr<Material>> createMaterials(const ObjUtils::GlbAsset& asset) const;
+    void applyCoverage(const Part& part, const glm::mat4& parentWorld);
+
+    std::string m_modelFile;
+    bool m_makeGlobal = false;
+    bool m_groupByFile = true;
+    bool m_optimize = false;
+    std::vector<Part> m_parts;
+    std::vector<BaseObject*> m_bases;
+};
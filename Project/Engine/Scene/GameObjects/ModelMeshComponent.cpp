@@ -2,36 +2,11 @@
 #include "../SceneModelManager.h"
 #include "GameObject.h"
 #include <Engine/ObjUtils/ObjUtils.h>
-#include <cctype>
-#include <algorithm>
-
-// Hash a string (lowercased path) → 64-bit FNV-1a
-static uint64_t HashPath64(const std::string& sIn) {
-    std::string s = sIn;
-    std::transform(s.begin(), s.end(), s.begin(),
-        [](unsigned char c) { return (unsigned char)std::tolower(c); });
-
-    const uint64_t FNV_OFFSET = 1469598103934665603ull;
-    const uint64_t FNV_PRIME = 1099511628211ull;
-    uint64_t h = FNV_OFFSET;
-    for (unsigned char c : s) {
-        h ^= (uint64_t)c;
-        h *= FNV_PRIME;
-    }
-    return h;
-}
-
-// Compute local-space AABB from vertices
-static void ComputeLocalAABB(const std::vector<Vertex>& vertices,
-    glm::vec3& outMin, glm::vec3& outMax)
-{
-    if (vertices.empty()) { outMin = glm::vec3(0); outMax = glm::vec3(0); return; }
-    outMin = outMax = vertices[0].pos;
-    for (const auto& v : vertices) {
-        outMin = glm::min(outMin, v.pos);
-        outMax = glm::max(outMax, v.pos);
-    }
-}
+#include <Engine/Graphics/MeshManager.h>
+#include <Engine/Core/Hash.h>
+#include <Engine/Core/AssetLoader.h>
+#include <functional>
+#include <unordered_map>
 
 // Convert local half extents to world half extents given rotation
 static glm::vec3 RotatedAABBHalfExtents(const glm::quat& q, const glm::vec3& localHalf) {
@@ -55,19 +30,37 @@ void ModelMeshComponent::onTransformUpdated(const glm::vec3& pos, const glm::vec
     }
 }
 
+// Async model loads in flight: assetId -> callbacks waiting for it (main thread only)
+using MeshReadyFn = std::function<void(const std::shared_ptr<Mesh>&)>;
+static std::unordered_map<uint64_t, std::vector<MeshReadyFn>> s_pendingModels;
+
 void ModelMeshComponent::addModelToScene(const std::string& modelFile) {
     auto parent = getParent();
     if (!parent) return;
 
-    // CPU load
-    glm::vec3 color{ 1.f, 0.f, 1.f };
-    std::vector<Vertex> vertices;
-    std::vector< uint32_t> indices;
-    ObjUtils::ParseOBJ(modelFile.c_str(), vertices, indices, false, false,false,true);  // we'll fix UVs below
+    // Already imported with these flags? Then the mesh is shared as is (no parse, no copy, no hash)
+    auto& meshManager = MeshManager::GetInstance();
+    const uint64_t assetId = ObjUtils::MakeAssetId(modelFile.c_str(), false, false, true);
+    std::shared_ptr<Mesh> mesh = meshManager.FindAsset(assetId);
+    const bool loading = !mesh && m_asyncLoad;
+    if (loading) {
+        mesh = meshManager.GetUnitCube();
+    }
+    else if (!mesh) {
+        // CPU load; the blob is shared with the parse cache and the mesh, never copied
+        MeshBlobPtr blob = ObjUtils::ParseOBJShared(modelFile.c_str(), false, false, false, true, true);
+        mesh = meshManager.GetOrCreateAsset(assetId, std::move(blob), m_material);
+        if (!mesh) {
+            std::cerr << "[ModelMeshComponent] failed to load \"" << modelFile << "\"\n";
+            return;
+        }
+    }
+
+    if (!loading) prepareMesh(*mesh, modelFile);
 
     auto& sceneManager = SceneModelManager::getInstance();
     auto bo = sceneManager.addMeshModel(
-        vertices, indices,
+        mesh,
         parent->getTransform()->position,
         parent->getTransform()->scale,
         parent->getTransform()->rotation,
@@ -77,25 +70,72 @@ void ModelMeshComponent::addModelToScene(const std::string& modelFile) {
     m_bases.push_back(bo); // store the BaseObject
 
     if (m_groupByFile && bo) {
-        bo->setLogicalGroupId(HashPath64(modelFile));
+        bo->setLogicalGroupId(Hash::Path(modelFile));
     }
 
     // whole-object coverage override (unchanged)
-    if (bo) {
-        const glm::vec3 pos = parent->getTransform()->position;
-        const glm::vec3 scale = parent->getTransform()->scale;
-        const glm::vec3 rdeg = parent->getTransform()->rotation;
-        const glm::quat q = glm::quat(glm::radians(rdeg));
-
-        glm::vec3 vmin, vmax;
-        ComputeLocalAABB(vertices, vmin, vmax);
-        glm::vec3 localHalf = 0.5f * (vmax - vmin);
-        glm::vec3 scaledHalf = glm::abs(localHalf * scale);
-        glm::vec3 worldHalf = RotatedAABBHalfExtents(q, scaledHalf);
-        sceneManager.getMeshScene()->setObjectCoverageOverride(bo, pos, worldHalf);
-    }
+    if (bo) applyCoverage(bo, *mesh);
 
     if (m_makeGlobal && bo) {
         sceneManager.getMeshScene()->setObjectGlobal(bo, true);
     }
+
+    if (loading && bo) loadModelAsync(bo, assetId, modelFile);
+}
+
+void ModelMeshComponent::loadModelAsync(BaseObject* bo, uint64_t assetId, const std::string& modelFile) {
+    std::weak_ptr<bool> alive = m_alive;
+    MeshReadyFn onReady = [this, alive, bo, modelFile](const std::shared_ptr<Mesh>& mesh) {
+        if (alive.expired() || !mesh) return;
+        prepareMesh(*mesh, modelFile);
+        SceneModelManager::getInstance().getMeshScene()->replaceMesh(bo, mesh);
+        applyCoverage(bo, *mesh);
+        };
+
+    // Spawning the same file again while it loads just waits for the first request
+    auto [pending, first] = s_pendingModels.try_emplace(assetId);
+    pending->second.push_back(std::move(onReady));
+    if (!first) return;
+
+    AssetLoader::GetInstance().enqueue<std::shared_ptr<Mesh>>(modelFile,
+        [assetId, modelFile] {
+            // Parse, optimize and meshlet build all happen here. No material is passed, so a
+            // shared mesh that is already live is never written from this thread.
+            MeshBlobPtr blob = ObjUtils::ParseOBJShared(modelFile.c_str(), false, false, false, true, true);
+            return MeshManager::GetInstance().GetOrCreateAsset(assetId, std::move(blob));
+        },
+        [assetId, modelFile](std::shared_ptr<Mesh>& mesh) {
+            auto waiting = s_pendingModels.find(assetId);
+            if (waiting == s_pendingModels.end()) return;
+            std::vector<MeshReadyFn> callbacks = std::move(waiting->second);
+            s_pendingModels.erase(waiting);
+
+            if (!mesh) std::cerr << "[ModelMeshComponent] failed to load \"" << modelFile << "\"\n";
+            for (auto& cb : callbacks) cb(mesh);
+        });
+}
+
+// CPU residency has to be decided before the first upload
+void ModelMeshComponent::prepareMesh(Mesh& mesh, const std::string& modelFile) const {
+    if (!m_cpuAccess) return;
+    if (mesh.isInitialized() && !mesh.hasCpuData())
+        std::cerr << "[ModelMeshComponent] \"" << modelFile << "\" was already uploaded without CPU access; CPU geometry unavailable\n";
+    mesh.setKeepCpuData(true);
+}
+
+void ModelMeshComponent::applyCoverage(BaseObject* bo, const Mesh& mesh) {
+    auto parent = getParent();
+    if (!parent) return;
+
+    const glm::vec3 pos = parent->getTransform()->position;
+    const glm::vec3 scale = parent->getTransform()->scale;
+    const glm::vec3 rdeg = parent->getTransform()->rotation;
+    const glm::quat q = glm::quat(glm::radians(rdeg));
+
+    const glm::vec3& vmin = mesh.getLocalMin();
+    const glm::vec3& vmax = mesh.getLocalMax();
+    glm::vec3 localHalf = 0.5f * (vmax - vmin);
+    glm::vec3 scaledHalf = glm::abs(localHalf * scale);
+    glm::vec3 worldHalf = RotatedAABBHalfExtents(q, scaledHalf);
+    SceneModelManager::getInstance().getMeshScene()->setObjectCoverageOverride(bo, pos, worldHalf);
 }
\ No newline at end of file
@@ -15,11 +15,15 @@ public:
         const std::string& modelFile,
         const std::shared_ptr<Material> mat = {},
         bool makeGlobal = false,
-        bool groupByFile = true)
+        bool groupByFile = true,
+        bool cpuAccess = false,   // keep CPU geometry after upload (picking, physics cooking)
+        bool asyncLoad = false)   // show a placeholder cube and load the model on the AssetLoader
         : m_modelFile(modelFile)
         , m_material(mat)
         , m_makeGlobal(makeGlobal)
         , m_groupByFile(groupByFile)
+        , m_cpuAccess(cpuAccess)
+        , m_asyncLoad(asyncLoad)
     {
         setParent(parent);
         addModelToScene(modelFile);
@@ -36,10 +40,17 @@ public:
         const glm::vec3& rot) override;
 private:
     void addModelToScene(const std::string& modelFile);
+    void loadModelAsync(BaseObject* bo, uint64_t assetId, const std::string& modelFile);
+    void prepareMesh(Mesh& mesh, const std::string& modelFile) const;
+    void applyCoverage(BaseObject* bo, const Mesh& mesh);
 
     std::string m_modelFile;
     std::shared_ptr<Material> m_material;   // NEW
     bool m_makeGlobal = false;
     bool m_groupByFile = true;
+    bool m_cpuAccess = false;
+    bool m_asyncLoad = false;
+    // Lets pending async loads notice that the component is gone
+    std::shared_ptr<bool> m_alive = std::make_shared<bool>(true);
     std::vector<BaseObject*> m_bases;
 };
@@ -19,7 +19,7 @@ public:
         addLine(p0, p1, rgba); addLine(p1, p2, rgba); addLine(p2, p3, rgba); addLine(p3, p0, rgba);
     }
 
-    void drawScene(VkPipelineLayout&, VkCommandBuffer& cmd) override {
+    void drawScene(VkPipelineLayout&, const VkPushConstantRange&, VkCommandBuffer& cmd) override {
         auto& vk = vulkanVars::GetInstance();
         size_t frame = vk.currentFrame % MAX_FRAMES_IN_FLIGHT;
 
@@ -13,6 +13,7 @@ struct MeshKey {
     VkDeviceSize ibOffset{};
     uint32_t indexCount{};
     uint32_t pipelineIndex{};
+    VkIndexType indexType{ VK_INDEX_TYPE_UINT32 };
     uint64_t logicalId{ 0 }; // keep only for debug printing
 
     bool operator==(const MeshKey& o) const {
@@ -21,7 +22,8 @@ struct MeshKey {
             indexBuffer == o.indexBuffer &&
             ibOffset == o.ibOffset &&
             indexCount == o.indexCount &&
-            pipelineIndex == o.pipelineIndex;
+            pipelineIndex == o.pipelineIndex &&
+            indexType == o.indexType;
         // NOTE: logicalId intentionally ignored -> also ignore in hash
     }
 };
@@ -33,7 +35,8 @@ struct MeshKeyHash {
         h ^= std::hash<uint64_t>{}(k.vbOffset) + (h << 6) + (h >> 2);
         h ^= std::hash<uint64_t>{}(k.ibOffset) + (h << 6) + (h >> 2);
         h ^= std::hash<uint32_t>{}(k.indexCount) + (h << 6) + (h >> 2);
-        h ^= std::hash<uint32_t>{}(k.pipelineIndex);
+        h ^= std::hash<uint32_t>{}(k.pipelineIndex) + (h << 6) + (h >> 2);
+        h ^= std::hash<uint32_t>{}(static_cast<uint32_t>(k.indexType));
         // DO NOT hash logicalId if it's not in operator==.
         return h;
     }
@@ -51,6 +54,7 @@ inline MeshKey MakeMeshKey(const BaseObject* obj, uint32_t pipelineIndex) {
         obj->getIndexCount(),
         //obj->getMaterial().get(),
         pipelineIndex,
+        obj->getIndexType(),
         obj->getLogicalGroupId()   // << NEW
     };
 }
\ No newline at end of file
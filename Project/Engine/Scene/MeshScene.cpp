@@ -1,6 +1,10 @@
 #include <Engine/Scene/MeshScene.h>
 #include <Engine/Graphics/vulkanVars.h>
+#include <Engine/Graphics/TextureManager.h>
+#include <Engine/Graphics/Pipeline.h>
+#include <cmath>
 #include <iostream>
+#include <unordered_set>
 #include <Engine/ObjUtils/DebugPrint.h>
 
 
@@ -56,7 +60,28 @@ void MeshScene::rebuildAllInstanceBuffersFromCurrentTransforms()
         });
 }
 
-void MeshScene::drawScene(VkPipelineLayout& pipelineLayout, VkCommandBuffer& cmd) {
+void MeshScene::recordMeshletCulling(VkCommandBuffer cmd, const glm::mat4& viewProj, const glm::vec3& cameraPos)
+{
+    std::vector<const BaseObject*> candidates;
+    auto collect = [&](BaseObject* o) {
+        if (o && o->isInitialized() && o->rawMesh()->hasMeshlets()) candidates.push_back(o);
+        };
+
+    if (m_chunksEnabled) {
+        std::unordered_set<const BaseObject*> seen;
+        m_chunks.forVisibleBatches([&](const MeshKey&, const std::vector<BaseObject*>& batch) {
+            for (BaseObject* o : batch)
+                if (seen.insert(o).second) collect(o);
+            });
+    }
+    else {
+        for (BaseObject* o : m_BaseObjects) collect(o);
+    }
+
+    m_meshletCuller.record(cmd, candidates, viewProj, cameraPos);
+}
+
+void MeshScene::drawScene(VkPipelineLayout& pipelineLayout, const VkPushConstantRange& /*pushRange*/, VkCommandBuffer& cmd) {
     auto& vk = vulkanVars::GetInstance();
 
 
@@ -72,11 +97,16 @@ void MeshScene::drawScene(VkPipelineLayout& pipelineLayout, VkCommandBuffer& cmd
         // 1) Pack instance data
         std::vector<InstanceData> instances;
         instances.reserve(batch.size());
+        // Shader variant: whatever any material in the batch needs (the shader still checks
+        // each instance's IDs, so mixed batches stay correct). The UV flip is per instance.
+        uint32_t features = 0;
         for (BaseObject* o : batch) {
             if (!o) continue;
             InstanceData id{};
             id.model = o->getModelMatrix();
             auto& mat = o->getMaterial();
+            features |= mat ? mat->getPbrFeatures() : 0u;
+            id.flags = (!mat || mat->getFlipUV()) ? InstanceData::kInstanceFlipUV : 0u;
             id.texIds0 = glm::uvec4(
                 mat ? mat->getAlbedoMapID() : 0u,
                 mat ? mat->getNormalMapID() : 0u,
@@ -92,6 +122,8 @@ void MeshScene::drawScene(VkPipelineLayout& pipelineLayout, VkCommandBuffer& cmd
         DataBuffer* instBuf = getOrGrowInstanceBuffer(key, instances.size());
         instBuf->upload(sizeof(InstanceData) * instances.size(), instances.data());
 
+        if (m_variantPipeline) m_variantPipeline->bindVariant(cmd, features);
+
         // 3) Bind mesh VB/IB + instance VB, then draw
         VkBuffer bufs[2] = { key.vertexBuffer, instBuf->getVkBuffer() };
         VkDeviceSize offs[2] = { key.vbOffset, 0 };
@@ -103,7 +135,20 @@ void MeshScene::drawScene(VkPipelineLayout& pipelineLayout, VkCommandBuffer& cmd
         }
 
         vkCmdBindVertexBuffers(cmd, 0, 2, bufs, offs);
-        vkCmdBindIndexBuffer(cmd, key.indexBuffer, key.ibOffset, VK_INDEX_TYPE_UINT32);
+
+        // Meshes with meshlets: all instances in one indirect draw over the indices the cull pass
+        // kept for them. It culled exactly the visible instances of this mesh, so a count that
+        // doesn't match (not culled this frame) falls back to the full mesh.
+        if (batch.front() && batch.front()->rawMesh()->hasMeshlets()) {
+            const MeshletCuller::DrawArgs* args = m_meshletCuller.getDrawArgs(batch.front()->rawMesh());
+            if (args && args->instanceCount == instances.size()) {
+                vkCmdBindIndexBuffer(cmd, args->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+                vkCmdDrawIndexedIndirect(cmd, args->indirectBuffer, 0, 1, sizeof(VkDrawIndexedIndirectCommand));
+                return;
+            }
+        }
+
+        vkCmdBindIndexBuffer(cmd, key.indexBuffer, key.ibOffset, key.indexType);
         vkCmdDrawIndexed(cmd, key.indexCount,
             static_cast<uint32_t>(instances.size()),
             /*firstIndex*/0, /*vertexOffset*/0, /*firstInstance*/0);
@@ -141,12 +186,34 @@ static std::string keyStr(const MeshKey& k) {
     ss << "{VB=" << ptrStr((void*)k.vertexBuffer)
         << ", IB=" << ptrStr((void*)k.indexBuffer)
         << ", idx=" << k.indexCount
+        << (k.indexType == VK_INDEX_TYPE_UINT16 ? "(u16)" : "(u32)")
         << ", pipe=" << k.pipelineIndex
         << ", group=" << k.logicalId
         << "}";
     return ss.str();
 }
 
+void MeshScene::requestTextureLevels(float fullResDistance)
+{
+    auto& textures = TextureManager::GetInstance();
+    auto request = [&](BaseObject* o, float distance) {
+        if (!o) return;
+        const auto& mat = o->getMaterial();
+        if (!mat) return;
+        uint32_t level = 0;
+        if (fullResDistance > 0.0f && distance > fullResDistance)
+            level = static_cast<uint32_t>(std::log2(distance / fullResDistance));
+        mat->forEachTexture([&](const std::shared_ptr<Texture>& texture) { textures.requestLevel(texture, level); });
+        };
+
+    if (m_chunksEnabled) {
+        m_chunks.forVisibleObjectDistances(request);
+    }
+    else {
+        for (BaseObject* o : m_BaseObjects) request(o, 0.0f);
+    }
+}
+
 void MeshScene::debugPrintVisibleBatches(std::ostream& os) {
     size_t drawCalls = 0, totalInstances = 0;
     std::unordered_map<size_t, size_t> histogram; // instances -> how many batches
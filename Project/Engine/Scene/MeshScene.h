@@ -11,9 +11,11 @@
 #include "MeshKeyUtil.h"
 #include "ChunkGrid.h"
 #include <unordered_map>
+#include <algorithm>
 #include <Engine/Graphics/InstanceData.h>
 #include <Engine/Graphics/VulkanVars.h>
 #include <Engine/Graphics/MeshManager.h>
+#include <Engine/Graphics/MeshletCuller.h>
 
 static inline void basisFromNormal(const glm::vec3& nIn,
     glm::vec3& t, glm::vec3& b, glm::vec3& n)
@@ -53,6 +55,16 @@ public:
         return static_cast<unsigned int>(m_BaseObjects.size() - 1);
     }
 
+    // Shared mesh from MeshManager (no geometry copy / hashing per object)
+    unsigned int addModel(std::shared_ptr<Mesh> mesh, glm::vec3 position, glm::vec3 scale, glm::vec3 rotationAngles, const std::shared_ptr<Material> mat = {})
+    {
+        BaseObject* object = new BaseObject{ std::move(mesh), mat };
+        object->setPosition(position, scale, rotationAngles);
+        m_BaseObjects.push_back(object);
+        m_pendingToRegister.push_back(object);
+        return static_cast<unsigned int>(m_BaseObjects.size() - 1);
+    }
+
     void setObjectGlobal(BaseObject* obj, bool enable) { m_chunks.setGlobal(obj, enable); }
     void setObjectMultiChunk(BaseObject* obj, glm::vec3 halfExtents) { m_chunks.setMultiChunk(obj, halfExtents); }
 
@@ -81,7 +93,13 @@ public:
         glm::vec3 position, glm::vec3 scale, glm::vec3 rotationAngles,
         const std::shared_ptr<Material> mat = {})
     {
-        auto quad = MeshManager::GetInstance().GetUnitQuad();
+        // Planes as large as the ground are tessellated, so their meshlets can be culled
+        // (ObjUtils::kMeshletMinTriangles); a plain quad is always drawn whole
+        constexpr float kGridPlaneMinSize = 64.f;
+        constexpr uint32_t kGridPlaneCells = 64;   // 8192 triangles
+        const bool large = std::max(width * std::abs(scale.x), height * std::abs(scale.y)) >= kGridPlaneMinSize;
+        auto quad = large ? MeshManager::GetInstance().GetUnitGrid(kGridPlaneCells)
+                          : MeshManager::GetInstance().GetUnitQuad();
         auto* object = new BaseObject{ quad, mat };
 
         // align +Z to 'normal'
@@ -133,6 +151,18 @@ public:
         m_chunks.update(obj, MakeMeshKey(obj, 0));
     }
 
+    // Uploads 'mesh' if needed and re-batches 'obj' with it (main thread, outside recording)
+    void replaceMesh(BaseObject* obj, std::shared_ptr<Mesh> mesh) {
+        if (!obj || !mesh) return;
+        auto& vk = vulkanVars::GetInstance();
+        mesh->initialize(vk.physicalDevice, vk.device, vk.commandPoolModelPipeline.m_CommandPool, vk.graphicsQueue);
+        obj->setMesh(std::move(mesh));
+        // Still waiting for its first flush? Then flushPendingRuntime registers it with the new key
+        if (std::find(m_pendingToRegister.begin(), m_pendingToRegister.end(), obj) != m_pendingToRegister.end()) return;
+        m_chunks.update(obj, MakeMeshKey(obj, 0));
+        m_instancesDirty = true;
+    }
+
     void notifyMoved(BaseObject* obj) {
         if (!obj) return;
         m_chunks.update(obj, MakeMeshKey(obj, 0));
@@ -145,6 +175,7 @@ public:
     }
 
     void deleteScene(VkDevice device) override {
+        m_meshletCuller.destroy(device);
         for (auto& object : m_BaseObjects) {
             m_chunks.remove(object);
             object->destroy(device);
@@ -153,9 +184,18 @@ public:
         m_BaseObjects.clear();
     }
 	void rebuildAllInstanceBuffersFromCurrentTransforms();
-    void drawScene(VkPipelineLayout& pipelineLayout, VkCommandBuffer& cmd);
+    void drawScene(VkPipelineLayout& pipelineLayout, const VkPushConstantRange& pushRange, VkCommandBuffer& cmd);
+    // PBR pass: each batch binds the shader variant its materials need (Material::getPbrFeatures)
+    void setVariantPipeline(Pipeline* pipeline) override { m_variantPipeline = pipeline; }
     void debugPrintVisibleBatches(std::ostream& os);
 
+    // GPU meshlet culling for the visible large meshes; record before the render pass that draws the scene
+    void recordMeshletCulling(VkCommandBuffer cmd, const glm::mat4& viewProj, const glm::vec3& cameraPos);
+
+    // Texture streaming: asks TextureManager for the mip level each visible material needs, one
+    // level coarser per doubling of the chunk distance beyond 'fullResDistance'
+    void requestTextureLevels(float fullResDistance);
+
     void setChunksEnabled(bool enabled) { m_chunksEnabled = enabled; }
     bool chunksEnabled() const { return m_chunksEnabled; }
 
@@ -166,6 +206,8 @@ private:
     DataBuffer* getOrGrowInstanceBuffer(const MeshKey& key, size_t neededCount);
     
     ChunkGrid m_chunks;
+    MeshletCuller m_meshletCuller;
+    Pipeline* m_variantPipeline = nullptr;
     bool m_chunksEnabled = true;
     bool m_instancesDirty = false;
 };
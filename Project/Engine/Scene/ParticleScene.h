@@ -25,9 +25,9 @@ public:
         m_ParticleGroups.push_back(object);
     }
 
-    void drawScene(VkPipelineLayout& pipelineLayout, VkCommandBuffer& buffer) {
+    void drawScene(VkPipelineLayout& pipelineLayout, const VkPushConstantRange& pushRange, VkCommandBuffer& buffer) {
         for (auto& object : m_ParticleGroups) {
-            object->draw(pipelineLayout, buffer);
+            object->draw(pipelineLayout, pushRange, buffer);
         }
     }
 
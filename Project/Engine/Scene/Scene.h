@@ -1,10 +1,14 @@
 #pragma once
 #include <Engine/Graphics/ShaderBase.h>
+class Pipeline;
 class Scene {
 public:
 
-    virtual void drawScene(VkPipelineLayout& pipelineLayout, VkCommandBuffer& buffer) = 0;
+    // pushRange: the pipeline's push constant range (size 0 for none), fixed for the whole pass
+    virtual void drawScene(VkPipelineLayout& pipelineLayout, const VkPushConstantRange& pushRange, VkCommandBuffer& buffer) = 0;
     virtual  void deleteScene(VkDevice device) = 0;
+    // Set around drawScene when the pipeline has shader variants (Pipeline::bindVariant)
+    virtual void setVariantPipeline(Pipeline* pipeline) {}
     
 };
 
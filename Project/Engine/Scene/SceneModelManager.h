@@ -45,6 +45,15 @@ public:
         return obj;
     }
 
+    BaseObject* addMeshModel(std::shared_ptr<Mesh> mesh,
+        glm::vec3 position, glm::vec3 scale, glm::vec3 rotationAngles, const std::shared_ptr<Material> mat = {})
+    {
+        unsigned int index = m_meshScene->addModel(std::move(mesh), position, scale, rotationAngles, mat);
+        BaseObject* obj = m_meshScene->getBaseObject(index);
+        m_sceneObjects.push_back({ SceneModelType::Mesh, obj });
+        return obj;
+    }
+
     BaseObject* addMeshRectangle(const glm::vec3& normal,
         const glm::vec3& color,
         float width, float height,
@@ -103,6 +112,12 @@ public:
         if (m_meshScene) m_meshScene->notifyMoved(obj);
     }
 
+    void updateObjectTransform(BaseObject* obj, const glm::mat4& model) {
+        if (!obj) return;
+        obj->setModelMatrix(model);
+        if (m_meshScene) m_meshScene->notifyMoved(obj);
+    }
+
     void destroy(VkDevice device) {
         m_meshScene->deleteScene(device);
         m_particleScene->deleteScene(device);
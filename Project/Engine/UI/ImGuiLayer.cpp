@@ -1,6 +1,7 @@
 #include "ImGuiLayer.h"
 
 #include <array>
+#include <cmath>
 #include <stdexcept>
 
 #include <imgui.h>
@@ -9,6 +10,11 @@
 #include "Engine/Core/Settings.h"
 #include <Engine/Scene/GameSceneManager.h>
 #include <Engine/Scene/SceneModelManager.h>
+#include <Engine/Graphics/MeshManager.h>
+#include <Engine/Graphics/TextureManager.h>
+#include <Engine/Graphics/SamplerCache.h>
+#include <Engine/ObjUtils/ObjUtils.h>
+#include <Engine/Core/AssetLoader.h>
 
 ImGuiLayer::~ImGuiLayer() {
     Shutdown();
@@ -153,6 +159,7 @@ void ImGuiLayer::DrawSettingsWindow(bool* pOpen)
         bool chunkDebug = S.Get<bool>("renderer.chunkDebug", true);
         float renderDistance = S.Get<float>("renderer.renderDistance", 200.f);
         float chunkRange = S.Get<float>("renderer.chunkRange", 100.f);
+        bool meshletCulling = S.Get<bool>("renderer.meshletCulling", true);
 
         if (ImGui::Checkbox("Show Normals Pass", &showNormals))
             S.Set("renderer.showNormals", showNormals);
@@ -165,6 +172,25 @@ void ImGuiLayer::DrawSettingsWindow(bool* pOpen)
 
         if (ImGui::SliderFloat("Chunk Range", &chunkRange, 10.f, 1000.f))
             S.Set("renderer.chunkRange", chunkRange);
+
+        if (ImGui::Checkbox("Meshlet Culling (GPU)", &meshletCulling))
+            S.Set("renderer.meshletCulling", meshletCulling);
+
+        // Mipmaps are an upload-time option (only textures loaded after the change use them);
+        // anisotropy switches the shared sampler, so it applies to everything right away
+        bool textureMips = S.Get<bool>("renderer.textureMips", true);
+        if (ImGui::Checkbox("Texture Mipmaps", &textureMips)) {
+            S.Set("renderer.textureMips", textureMips);
+            Texture::SetMipmapGeneration(textureMips);
+        }
+
+        static const char* kAnisotropyNames[] = { "Off", "2x", "4x", "8x", "16x" };
+        int anisotropyIndex = static_cast<int>(std::log2(Texture::QuantizeAnisotropy(S.Get<float>("renderer.anisotropy", 16.f))));
+        if (ImGui::Combo("Anisotropy", &anisotropyIndex, kAnisotropyNames, IM_ARRAYSIZE(kAnisotropyNames))) {
+            const float anisotropy = static_cast<float>(1 << anisotropyIndex);
+            S.Set("renderer.anisotropy", anisotropy);
+            Texture::SetMaxAnisotropy(anisotropy);
+        }
     }
 
     // --- Camera group ---------------------------------------------------------
@@ -179,6 +205,41 @@ void ImGuiLayer::DrawSettingsWindow(bool* pOpen)
         if (ImGui::DragFloat("Far", &farP, 1.f, 10.f, 10000.f)) S.Set("camera.far", farP);
     }
 
+    // --- Memory ---------------------------------------------------------------
+    if (ImGui::CollapsingHeader("Memory")) {
+        const MeshManager::MemoryStats ms = MeshManager::GetInstance().GetMemoryStats();
+        const auto mib = [](size_t b) { return double(b) / (1024.0 * 1024.0); };
+        ImGui::Text("Meshes: %zu (%zu with CPU copy)", ms.meshCount, ms.cpuResidentMeshes);
+        ImGui::Text("Mesh CPU:    %.2f MiB", mib(ms.meshCpuBytes));
+        ImGui::Text("Mesh GPU:    %.2f MiB", mib(ms.meshGpuBytes));
+        ImGui::Text("OBJ cache:   %.2f MiB", mib(ms.parseCacheBytes));
+        ImGui::Text("Texture GPU: %.2f MiB", mib(TextureManager::GetInstance().getGpuBytes()));
+        ImGui::Text("  streamed:  %.2f / %.0f MiB", mib(TextureManager::GetInstance().getStreamedBytes()),
+            mib(TextureManager::GetInstance().getStreamingBudget()));
+        ImGui::Text("  budget:    %.0f MiB (%zu evicted)", mib(TextureManager::GetInstance().getResidencyBudget()),
+            TextureManager::GetInstance().getEvictedCount());
+        ImGui::Text("Samplers:    %zu", SamplerCache::GetInstance().getSamplerCount());
+
+        bool objParseCache = S.Get<bool>("memory.objParseCache", false);
+        if (ImGui::Checkbox("Keep OBJ Parse Cache", &objParseCache)) {
+            S.Set("memory.objParseCache", objParseCache);
+            ObjUtils::SetParseCacheEnabled(objParseCache);
+        }
+    }
+
+    // --- Assets ---------------------------------------------------------------
+    if (ImGui::CollapsingHeader("Assets")) {
+        ImGui::Text("Pending loads: %zu", AssetLoader::GetInstance().pendingCount());
+
+        bool asyncLoading = S.Get<bool>("assets.asyncLoading", true);
+        if (ImGui::Checkbox("Async Spawning", &asyncLoading))
+            S.Set("assets.asyncLoading", asyncLoading);
+
+        float loadBudget = S.Get<float>("assets.loadBudgetMs", 2.f);
+        if (ImGui::SliderFloat("Load Budget (ms/frame)", &loadBudget, 0.25f, 16.f))
+            S.Set("assets.loadBudgetMs", loadBudget);
+    }
+
     // --- General --------------------------------------------------------------
     if (ImGui::CollapsingHeader("General")) {
         bool capFps = S.Get<bool>("general.capFps", false);
@@ -278,14 +339,14 @@ void ImGuiLayer::DrawMainWindow_() {
 
 // ------------- Spawner -----------------
 
-static const char* kTypeNames[] = { "Cube", "Cat Mesh" };
+static const char* kTypeNames[] = { "Cube", "Cat Mesh", "glTF Model" };
 
 void ImGuiLayer::DrawSpawnerWindow_(bool* pOpen) {
     using ST = SpawnType;
     if (!ImGui::Begin("Spawner", pOpen)) { ImGui::End(); return; }
 
     // --- Type -------------------------------------------------------
-    static const char* kTypeNames[] = { "Cube", "Cat Mesh" };
+    static const char* kTypeNames[] = { "Cube", "Cat Mesh", "glTF Model" };
     ImGui::TextUnformatted("Object Type");
     ImGui::Combo("##type", &m_SpawnTypeIndex, kTypeNames, IM_ARRAYSIZE(kTypeNames));
 
@@ -324,6 +385,11 @@ void ImGuiLayer::DrawSpawnerWindow_(bool* pOpen) {
         ImGui::DragFloat3("Cube Size (W,H,D)", m_Size, 0.05f, 0.01f, 1000.f);
     }
 
+    // --- File (glTF only, brings its own materials) ----------------
+    if (m_SpawnTypeIndex == (int)ST::GltfModel) {
+        ImGui::InputText(".glb file", m_GltfPath, sizeof(m_GltfPath));
+    }
+
     // --- Randomize (pos/rot/scale/size) -----------------------------
     if (ImGui::Button("Randomize")) {
         std::uniform_real_distribution<float> pos(-10.f, 10.f);       // X/Y/Z in [-10, 10]
@@ -366,8 +432,19 @@ void ImGuiLayer::DrawSpawnerWindow_(bool* pOpen) {
                 si.type = ST::Cube;
                 m_Spawned.push_back(si);
             }
+            else if (m_SpawnTypeIndex == (int)ST::GltfModel) {
+                go->addComponent<GltfModelComponent>(go, m_GltfPath);
+
+                SpawnedItem si{};
+                si.object = go;
+                si.id = ++m_SpawnCounter;
+                si.type = ST::GltfModel;
+                m_Spawned.push_back(si);
+            }
             else {
-                auto* comp = go->addComponent<ModelMeshComponent>(go, "Resources/Models/cat.obj", chosenMat, false);
+                // Async: a placeholder cube shows up now, the cat replaces it once loaded
+                const bool async = Settings::GetInstance().Get<bool>("assets.asyncLoading", true);
+                auto* comp = go->addComponent<ModelMeshComponent>(go, "Resources/Models/cat.obj", chosenMat, false, true, false, async);
 
                 SpawnedItem si{};
                 si.object = go;
@@ -394,7 +471,7 @@ void ImGuiLayer::DrawSpawnerWindow_(bool* pOpen) {
             const auto& it = m_Spawned[i];
             char label[64];
             snprintf(label, sizeof(label), "%s %d",
-                (it.type == ST::Cube ? "Cube" : "Cat"), it.id);
+                (it.type == ST::Cube ? "Cube" : it.type == ST::GltfModel ? "glTF" : "Cat"), it.id);
             if (ImGui::Selectable(label, m_SelectedSpawned == i))
                 m_SelectedSpawned = i;
         }
@@ -47,7 +47,7 @@ public:
     void Shutdown();
 
 private:
-    enum class SpawnType { Cube = 0, CatMesh = 1 };
+    enum class SpawnType { Cube = 0, CatMesh = 1, GltfModel = 2 };
 
     struct SpawnedItem {
         GameObject* object = nullptr;
@@ -68,7 +68,8 @@ private:
     // Random engine for "Randomize" button
     std::mt19937 m_Rng{ std::random_device{}() };
 
-    int   m_SpawnTypeIndex = 0; // 0: Cube, 1: Cat Mesh
+    int   m_SpawnTypeIndex = 0; // 0: Cube, 1: Cat Mesh, 2: glTF Model
+    char  m_GltfPath[256] = "Resources/Models/model.glb";
     int   m_SelectedMaterialIndex = 0;
 
     float m_Pos[3] = { 0.f, 0.f, 0.f };
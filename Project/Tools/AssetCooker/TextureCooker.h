@@ -0,0 +1,169 @@
+// TextureCooker.h
+#pragma once
+
+#include <Engine/ObjUtils/CookedAssets.h>
+#include <bc7enc.h>
+#include <stb_dxt.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Offline texture processing: full mip chain filtered the way each TextureRole is sampled, then
+// block compression: BC7 (bc7enc) for color, BC5 (normal XY) and BC4 (one data channel) through stb_dxt.
+namespace Cooker {
+
+    namespace detail {
+        inline const std::array<float, 256>& SrgbToLinearTable() {
+            static const std::array<float, 256> table = [] {
+                std::array<float, 256> t{};
+                for (int i = 0; i < 256; ++i) {
+                    const float c = i / 255.f;
+                    t[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                }
+                return t;
+            }();
+            return table;
+        }
+
+        inline uint8_t LinearToSrgb(float v) {
+            v = std::clamp(v, 0.f, 1.f);
+            const float c = v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.f / 2.4f) - 0.055f;
+            return static_cast<uint8_t>(std::lround(c * 255.f));
+        }
+
+        inline uint8_t ToUnorm8(float v) {
+            return static_cast<uint8_t>(std::lround(std::clamp(v, 0.f, 1.f) * 255.f));
+        }
+
+        // Next level of an RGBA8 image; odd edges reuse the last texel.
+        //   Color:  box filter in linear space (the runtime samples color as sRGB)
+        //   Normal: average of the decoded vectors, renormalized
+        //   Data:   plain box filter
+        inline std::vector<uint8_t> Downsample(const std::vector<uint8_t>& src, uint32_t w, uint32_t h, ObjUtils::TextureRole role) {
+            const auto& toLinear = SrgbToLinearTable();
+            const uint32_t dw = std::max(w / 2, 1u), dh = std::max(h / 2, 1u);
+            std::vector<uint8_t> dst(size_t(dw) * dh * 4);
+            for (uint32_t y = 0; y < dh; ++y) {
+                const uint32_t y0 = std::min(y * 2, h - 1), y1 = std::min(y * 2 + 1, h - 1);
+                for (uint32_t x = 0; x < dw; ++x) {
+                    const uint32_t x0 = std::min(x * 2, w - 1), x1 = std::min(x * 2 + 1, w - 1);
+                    const uint8_t* p[4] = {
+                        &src[(size_t(y0) * w + x0) * 4], &src[(size_t(y0) * w + x1) * 4],
+                        &src[(size_t(y1) * w + x0) * 4], &src[(size_t(y1) * w + x1) * 4] };
+                    uint8_t* out = &dst[(size_t(y) * dw + x) * 4];
+
+                    if (role == ObjUtils::TextureRole::Color) {
+                        for (int c = 0; c < 3; ++c)
+                            out[c] = LinearToSrgb(0.25f * (toLinear[p[0][c]] + toLinear[p[1][c]] + toLinear[p[2][c]] + toLinear[p[3][c]]));
+                    }
+                    else if (role == ObjUtils::TextureRole::Normal) {
+                        float n[3] = {};
+                        for (int i = 0; i < 4; ++i)
+                            for (int c = 0; c < 3; ++c) n[c] += p[i][c] / 127.5f - 1.f;
+                        const float len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                        if (len > 1e-6f) for (float& v : n) v /= len;
+                        else { n[0] = 0.f; n[1] = 0.f; n[2] = 1.f; }
+                        for (int c = 0; c < 3; ++c) out[c] = ToUnorm8(n[c] * 0.5f + 0.5f);
+                    }
+                    else {
+                        for (int c = 0; c < 3; ++c)
+                            out[c] = static_cast<uint8_t>((p[0][c] + p[1][c] + p[2][c] + p[3][c] + 2) / 4);
+                    }
+                    out[3] = static_cast<uint8_t>((p[0][3] + p[1][3] + p[2][3] + p[3][3] + 2) / 4);
+                }
+            }
+            return dst;
+        }
+
+        inline const bc7enc_compress_block_params& Bc7Params() {
+            static const bc7enc_compress_block_params params = [] {
+                bc7enc_compress_block_init();
+                bc7enc_compress_block_params p;
+                bc7enc_compress_block_params_init(&p);
+                return p;
+            }();
+            return params;
+        }
+
+        // One 4x4 block of RGBA texels (64 bytes) -> 'format'
+        inline void CompressBlock(ObjUtils::Ktx2Format format, const uint8_t* rgba, uint8_t* out) {
+            switch (format) {
+            case ObjUtils::Ktx2Format::BC7_SRGB:
+                bc7enc_compress_block(out, rgba, &Bc7Params());
+                break;
+            case ObjUtils::Ktx2Format::BC5_UNORM: {
+                uint8_t rg[32];
+                for (int i = 0; i < 16; ++i) { rg[i * 2] = rgba[i * 4]; rg[i * 2 + 1] = rgba[i * 4 + 1]; }
+                stb_compress_bc5_block(out, rg);
+                break;
+            }
+            case ObjUtils::Ktx2Format::BC4_UNORM: {
+                uint8_t r[16];
+                for (int i = 0; i < 16; ++i) r[i] = rgba[i * 4];
+                stb_compress_bc4_block(out, r);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+
+        // 4x4 blocks, edge blocks padded by clamping
+        inline void CompressLevel(const std::vector<uint8_t>& rgba, uint32_t w, uint32_t h, ObjUtils::Ktx2Format format, std::vector<uint8_t>& out) {
+            const size_t blockBytes = ObjUtils::Ktx2BlockBytes(format);
+            uint8_t block[64];
+            for (uint32_t by = 0; by < h; by += 4) {
+                for (uint32_t bx = 0; bx < w; bx += 4) {
+                    for (uint32_t y = 0; y < 4; ++y)
+                        for (uint32_t x = 0; x < 4; ++x) {
+                            const uint32_t sx = std::min(bx + x, w - 1), sy = std::min(by + y, h - 1);
+                            std::copy_n(&rgba[(size_t(sy) * w + sx) * 4], 4, &block[(y * 4 + x) * 4]);
+                        }
+                    const size_t at = out.size();
+                    out.resize(at + blockBytes);
+                    CompressBlock(format, block, &out[at]);
+                }
+            }
+        }
+    }
+
+    struct CookedImage {
+        uint32_t width = 0, height = 0, mipLevels = 0;
+        ObjUtils::Ktx2Format format = ObjUtils::Ktx2Format::RGBA8_SRGB;
+        std::vector<uint8_t> data;   // all levels back to back, largest first
+    };
+
+    // Format per role: Color -> BC7 sRGB, Normal -> BC5, Data -> BC4. compress = false keeps RGBA8
+    // (sRGB for color, UNORM otherwise), still mip-mapped.
+    inline ObjUtils::Ktx2Format CookedFormat(ObjUtils::TextureRole role, bool compress) {
+        switch (role) {
+        case ObjUtils::TextureRole::Normal: return compress ? ObjUtils::Ktx2Format::BC5_UNORM : ObjUtils::Ktx2Format::RGBA8_UNORM;
+        case ObjUtils::TextureRole::Data: return compress ? ObjUtils::Ktx2Format::BC4_UNORM : ObjUtils::Ktx2Format::RGBA8_UNORM;
+        default: return compress ? ObjUtils::Ktx2Format::BC7_SRGB : ObjUtils::Ktx2Format::RGBA8_SRGB;
+        }
+    }
+
+    // 'rgba' is the decoded source (4 bytes per texel)
+    inline CookedImage CookTexture(const uint8_t* rgba, uint32_t width, uint32_t height, ObjUtils::TextureRole role, bool compress) {
+        CookedImage img;
+        img.width = width;
+        img.height = height;
+        img.format = CookedFormat(role, compress);
+
+        std::vector<uint8_t> level(rgba, rgba + size_t(width) * height * 4);
+        uint32_t w = width, h = height;
+        for (;;) {
+            if (compress) detail::CompressLevel(level, w, h, img.format, img.data);
+            else img.data.insert(img.data.end(), level.begin(), level.end());
+            ++img.mipLevels;
+            if (w == 1 && h == 1) break;
+            level = detail::Downsample(level, w, h, role);
+            w = std::max(w / 2, 1u);
+            h = std::max(h / 2, 1u);
+        }
+        return img;
+    }
+
+} // namespace Cooker
@@ -0,0 +1,339 @@
+// AssetCooker: converts Resources/ into the runtime packages described in ObjUtils/CookedAssets.h.
+//
+//   AssetCooker <sourceDir> <outDir> [--jobs N] [--force] [--no-quantize] [--no-compress]
+//   AssetCooker --pack <archive> <dir>... [--lz4]
+//
+// Run it from the folder the engine runs from so the source paths match the runtime ones
+// ("Resources/Models/cat.obj" -> "<outDir>/Resources/Models/cat.obj.vmesh"). Textures become
+// KTX2 in the format their role asks for (ObjUtils::TextureRole): BC7 albedo, BC5 normal maps,
+// BC4 roughness/metalness/height; --no-compress keeps RGBA8. Roles come from
+// <sourceDir>/texture_roles.json ({ "<source path>": "normal" | "data" | "color" }); unlisted
+// textures cook as color, and the engine skips packages whose role isn't the one it asks for. Incremental:
+// <outDir>/cook_manifest.json records the content hash of every source and the options it was
+// cooked with, and only changed entries are cooked again. Output depends on file contents only,
+// so two cooks of the same tree are byte-identical. Sources that fail to import are skipped with
+// a warning (and retried next run); the exit code is nonzero only for bad arguments or IO errors.
+//
+// --pack writes every file under the given folders into one AssetArchive (.vpak), named by
+// their path as given ("Cooked/Resources/..."), so run it from the engine's working folder too.
+
+#include <Engine/ObjUtils/ObjUtils.h>
+#include <Engine/ObjUtils/CookedAssets.h>
+#include <Engine/Core/MappedFile.h>
+#include <Engine/Core/Hash.h>
+#include <Engine/Core/ThreadPool.h>
+#include <Engine/Core/AssetArchive.h>
+#include "TextureCooker.h"
+#include <nlohmann/json.hpp>
+#include <stb_image.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    // Bump to force a full re-cook when the cooker changes in a way the format versions don't cover
+    constexpr uint32_t kCookerVersion = 1;
+    const char* kManifestName = "cook_manifest.json";
+    const char* kRolesName = "texture_roles.json";
+
+    // Import flags the engine uses for models (see ModelMeshComponent)
+    constexpr bool kFlipV = false, kFlipWinding = false, kDropDegenerate = true, kOptimize = true;
+
+    enum class AssetKind { Mesh, Texture };
+
+    struct Options {
+        std::string sourceDir;
+        std::string outDir;
+        unsigned jobs = 0;
+        bool force = false;
+        bool quantize = true;
+        bool compress = true;
+    };
+
+    struct Job {
+        std::string source;      // path as the runtime opens it (generic separators)
+        std::string output;
+        AssetKind kind;
+        ObjUtils::TextureRole role = ObjUtils::TextureRole::Color;
+    };
+
+    std::string Hex(uint64_t v) {
+        char buf[17];
+        std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(v));
+        return buf;
+    }
+
+    // Digits only, up to 256 workers (0 = one per core); anything else is a usage error
+    bool ParseJobs(const char* s, unsigned& out) {
+        if (!s || !*s) return false;
+        for (const char* c = s; *c; ++c)
+            if (*c < '0' || *c > '9') return false;
+        const unsigned long v = std::strtoul(s, nullptr, 10);
+        if (v > 256) return false;
+        out = static_cast<unsigned>(v);
+        return true;
+    }
+
+    bool ParseArgs(int argc, char** argv, Options& o) {
+        std::vector<std::string> positional;
+        for (int i = 1; i < argc; ++i) {
+            const std::string a = argv[i];
+            if (a == "--force") o.force = true;
+            else if (a == "--no-quantize") o.quantize = false;
+            else if (a == "--no-compress") o.compress = false;
+            else if (a == "--jobs" && i + 1 < argc) { if (!ParseJobs(argv[++i], o.jobs)) return false; }
+            else if (!a.empty() && a[0] == '-') return false;
+            else positional.push_back(a);
+        }
+        if (positional.size() != 2) return false;
+        o.sourceDir = positional[0];
+        o.outDir = positional[1];
+        return true;
+    }
+
+    // Missing file: everything is color. Unreadable file or unknown role names only warn.
+    std::map<std::string, ObjUtils::TextureRole> LoadTextureRoles(const Options& o) {
+        std::map<std::string, ObjUtils::TextureRole> roles;
+        std::ifstream in{ fs::path(o.sourceDir) / kRolesName };
+        if (!in) return roles;
+        try {
+            const nlohmann::json json = nlohmann::json::parse(in);
+            for (auto it = json.begin(); it != json.end(); ++it) {
+                ObjUtils::TextureRole role;
+                if (it->is_string() && ObjUtils::TextureRoleFromName(it->get<std::string>(), role)) roles[it.key()] = role;
+                else std::cerr << "[AssetCooker] " << kRolesName << ": unknown role for \"" << it.key() << "\"\n";
+            }
+        }
+        catch (const std::exception& e) { std::cerr << "[AssetCooker] ignoring unreadable " << kRolesName << ": " << e.what() << "\n"; }
+        return roles;
+    }
+
+    std::vector<Job> CollectJobs(const Options& o) {
+        const std::map<std::string, ObjUtils::TextureRole> roles = LoadTextureRoles(o);
+        std::vector<Job> jobs;
+        std::error_code ec;
+        for (fs::recursive_directory_iterator it(o.sourceDir, ec), end; !ec && it != end; it.increment(ec)) {
+            if (!it->is_regular_file()) continue;
+            std::string ext = it->path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+
+            AssetKind kind;
+            if (ext == ".obj") kind = AssetKind::Mesh;
+            else if (ext == ".png" || ext == ".jpg" || ext == ".jpeg") kind = AssetKind::Texture;
+            else continue;
+
+            const std::string source = it->path().generic_string();
+            const std::string output = ObjUtils::detail::CookedPath(o.outDir, source, kind == AssetKind::Mesh ? ".vmesh" : ".ktx2");
+            if (output.empty()) continue; // absolute source dir; nothing the runtime could look up
+            Job job{ source, output, kind };
+            if (auto role = roles.find(source); role != roles.end() && kind == AssetKind::Texture) job.role = role->second;
+            jobs.push_back(job);
+        }
+        // Directory iteration order is unspecified; keep logs and the manifest stable
+        std::sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) { return a.source < b.source; });
+        return jobs;
+    }
+
+    uint64_t OptionsHash(const Options& o, const Job& job) {
+        uint64_t h = Hash::Combine(kCookerVersion, job.kind == AssetKind::Mesh ? ObjUtils::kCookedMeshVersion : ObjUtils::kCookedTextureVersion);
+        if (job.kind == AssetKind::Mesh) {
+            h = Hash::Combine(h, ObjUtils::ImportFlags(kFlipV, kFlipWinding, kDropDegenerate, kOptimize));
+            h = Hash::Combine(h, o.quantize ? 1 : 0);
+        }
+        else {
+            h = Hash::Combine(h, o.compress ? 1 : 0);
+            h = Hash::Combine(h, static_cast<uint32_t>(job.role));
+        }
+        return h;
+    }
+
+    // A source that doesn't import is the asset's problem: warn, and the engine keeps loading it raw.
+    // Only a package that can't be written is an error of the cook itself.
+    enum class CookResult { Cooked, BadSource, WriteFailed };
+
+    CookResult CookMesh(const Job& job, const Options& o, uint64_t sourceHash, uint64_t sourceSize) {
+        const uint64_t key = ObjUtils::MakeAssetId(job.source.c_str(), kFlipV, kFlipWinding, kDropDegenerate, kOptimize);
+        std::shared_ptr<MeshBlob> blob =
+            ObjUtils::detail::ImportOBJ(job.source.c_str(), key, kFlipV, kFlipWinding, false, kDropDegenerate, kOptimize);
+        if (!blob) return CookResult::BadSource;
+        const uint64_t flags = ObjUtils::ImportFlags(kFlipV, kFlipWinding, kDropDegenerate, kOptimize);
+        return ObjUtils::WriteCookedMesh(job.output, sourceHash, sourceSize, flags, *blob, o.quantize)
+            ? CookResult::Cooked : CookResult::WriteFailed;
+    }
+
+    CookResult CookTexture(const Job& job, const Options& o, const MappedFile& source, uint64_t sourceHash) {
+        int w = 0, h = 0, channels = 0;
+        stbi_uc* pixels = stbi_load_from_memory(source.data(), static_cast<int>(source.size()), &w, &h, &channels, STBI_rgb_alpha);
+        if (!pixels) {
+            std::cerr << "  " << job.source << ": " << stbi_failure_reason() << "\n";
+            return CookResult::BadSource;
+        }
+        const Cooker::CookedImage img = Cooker::CookTexture(pixels, uint32_t(w), uint32_t(h), job.role, o.compress);
+        stbi_image_free(pixels);
+        return ObjUtils::WriteCookedTexture(job.output, sourceHash, source.size(), job.role,
+            img.format, img.width, img.height, img.mipLevels, img.data)
+            ? CookResult::Cooked : CookResult::WriteFailed;
+    }
+
+    int PackMain(int argc, char** argv) {
+        std::string archive;
+        std::vector<std::string> dirs;
+        bool lz4 = false;
+        for (int i = 2; i < argc; ++i) {
+            const std::string a = argv[i];
+            if (a == "--lz4") lz4 = true;
+            else if (archive.empty()) archive = a;
+            else dirs.push_back(a);
+        }
+        if (archive.empty() || dirs.empty()) {
+            std::cerr << "usage: AssetCooker --pack <archive> <dir>... [--lz4]\n";
+            return 2;
+        }
+
+        std::error_code ec;
+        const fs::path archivePath = fs::absolute(archive, ec);
+        std::vector<std::pair<std::string, std::string>> files;
+        for (const std::string& dir : dirs) {
+            if (!fs::is_directory(dir)) {
+                std::cerr << "[AssetCooker] folder \"" << dir << "\" not found\n";
+                return 1;
+            }
+            for (fs::recursive_directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+                if (!it->is_regular_file()) continue;
+                const fs::path& p = it->path();
+                if (p.filename() == kManifestName || p.extension() == ".tmp") continue;
+                std::error_code same;
+                if (fs::equivalent(p, archivePath, same)) continue;
+                files.emplace_back(p.generic_string(), p.string());
+            }
+        }
+
+        if (!AssetArchive::Build(archive, files, lz4)) return 1;
+        std::cout << "[AssetCooker] packed " << files.size() << " files into \"" << archive << "\"\n";
+        return 0;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && std::string(argv[1]) == "--pack")
+        return PackMain(argc, argv);
+
+    Options options;
+    if (!ParseArgs(argc, argv, options)) {
+        std::cerr << "usage: AssetCooker <sourceDir> <outDir> [--jobs N] [--force] [--no-quantize] [--no-compress]\n";
+        return 2;
+    }
+    if (!fs::is_directory(options.sourceDir)) {
+        std::cerr << "[AssetCooker] source folder \"" << options.sourceDir << "\" not found\n";
+        return 1;
+    }
+
+    // The importer must see the raw sources only, never an older cook or the engine's mesh cache
+    ObjUtils::SetCookedAssetDir("");
+    ObjUtils::SetMeshCacheDir("");
+
+    const fs::path manifestPath = fs::path(options.outDir) / kManifestName;
+    nlohmann::json previous = nlohmann::json::object();
+    if (std::ifstream in{ manifestPath }) {
+        try { previous = nlohmann::json::parse(in).value("entries", nlohmann::json::object()); }
+        catch (const std::exception& e) { std::cerr << "[AssetCooker] ignoring unreadable manifest: " << e.what() << "\n"; }
+    }
+
+    const std::vector<Job> jobs = CollectJobs(options);
+    std::map<std::string, nlohmann::json> entries;   // sorted -> deterministic manifest
+    std::atomic<int> cooked{ 0 }, skipped{ 0 }, failed{ 0 };
+    std::mutex failedMtx;
+    std::set<std::string> failedSources;
+    std::vector<std::future<void>> pending;
+
+    {
+        ThreadPool pool(options.jobs);
+        for (const Job& job : jobs) {
+            auto source = std::make_shared<MappedFile>();
+            if (!source->open(job.source)) {
+                std::cerr << "[AssetCooker] cannot read \"" << job.source << "\"\n";
+                ++failed;
+                continue;
+            }
+            const uint64_t sourceHash = Hash::XXH64(source->data(), source->size());
+            const uint64_t optionsHash = OptionsHash(options, job);
+
+            nlohmann::json entry = {
+                { "source", Hex(sourceHash) },
+                { "options", Hex(optionsHash) },
+                { "output", fs::relative(job.output, options.outDir).generic_string() } };
+            if (job.kind == AssetKind::Texture) entry["role"] = ObjUtils::TextureRoleName(job.role);
+
+            auto prev = previous.find(job.source);
+            // Package renamed (e.g. format change): the old one would never be looked up again
+            if (prev != previous.end() && prev->contains("output") && (*prev)["output"] != entry["output"]) {
+                std::error_code ec;
+                fs::remove(fs::path(options.outDir) / (*prev)["output"].get<std::string>(), ec);
+            }
+            const bool upToDate = !options.force && prev != previous.end() && *prev == entry && fs::exists(job.output);
+            entries[job.source] = entry;
+            if (upToDate) continue;
+
+            pending.push_back(pool.submit([&, job, source, sourceHash] {
+                const CookResult result = job.kind == AssetKind::Mesh
+                    ? CookMesh(job, options, sourceHash, source->size())
+                    : CookTexture(job, options, *source, sourceHash);
+                if (result == CookResult::Cooked) { ++cooked; std::cout << "  cooked " << job.source << "\n"; return; }
+                if (result == CookResult::BadSource) {
+                    ++skipped;
+                    std::cerr << "[AssetCooker] warning: skipped \"" << job.source << "\", the engine will load the source\n";
+                }
+                else {
+                    ++failed;
+                    std::cerr << "[AssetCooker] failed to write the package of \"" << job.source << "\"\n";
+                }
+                std::lock_guard<std::mutex> lock(failedMtx);
+                failedSources.insert(job.source);
+                }));
+        }
+        for (auto& f : pending) f.get();
+    }
+
+    // Failed entries stay out of the manifest so the next run retries them
+    nlohmann::json manifestEntries = nlohmann::json::object();
+    for (auto& [source, entry] : entries) {
+        if (!failedSources.count(source))
+            manifestEntries[source] = entry;
+    }
+
+    // Sources that disappeared: drop their packages too
+    size_t removed = 0;
+    for (auto it = previous.begin(); it != previous.end(); ++it) {
+        if (entries.count(it.key())) continue;
+        std::error_code ec;
+        if (it->contains("output") && fs::remove(fs::path(options.outDir) / (*it)["output"].get<std::string>(), ec)) ++removed;
+    }
+
+    std::error_code ec;
+    fs::create_directories(options.outDir, ec);
+    const std::string manifest = nlohmann::json{ { "version", kCookerVersion }, { "entries", manifestEntries } }.dump(2) + "\n";
+    if (!ObjUtils::detail::WriteFileAtomic(manifestPath.string(), { { manifest.data(), manifest.size() } })) {
+        std::cerr << "[AssetCooker] failed to write the manifest\n";
+        return 1;
+    }
+
+    const size_t upToDate = jobs.size() - size_t(cooked) - size_t(skipped) - size_t(failed);
+    std::cout << "[AssetCooker] " << cooked << " cooked, " << upToDate << " up to date, "
+        << removed << " removed, " << skipped << " skipped, " << failed << " failed\n";
+    // Skipped sources don't fail the cook (it runs as part of the engine build)
+    return failed ? 1 : 0;
+}
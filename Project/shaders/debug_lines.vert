@@ -1,13 +1,10 @@
 // shaders/debug_lines.vert
 #version 450
+#extension GL_GOOGLE_include_directive : require
 layout(location=0) in vec3 inPos;
 layout(location=1) in vec4 inColor;  // from UNORM8
 
-layout(std140, set=0, binding=0) uniform UBO {
-    mat4 proj;
-    mat4 view;
-    vec4 cameraPos; // or vec3 with padding; vec4 is simplest
-} ubo;
+#include "frameConstants.glsl"
 
 layout(location=0) out vec4 vColor;
 
@@ -20,6 +17,6 @@ layout(push_constant) uniform PC {
 
 void main(){
     vec4 wpos = pc.world * vec4(inPos, 1.0);
-    gl_Position = ubo.proj * ubo.view * wpos;
+    gl_Position = frame.viewProj * wpos;
     vColor = inColor;
 }
@@ -0,0 +1,10 @@
+// Per-frame constants, set 0 of every scene pipeline (FrameUniforms on the CPU side).
+// Bound once per frame; a pipeline's own resources live in set 1.
+
+layout(std140, set = 0, binding = 0) uniform FrameConstants {
+    mat4 view;
+    mat4 proj;
+    mat4 viewProj;
+    vec4 cameraPos;   // xyz
+    float time;       // seconds since the renderer started
+} frame;
@@ -1,10 +1,7 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
-layout(std140, set = 0, binding = 0) uniform UBO {
-    mat4 proj;
-    mat4 view;
-    vec3 cameraPos;        // std140: 16-byte slot on CPU
-} ubo;
+#include "frameConstants.glsl"
 
 layout(push_constant) uniform PushConstants {
     mat4 model;
@@ -24,7 +21,7 @@ layout(location = 2) out vec3 vWorldPos;
 
 void main() {
     vec4 worldPos4 = mesh.model * vec4(inPosition, 1.0);
-    gl_Position    = ubo.proj * ubo.view * worldPos4;
+    gl_Position    = frame.viewProj * worldPos4;
 
     vWorldPos = worldPos4.xyz;
     vColor    = inColor;
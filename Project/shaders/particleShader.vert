@@ -1,9 +1,7 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
-layout(set=0,binding = 0) uniform UniformBufferObject {
-    mat4 proj;
-    mat4 view; 
-} vp;
+#include "frameConstants.glsl"
 
 layout(push_constant) uniform PushConstants {
     mat4 model; 
@@ -13,7 +11,7 @@ layout(location = 0) in vec4 inPosition; // xyz is position, w is inverted mass
 layout(location = 1) out float height; // pass the height to the fragment shader
 
 void main() {
-     gl_Position = vp.proj * vp.view *  mesh.model * vec4(inPosition.xyz, 1.0);
+     gl_Position = frame.viewProj * mesh.model * vec4(inPosition.xyz, 1.0);
      height = inPosition.y/2; // pass the y-coordinate as height
      gl_PointSize = 2.0;
 }
\ No newline at end of file
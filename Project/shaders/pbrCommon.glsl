@@ -0,0 +1,114 @@
+// PBR fragment body shared by pbrShader.frag (texture table through descriptor indexing) and
+// pbrShaderFixed.frag (fixed MAX_TEXTURES array). The including file defines BINDLESS or not.
+
+const uint NO_TEXTURE = 0xFFFFFFFFu; // Material: no texture for this map
+
+#include "frameConstants.glsl"
+
+// Every texture is read with the one shared material sampler (SamplerCache)
+layout(set = 1, binding = 2) uniform sampler texSampler;
+
+#ifdef BINDLESS
+// Sized by the pipeline layout (vulkanVars::textureSlots); IDs differ per instance -> nonuniform
+layout(set = 1, binding = 1) uniform texture2D texImages[];
+// Small textures packed into 2D arrays (Texture::CreatePacked): ID = bit 30 | array << 12 | layer
+layout(set = 1, binding = 3) uniform texture2DArray texArrays[];
+const uint PACKED_TEXTURE = 0x40000000u;
+
+vec4 sampleTex(uint id, vec2 uv) {
+    if ((id & PACKED_TEXTURE) != 0u) {
+        uint arr = (id >> 12) & 0x3FFFFu;
+        return texture(sampler2DArray(texArrays[nonuniformEXT(arr)], texSampler), vec3(uv, float(id & 0xFFFu)));
+    }
+    return texture(sampler2D(texImages[nonuniformEXT(id)], texSampler), uv);
+}
+#define HAS_TEX(id) ((id) != NO_TEXTURE)
+#define SAMPLE(id, uv) sampleTex((id), (uv))
+#else
+const uint MAX_TEXTURES = 32;
+layout(set = 1, binding = 1) uniform texture2D texImages[MAX_TEXTURES];
+#define HAS_TEX(id) ((id) < MAX_TEXTURES)
+#define SAMPLE(id, uv) texture(sampler2D(texImages[(id)], texSampler), (uv))
+#endif
+
+layout(location = 0) in vec3 vWorldNormal;
+layout(location = 1) in vec3 vColor;
+layout(location = 2) in vec2 vUV;
+layout(location = 3) flat in uvec4 vTexIds0; // {albedo, normal, metal, rough}
+layout(location = 4) flat in uint  vHeightId;
+
+layout(location = 0) out vec4 outColor;
+
+// Shader variants (Material::getPbrFeatures, bit i = constant_id i). All on is the uber shader
+// that handles every material; the specialized pipelines drop the work a batch doesn't need.
+layout(constant_id = 0) const bool USE_NORMAL_MAP  = true;
+layout(constant_id = 1) const bool USE_HEIGHT_MAP  = true;
+layout(constant_id = 2) const bool USE_METAL_ROUGH = true;
+// The V flip is per instance and already applied by pbrShader.vert
+
+// (optional) UV transforms / parallax
+const float ROTATE_DEG = 0.0;
+const int   FLIP_X     = 0;
+
+vec2 transformUV(vec2 uv) {
+    uv.x = (FLIP_X == 1) ? 1.0 - uv.x : uv.x;
+    float a = radians(ROTATE_DEG);
+    float s = sin(a), c = cos(a);
+    uv -= 0.5;
+    uv = mat2(c, -s, s, c) * uv;
+    uv += 0.5;
+    return uv;
+}
+
+vec2 parallaxUV(vec2 uv, vec3 viewDir, uint heightId, float scale) {
+    float height = SAMPLE(heightId, uv).r;
+    return uv + viewDir.xy * (height * scale);
+}
+
+void main() {
+    vec2 uv = transformUV(vUV);
+
+    // crude view dir; for accuracy pass worldPos from VS and use (cameraPos - worldPos)
+    vec3 V = normalize(frame.cameraPos.xyz);
+    const float parallaxScale = 0.04;
+    if (USE_HEIGHT_MAP && HAS_TEX(vHeightId)) {
+        uv = parallaxUV(uv, V, vHeightId, parallaxScale);
+    }
+
+    vec3 N = normalize(vWorldNormal);
+
+    vec3 albedo = HAS_TEX(vTexIds0.x)
+        ? SAMPLE(vTexIds0.x, uv).rgb
+        : vColor;
+
+    if (USE_NORMAL_MAP && HAS_TEX(vTexIds0.y)) {
+        // XY only (BC5 normal maps have no Z); rebuilding Z keeps RGBA8 maps looking the same
+        vec2 nxy = SAMPLE(vTexIds0.y, uv).rg * 2.0 - 1.0;
+        vec3 nrm = vec3(nxy, sqrt(max(1.0 - dot(nxy, nxy), 0.0)));
+        // Proper TBN would be better; this is a quick approximation:
+        N = normalize(nrm);
+    }
+
+    float metallic  = USE_METAL_ROUGH && HAS_TEX(vTexIds0.z) ? SAMPLE(vTexIds0.z, uv).r : 0.0;
+    float roughness = USE_METAL_ROUGH && HAS_TEX(vTexIds0.w) ? SAMPLE(vTexIds0.w, uv).r : 1.0;
+
+    // simple lighting
+    vec3 L = normalize(vec3(-0.3, -0.6, 0.6));
+    vec3 H = normalize(L + V);
+    vec3 F0 = mix(vec3(0.04), albedo, metallic);
+
+    float NdotL = max(dot(N, L), 0.0);
+    vec3 diffuse = (1.0 - metallic) * albedo / 3.141592 * NdotL;
+
+    float NdotH = max(dot(N, H), 0.0);
+    float HdotV = max(dot(H, V), 0.0);
+    vec3  F = F0 + (1.0 - F0) * pow(1.0 - HdotV, 5.0);
+    float spec = pow(NdotH, 1.0 / max(roughness * roughness, 0.01));
+    vec3 specular = F * spec * NdotL;
+
+    const float lightIntensity = 3.0;
+    const float AMBIENT = 0.2;
+    vec3 color = AMBIENT * albedo + lightIntensity * (diffuse + specular);
+
+    outColor = vec4(color, 1.0);
+}
@@ -0,0 +1,19 @@
+#version 450
+
+// Stand-in for the PBR shader while it compiles on a worker (PipelineConfig::fallbackFragmentShader):
+// vertex color with the same light direction and ambient, no texture reads
+layout(location = 0) in vec3 vWorldNormal;
+layout(location = 1) in vec3 vColor;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    vec3 N = normalize(vWorldNormal);
+    vec3 L = normalize(vec3(-0.3, -0.6, 0.6));
+    float NdotL = max(dot(N, L), 0.0);
+
+    const float lightIntensity = 3.0;
+    const float AMBIENT = 0.2;
+    vec3 color = AMBIENT * vColor + lightIntensity * vColor / 3.141592 * NdotL;
+    outColor = vec4(color, 1.0);
+}
@@ -1,10 +1,7 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
-layout(set = 0, binding = 0) uniform UBO {
-    mat4 proj;
-    mat4 view;
-    vec3 cameraPos;
-} ubo;
+#include "frameConstants.glsl"
 
 // Per-vertex (binding = 0, locations 0..3)
 layout(location = 0) in vec3 inPosition;
@@ -13,10 +10,11 @@ layout(location = 2) in vec3 inColor;
 layout(location = 3) in vec2 inTexCoord;
 
 // Per-instance (binding = 1)
-// Matches your InstanceData helper: mat4 rows at 4..7, uvec4 at 8, uint at 9
+// Matches your InstanceData helper: mat4 rows at 4..7, uvec4 at 8, uint at 9, flags at 10
 layout(location = 4) in mat4 inModel;
 layout(location = 8) in uvec4 inTexIds0;
 layout(location = 9) in uint  inHeightId;
+layout(location = 10) in uint inFlags;   // bit 0: flip V (InstanceData::kInstanceFlipUV)
 
 // Varyings
 layout(location = 0) out vec3 vWorldNormal;
@@ -29,13 +27,13 @@ void main() {
     mat4 M = inModel;
 
     vec4 worldPos = M * vec4(inPosition, 1.0);
-    gl_Position = ubo.proj * ubo.view * worldPos;
+    gl_Position = frame.viewProj * worldPos;
 
     mat3 normalMat = transpose(inverse(mat3(M)));
     vWorldNormal = normalize(normalMat * inNormal);
 
     vColor   = inColor;
-    vUV      = inTexCoord;
+    vUV      = (inFlags & 1u) != 0u ? vec2(inTexCoord.x, 1.0 - inTexCoord.y) : inTexCoord;
     vTexIds0 = inTexIds0;
     vHeightId = inHeightId;
 }
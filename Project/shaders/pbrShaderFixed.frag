@@ -0,0 +1,5 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// Fallback for devices without descriptor indexing: fixed MAX_TEXTURES sampler array
+#include "pbrCommon.glsl"